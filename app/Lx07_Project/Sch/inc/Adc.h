@@ -37,6 +37,7 @@ void Adc_vReadLcdTemp(void);
 void Adc_vReadPcbTemp(void);
 void Adc_vReadBatt(void);
 void Adc_vReadHw(void);
+bool Adc_boIdentifyHw(void); // 上电时序访问解串器前调用，硬件版本锁定后返回true
 #endif
 /*****************************************************************************
  * End file ADC_H
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * @file AdcScan.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef ADCSCAN_H
+#define ADCSCAN_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+// #define ADC_ONCHIP // 热敏电阻/电池/硬件版本分压直接接到MCU ADC引脚时打开，不再经I2C读取外部ADC
+
+#define ADCSCAN_VREF_MV (5000u) // 片内ADC参考电压(内部Vref_H)
+#define ADCSCAN_AVG_NUM (8u)    // 环形缓存中每个通道保留的采样次数，读取时取平均
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum
+{
+    AdcScan_LcdTemp,
+    AdcScan_PcbTemp,
+    AdcScan_Batt,
+    AdcScan_Hw,
+
+    AdcScan_Num
+} AdcScan_enCh;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+/* TDG周期触发片内ADC依次转换各通道，DMA将结果搬入环形缓存，不占用CPU和I2C总线 */
+void AdcScan_vInit(void);
+bool AdcScan_boGetMv(AdcScan_enCh enCh, uint16_t *pu16Mv); // 环形缓存中该通道的平均电压，尚无采样返回false
+#endif
+/*****************************************************************************
+ * End file ADCSCAN_H
+ *****************************************************************************/
@@ -36,7 +36,7 @@ void BackL_vHandle(void);
 void BackL_vReadLevel(void);
 void BackL_vWriteLevel(void);
 void BackL_vWriteLevFromCan(uint8_t u8Percent);
-void BackL_vDireating(uint8_t u8Temp);
+void BackL_vSetDerate(uint16_t u16Permille); // 温度降额上限，千分比，由Thermal模块周期更新
 #endif
 /*****************************************************************************
  * End file BACKL_H
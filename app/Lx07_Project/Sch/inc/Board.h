@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * @file Board.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef BOARD_H
+#define BOARD_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+#define BOARD_STRAP_NONE (0xFFFFu) // 硬件版本电阻读取失败
+
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum // 硬件版本电阻：R = (33 / V_ad) - 10 kΩ
+{
+    Board_Rev_1_0, // R = 0     3.3V
+    Board_Rev_1_1, // R = 1k    3.0V
+    Board_Rev_1_2, // R = 4.7k  2.24V
+    Board_Rev_1_3, // R = 10k   1.65V
+    Board_Rev_1_4, // R = 20k   1.1V
+
+    Board_Rev_Num
+} Board_enRev;
+
+typedef struct
+{
+    Board_enRev enRev;
+    uint8_t     u8Minor;   // 版本号 1.x.0 中的x
+    uint16_t    u16MinMv;  // 识别电压下限，取与下一版本标称电压的中点
+    uint8_t     u8DesAddr; // 该版本解串器的实际从机地址
+    uint8_t     u8BklAddr; // 该版本背光芯片的实际从机地址
+} Board_stDesc;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+/* 上电读取一次硬件版本电阻后识别并锁定，之后各模块从描述符取该版本的差异配置；
+ * 识别前返回默认版本，电压不在任何版本的范围内（包括BOARD_STRAP_NONE）时按默认版本锁定。
+ * 器件地址在识别前后不同时，识别须在访问该器件之前完成 */
+void                Board_vIdentify(uint16_t u16StrapMv); // 只在第一次调用时生效
+bool                Board_boReady(void);
+const Board_stDesc *Board_pstGet(void);
+uint8_t             Board_u8BusAddr(uint8_t u8Dev); // 寄存器表中的器件地址 -> 本版本实际从机地址
+#endif
+/*****************************************************************************
+ * End file BOARD_H
+ *****************************************************************************/
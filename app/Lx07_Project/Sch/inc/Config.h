@@ -23,16 +23,14 @@
 /*****************************************************************************
  * Global macros
  *****************************************************************************/
-#if 1
+/* 寄存器表及任务中使用的器件地址，各硬件版本的实际从机地址见Board.c */
 #define DEV_DES (0x68u)
 #define DEV_BKL (0x39u)
-#else
-#define DEV_DES (0x4Cu)
-#define DEV_BKL (0x3A)
-#endif
 
 #define DEV_TP  (0x38)
 #define DEV_SER 0x40u
+#define DEV_ADC (0x49u)
+#define DEV_EEP (0x54u)
 
 #define DEVICE_ID 0x01
 
@@ -62,6 +60,11 @@ typedef enum // 根据CAN矩阵定义
     CAN_READ_Batt = 0x06,
     CAN_READ_AdHW = 0x07,
 
+    CAN_READ_CpuLoad = 0x08, // 回复0x501: 当前负载, 峰值, 报警
+    CAN_READ_I2cErr  = 0x09, // 回复0x502: 每个器件一帧I2C错误计数
+    CAN_READ_RegChk  = 0x0A, // 回复0x503: 回读校验汇总 + 不一致寄存器
+    CAN_READ_JobStat = 0x0B, // 回复0x504: 每类产线任务一帧吞吐量及最大延迟
+
 } Config_enCanRead; // 0x730
 
 typedef enum // 根据CAN矩阵定义
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * @file I2cXfer.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef I2CXFER_H
+#define I2CXFER_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Z20K11xM_i2c.h"
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+// #define I2CXFER_I2C1_TP_ADC // 触摸和ADC直接接在PTA0/PTA1(I2C1)上时打开，与I2C0并行传输
+
+#define I2CXFER_BUS_NUM    (2u) // I2C0、I2C1各一个独立队列
+#define I2CXFER_QUEUE_SIZE (8u) // 每条总线排队中的传输描述符个数上限
+
+#define I2CXFER_RETRY_MAX   (2u)    // 中止或超时后重新提交的次数，用尽后以错误结束
+#define I2CXFER_TIMEOUT_MS  (50u)   // 总线无进展超过该时间则恢复总线
+#define I2CXFER_LOAD_WIN_MS (1000u) // 总线占用率统计窗口
+
+#define I2CXFER_CLK_KHZ (20000u) // I2C0/I2C1功能时钟：OSC40M 2分频
+
+/* DMA命令流编码，与I2C_COMMAND_DATA寄存器位定义一致 */
+#define I2CXFER_CMD_WR(Data)  ((uint16_t)((Data) & 0xFFu))
+#define I2CXFER_CMD_RD        (0x0100u)
+#define I2CXFER_CMD_STOP      (0x0200u)
+#define I2CXFER_CMD_RESTART   (0x0400u)
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum
+{
+    I2cXfer_Idle,    // 描述符空闲，可重新提交
+    I2cXfer_Queued,  // 已入队，等待总线
+    I2cXfer_Active,  // 正在总线上传输
+    I2cXfer_Done,    // 传输完成
+    I2cXfer_Error,   // 传输异常（NACK/仲裁丢失等）
+} I2cXfer_enSts;
+
+struct I2cXfer_stDesc;
+
+typedef void (*I2cXfer_pfDone)(struct I2cXfer_stDesc *pstDesc); // 完成回调，在I2C中断中执行
+
+/* 一次I2C事务：先写u8TxLen个字节，再读u8RxLen个字节，最后产生STOP
+ * pu16Cmd非NULL时为DMA模式：按命令流原样搬运到TX FIFO（可包含多段STOP），
+ * 读数据由DMA写入pu8Rx，此时忽略pu8Tx/u8TxLen，命令流中的读命令数需等于u8RxLen */
+typedef struct I2cXfer_stDesc
+{
+    uint8_t        u8DevAddr; // 7位从机地址
+    const uint8_t *pu8Tx;     // 写数据（按总线顺序），传输结束前必须保持有效
+    uint8_t        u8TxLen;
+    uint8_t       *pu8Rx; // 读数据缓存
+    uint8_t        u8RxLen;
+    I2cXfer_pfDone pfDone; // 可为NULL
+
+    const uint16_t *pu16Cmd; // DMA命令流，传输结束前必须保持有效
+    uint16_t        u16CmdLen;
+
+    volatile I2cXfer_enSts enSts;
+    volatile uint32_t      u32ErrSrc; // 中止时的I2C_ERROR_STATUS快照
+    uint8_t                u8Try;     // 已重试次数，由I2cXfer维护
+} I2cXfer_stDesc;
+
+typedef struct
+{
+    uint16_t u16Nack;    // 地址或数据无应答
+    uint16_t u16Abort;   // 仲裁丢失等其他中止
+    uint16_t u16Timeout; // 事务超时
+    uint16_t u16Fail;    // 重试用尽，以错误结束
+} I2cXfer_stErrCnt;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+void I2cXfer_vInit(void);
+bool I2cXfer_boSubmit(I2cXfer_stDesc *pstDesc);
+bool I2cXfer_boBusy(const I2cXfer_stDesc *pstDesc);
+void I2cXfer_vTick(void);         // 5ms任务中调用，检测总线超时
+void I2cXfer_vForgetTarget(void); // 器件实际地址改变后调用，下次传输重新设置目标地址
+
+/* 错误计数按器件配置表排列，最后一项为表外器件（地址0xFF），u8Idx越界返回false */
+bool     I2cXfer_boGetErrCnt(uint8_t u8Idx, uint8_t *pu8DevAddr, I2cXfer_stErrCnt *pstCnt);
+uint16_t I2cXfer_u16RecoverCnt(void);
+
+/* 以下由i2c.c的I2C0/I2C1中断回调调用 */
+void I2cXfer_vTxEmptyIsr(I2C_Id_t enBus);
+void I2cXfer_vRxFullIsr(I2C_Id_t enBus);
+void I2cXfer_vStopIsr(I2C_Id_t enBus);
+void I2cXfer_vAbortIsr(I2C_Id_t enBus);
+
+uint16_t I2cXfer_u16EncodeWrite(uint16_t *pu16Cmd, const uint8_t *pu8Data, uint8_t u8Len); // 编码一段写事务，返回命令数
+
+/* 器件速率配置及总线时间模型，模型只做整数运算、不访问寄存器，可直接在PC上编译核算 */
+I2C_Speed_t I2cXfer_enDevSpeed(uint8_t u8DevAddr);
+I2C_Id_t    I2cXfer_enDevBus(uint8_t u8DevAddr); // 表外器件走I2C0
+uint8_t     I2cXfer_u8BusLoad(I2C_Id_t enBus);   // 上一个统计窗口的总线占用率%，按时间模型累计
+uint32_t    I2cXfer_u32BitNs(I2C_Speed_t enSpeed);                   // 一个SCL周期
+uint32_t    I2cXfer_u32BusNs(I2C_Speed_t enSpeed, uint16_t u16Byte); // 一段事务：u16Byte含从机地址字节，另加START/STOP
+#endif
+/*****************************************************************************
+ * End file I2CXFER_H
+ *****************************************************************************/
@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * @file IrqLock.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef IRQLOCK_H
+#define IRQLOCK_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "Z20K11xM_drv.h"
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+/* 任务与中断共享数据的短临界区：保存PRIMASK后关中断，恢复时还原进入前的状态，中断内也可使用
+ * 主机测试在包含本文件前定义为模拟实现 */
+#ifndef IRQLOCK_SAVE
+#define IRQLOCK_SAVE(Mask)        \
+    do                            \
+    {                             \
+        (Mask) = __get_PRIMASK(); \
+        __disable_irq();          \
+    } while (0)
+#define IRQLOCK_RESTORE(Mask) __set_PRIMASK(Mask)
+#endif
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+
+#endif
+/*****************************************************************************
+ * End file IRQLOCK_H
+ *****************************************************************************/
@@ -22,36 +22,26 @@
  *****************************************************************************/
 // #define ENABLE_HDMI
 #define ENABLE_CHECKBOARD
+#define ENABLE_REG_CHECK // 显示配置完成后回读校验寄存器表，结果经CAN 0x503上报
 
 // #define ENABLE_TP
 
 #define TASK_CYCLE 5u
 
-#define DES_GPIO_HIGH(pin)                                     \
-    do                                                         \
-    {                                                          \
-        uint16_t _addr = 0x0200 + (pin) * 0x3;                 \
-        uint8_t  _data = 0x10;                                 \
-        Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&_addr, &_data); \
-    } while (0)
+#define LX07_CAN_ID_SCH_STS (0x501u) // CPU负载状态帧
+#define LX07_CAN_ID_I2C_STS (0x502u) // I2C错误计数帧
+#define LX07_CAN_ID_REG_CHK (0x503u) // 寄存器回读校验帧
+#define LX07_CAN_ID_JOB_STS (0x504u) // 产线任务统计帧
+#define LX07_CAN_ID_TOUCH   (0x505u) // 触摸事件及手势帧
 
-#define DES_GPIO_LOW(pin)                                      \
-    do                                                         \
-    {                                                          \
-        uint16_t _addr = 0x0200 + (pin) * 0x3;                 \
-        uint8_t  _data = 0x00;                                 \
-        Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&_addr, &_data); \
-    } while (0)
+/* 解串器GPIO输出，用于RegSeq操作流 */
+#define DES_GPIO_HIGH(pin) REGSEQ_OP_WR(0x0200u + (pin) * 0x3u, 0x10u)
+#define DES_GPIO_LOW(pin)  REGSEQ_OP_WR(0x0200u + (pin) * 0x3u, 0x00u)
 
 /*****************************************************************************
  * Global data types
  *****************************************************************************/
-typedef struct
-{
-    uint8_t u8DstAddr;
-    uint8_t u8DstRegAddr;
-    uint8_t u8RegData;
-} Lx07_stI2cWrite;
+
 /*****************************************************************************
  * Variant declarations
  *****************************************************************************/
@@ -61,6 +51,11 @@ typedef struct
  *****************************************************************************/
 void Lx07_vTask5ms(void);
 void Lx07_vInit(void);
+void Lx07_vReqCpuLoad(void);
+void Lx07_vReqI2cErr(void);
+void Lx07_vReqRegChk(void);
+void Lx07_vReqJobStat(void);
+bool Lx07_boReqRetime(uint8_t u8Fps);
 #endif
 /*****************************************************************************
  * End file LX07_H
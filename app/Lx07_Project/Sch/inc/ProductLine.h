@@ -20,7 +20,7 @@
 /*****************************************************************************
  * Global macros
  *****************************************************************************/
-
+#define PRODLINE_READ_DATA_SIZE (8) // 单个读取类型的数据缓存长度
 /*****************************************************************************
  * Global data types
  *****************************************************************************/
@@ -41,18 +41,18 @@ typedef enum
     ProDWork_Write_VPGColor,
     ProDWork_Write_Fps,
 
+    ProDWork_Num,
+
     ProDWork_Idle = 0xff,
 } ProductLine_enWorkSts;
 
 typedef enum
 {
-    ProD_I2c_Read_Bkl,
     ProD_I2c_Read_LcdTemp,
     ProD_I2c_Read_PcbTemp,
     ProD_I2c_Read_Batt,
     ProD_I2c_Read_AdHw,
     // 个人定义
-    ProD_I2c_Read_TpCoord,
     ProD_I2c_Read_TpCount,
     ProD_I2c_Read_Fps,
 
@@ -73,40 +73,51 @@ typedef struct
 {
     struct
     {
-        ProductLine_enI2cReadTyp enTyp;
-
-        uint8_t u8Count; // i2c读数据计数
-        uint8_t au8Data[8];
+        uint8_t au8Count[ProD_I2c_Read_Max];                          // i2c读数据计数
+        uint8_t au8Data[ProD_I2c_Read_Max][PRODLINE_READ_DATA_SIZE]; // 每个读取类型独立缓存，不同器件的任务可同时执行
 
-        bool aboStrtFlg[ProD_I2c_Read_Max];
         bool aboEndFlg[ProD_I2c_Read_Max];
 
         bool aboHaveTx[ProD_I2c_Read_Max]; // 是否需要外发
 
     } Read_t;
 
-    struct
-    {
-        ProductLine_enI2cWriteTyp enTyp;
-
-        bool aboWFlg[ProD_I2c_Write_Max];
+} ProductLine_stI2cRW;
 
-    } Write_t;
+typedef void (*ProductLine_pfJobDone)(ProductLine_enWorkSts enJob, bool boLate); // 任务结束回调，boLate表示超过截止时间
+typedef void (*ProductLine_pfWrDone)(bool boOk);                                  // 写事务结束回调，在I2C中断中执行
 
-} ProductLine_stI2cRW;
+typedef struct
+{
+    uint16_t u16Post;     // 新入队次数
+    uint16_t u16Merge;    // 与排队中的同类任务合并的次数
+    uint16_t u16Drop;     // 队列满丢弃的次数
+    uint16_t u16Done;     // 完成次数
+    uint16_t u16Late;     // 超过截止时间完成的次数
+    uint16_t u16MaxLatMs; // 入队到完成的最大时间
+} ProductLine_stJobStat;
 /*****************************************************************************
  * Variant declarations
  *****************************************************************************/
-extern ProductLine_enWorkSts ProductLine_enCurWorkSts;
-extern ProductLine_stI2cRW   ProductLine_stI2cRWMsgs;
+extern ProductLine_stI2cRW ProductLine_stI2cRWMsgs;
 /*****************************************************************************
  * Global function prototypes
  *****************************************************************************/
 void ProductLine_vHandle(void);
 void ProductLine_vInit(void);
+void ProductLine_vKick(void);
+
+/* 任务处理函数在ProductLine_vHandle周期及每次I2C读完成事件中被调用，
+ * 一次调用内尽量连续推进步骤，只在等待总线或器件时返回；最后一步调用ProductLine_vJobDone */
+void     ProductLine_vJobDone(ProductLine_enWorkSts enJob);
+uint32_t ProductLine_u32NowMs(void); // 任务时间基准，5ms步进，用于步骤内的定时等待
+
+bool ProductLine_boPost(ProductLine_enWorkSts enJob, ProductLine_pfJobDone pfDone); // 中断中也可调用，pfDone可为NULL
+bool ProductLine_boGetJobStat(uint8_t u8Job, ProductLine_stJobStat *pstStat);      // u8Job越界返回false
 
-void ProductLine_vI2cRecvHandle(void);
-void ProductLine_vI2cStopHandle(void);
+bool ProductLine_boI2cWrite(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len);
+bool ProductLine_boI2cWriteCb(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len, ProductLine_pfWrDone pfDone); // 器件中已是这些值时不提交，也不回调
+bool ProductLine_boI2cRead(ProductLine_enI2cReadTyp enTyp, uint8_t u8Dev, uint8_t u8Reg);
 #endif
 /*****************************************************************************
  * End file PRODUCTLINE_H
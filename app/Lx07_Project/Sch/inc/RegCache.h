@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * @file RegCache.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef REGCACHE_H
+#define REGCACHE_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+#define REGCACHE_SIZE      (128u) // 影子寄存器总数，必须为2的幂
+#define REGCACHE_PROBE_MAX (8u)   // 散列冲突时向后查找的槽位数
+
+#define REGCACHE_DEV_ALL (0xFFu) // RegCache_vDrop参数：清空所有器件
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+/* 写穿透影子寄存器：提交写事务的顺序为 vBegin -> vPut(脏) -> I2cXfer_boSubmit，提交失败调用vCancel；
+ * 该器件的写事务全部成功结束后脏项转为有效，任一失败则丢弃该器件全部缓存。
+ * 只有有效(非脏)的项才用于读取和跳过重复写入，易变寄存器及表外器件始终访问总线 */
+uint8_t RegCache_u8AddrLen(uint8_t u8Dev); // 缓存器件的寄存器地址宽度，表外器件返回0
+bool    RegCache_boGet(uint8_t u8Dev, uint16_t u16Reg, uint8_t *pu8Val);
+bool    RegCache_boSame(uint8_t u8Dev, uint16_t u16Reg, uint8_t u8Val); // 器件中已是该值，可跳过写入
+void    RegCache_vPut(uint8_t u8Dev, uint16_t u16Reg, uint8_t u8Val, bool boDirty);  // 写入提交前boDirty=true，读回的数据boDirty=false
+void    RegCache_vBegin(uint8_t u8Dev);                                            // 写事务写入缓存之前调用
+void    RegCache_vDone(uint8_t u8Dev, bool boOk);                                  // I2cXfer写事务结束时调用
+void    RegCache_vCancel(uint8_t u8Dev);                                           // 写入未能提交，丢弃该器件的脏项
+void    RegCache_vDrop(uint8_t u8Dev);                                             // 器件复位或掉电后清空
+#endif
+/*****************************************************************************
+ * End file REGCACHE_H
+ *****************************************************************************/
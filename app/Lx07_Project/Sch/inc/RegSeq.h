@@ -0,0 +1,141 @@
+/*****************************************************************************
+ * @file RegSeq.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef REGSEQ_H
+#define REGSEQ_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "Config.h"
+#include "I2cXfer.h"
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+#define REGSEQ_CMD_SIZE (64u)  // 单个命令流缓存，每段连续写占 地址字节 + N(数据) 个命令
+#define REGSEQ_BUF_NUM  (2u)   // 双缓存：一段在总线上发送时准备下一段
+#define REGSEQ_RUN_MAX  (32u)  // 单次自增写的最大数据字节数
+#define REGSEQ_CHK_LOG  (4u)   // 回读校验记录的不一致寄存器个数
+
+#define REGSEQ_ADDR8  (1u) // 8位寄存器地址（背光芯片等）
+#define REGSEQ_ADDR16 (2u) // 16位寄存器地址（串行器/解串器）
+
+/* 表中的延时项：从机地址0x00(广播地址)不会出现在寄存器表中，u16DstRegAddr为延时ms
+ * 延时项前的写入全部完成后才开始计时，只放在器件确实需要等待的位置 */
+#define REGSEQ_DEV_DELAY (0x00u)
+#define REGSEQ_DELAY(Ms) {REGSEQ_DEV_DELAY, (Ms), 0x00u}
+
+/* 操作流编写宏，每条操作8字节 */
+#define REGSEQ_OP_TARGET(Dev, AddrLen) {RegSeq_OpTarget, (Dev), (AddrLen), {NULL}}                            // 切换目标器件及寄存器地址宽度
+#define REGSEQ_OP_WR(Reg, Data)        {RegSeq_OpWr, (Data), (Reg), {NULL}}                                   // 写单个寄存器
+#define REGSEQ_OP_RUN(Reg, Buf)        {RegSeq_OpRun, sizeof(Buf), (Reg), {(Buf)}}                            // 从Reg起自增写一段数据
+#define REGSEQ_OP_TBL(Tbl, AddrLen)    {RegSeq_OpTbl, (AddrLen), (sizeof(Tbl) / sizeof((Tbl)[0])), {(Tbl)}}  // 写寄存器表（合并连续地址）
+#define REGSEQ_OP_DELAY(Ms)            {RegSeq_OpDelay, 0u, (Ms), {NULL}}                                     // 前面写入完成后延时
+#define REGSEQ_OP_WAIT(Cond, HoldMs)   {RegSeq_OpWait, 0u, (HoldMs), {.pfCond = (Cond)}}                      // 条件持续成立HoldMs后继续
+#define REGSEQ_OP_CALL(Func)           REGSEQ_OP_WAIT(Func, 0u)                                               // 执行一次动作，返回true后继续
+#define REGSEQ_OP_VERIFY(Reg, Data)    {RegSeq_OpVerify, (Data), (Reg), {NULL}}                               // 回读寄存器并比较
+#define REGSEQ_OP_CHECK(Tbl, AddrLen)  {RegSeq_OpCheck, (AddrLen), (sizeof(Tbl) / sizeof((Tbl)[0])), {(Tbl)}} // 自增读回寄存器表，与表中最终值批量比较
+#define REGSEQ_OP_END()                {RegSeq_OpEnd, 0u, 0u, {NULL}}
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum
+{
+    RegSeq_OpTarget,
+    RegSeq_OpWr,
+    RegSeq_OpRun,
+    RegSeq_OpTbl,
+    RegSeq_OpDelay,
+    RegSeq_OpWait, // 等待GPIO等外部条件
+    RegSeq_OpVerify,
+    RegSeq_OpCheck,
+    RegSeq_OpEnd,
+} RegSeq_enOp;
+
+typedef bool (*RegSeq_pfCond)(void);                              // 每个任务周期调用一次
+typedef uint8_t (*RegSeq_pfMask)(uint8_t u8Dev, uint16_t u16Reg); // 回读校验时参与比较的位，需排除只读状态位
+
+typedef struct
+{
+    uint8_t  u8Dev;
+    uint8_t  u8Exp;
+    uint16_t u16Reg;
+    uint8_t  u8Act;
+} RegSeq_stChkLog;
+
+typedef struct
+{
+    uint8_t  u8Op;   // RegSeq_enOp
+    uint8_t  u8Arg;  // TARGET:从机地址  WR/VERIFY:数据  RUN:长度  TBL/CHECK:地址宽度
+    uint16_t u16Arg; // TARGET:地址宽度  WR/RUN/VERIFY:寄存器  TBL/CHECK:表项数  DELAY/WAIT:ms
+    union
+    {
+        const void   *pvArg; // RUN:数据  TBL/CHECK:寄存器表
+        RegSeq_pfCond pfCond;
+    } unPtr;
+} RegSeq_stOp;
+
+/* 操作流执行上下文：
+ * 同一器件、地址连续(+1)的表项合并为一次自增写 {START, 地址, D0..Dn, STOP}，
+ * 若干段拼成一个DMA命令流提交，两个缓存交替使用 */
+typedef struct
+{
+    const RegSeq_stOp *pstOp;
+    uint16_t           u16Pc; // 当前操作
+    uint8_t            u8Dev; // TARGET设定的目标器件
+    uint8_t            u8AddrLen;
+
+    const I2cSendData *pstTbl; // 正在执行的TBL/CHECK操作
+    uint16_t           u16Num;
+    uint16_t           u16Idx; // 下一条待发送(待比较)的表项
+    bool               boTbl;
+
+    bool     boDelay;      // 正在执行延时
+    uint16_t u16DelayTick; // 延时剩余周期数
+    uint16_t u16HoldTick;  // WAIT条件已持续的周期数
+
+    bool     boVerify; // 回读已提交
+    uint8_t  au8VerifyAddr[2];
+    uint8_t  u8VerifyData;
+    uint16_t u16VerifyErr; // 回读不一致/失败次数
+
+    /* CHECK回读校验，pfChkMask及统计值在RegSeq_vStart中不清除 */
+    RegSeq_pfMask   pfChkMask;   // 可为NULL，整字节比较
+    bool            boChk;       // 一批回读已提交
+    uint8_t         u8ChkBuf;    // 回读使用的缓存
+    uint16_t        u16ChkEnd;   // 本批回读覆盖到的表项
+    uint16_t        u16ChkNum;   // 已比较的寄存器数
+    uint16_t        u16ChkErr;   // 不一致的寄存器数
+    uint16_t        u16ChkFail;  // 回读事务失败次数
+    uint8_t         u8ChkLogNum; // astChkLog有效项数
+    RegSeq_stChkLog astChkLog[REGSEQ_CHK_LOG];
+    uint8_t         au8ChkRx[REGSEQ_CMD_SIZE];
+
+    uint8_t        u8Buf; // 下一个填充的缓存
+    I2cXfer_stDesc astDesc[REGSEQ_BUF_NUM];
+    uint16_t       au16Cmd[REGSEQ_BUF_NUM][REGSEQ_CMD_SIZE];
+} RegSeq_stCtx;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+void     RegSeq_vStart(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp);
+bool     RegSeq_boRun(RegSeq_stCtx *pstCtx, uint16_t u16BudgetUs);                        // 每个任务周期调用，本周期最多提交u16BudgetUs总线时间，执行到END返回true
+uint16_t RegSeq_u16RunLen(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16Idx); // 从u16Idx起可合并的表项数
+uint32_t RegSeq_u32BusUs(uint8_t u8Dev, uint8_t u8AddrLen, uint16_t u16DataLen);       // 一段自增写的总线时间估算，按器件速率
+uint16_t RegSeq_u16Delta(const I2cSendData *pstFrom, uint16_t u16FromNum, const I2cSendData *pstTo, uint16_t u16ToNum, I2cSendData *pstOut, uint16_t u16OutMax);
+#endif
+/*****************************************************************************
+ * End file REGSEQ_H
+ *****************************************************************************/
@@ -2,7 +2,11 @@
 #define _SCH_H_
 #include "stdint.h"
 
+/* Record period, lateness and drift of every task group, see Sch_GetTimingInfo */
+// #define SCH_TIMING_MONITOR
+
 typedef void (*Sch_Task_T)(void);
+typedef uint8_t Sch_Event_T;
 
 typedef struct Sch_Task_Info_T
 {
@@ -13,8 +17,35 @@ typedef struct Sch_Task_Info_T
 
 typedef const Sch_Task_Info_T *Sch_Const_Task_Info_T;
 
+typedef struct Sch_Load_Info_T
+{
+    uint8_t u8CurLoad;  /* busy percent of the last window */
+    uint8_t u8PeakLoad; /* highest u8CurLoad since boot or last clear */
+    uint8_t u8Alarm;    /* 1: load stayed above SCH_LOAD_ALARM_PCT */
+} Sch_Load_Info_T;
+
 #define CALL_TASK(idx) Sch_TaskTable[idx].pTask()
 
+#ifdef SCH_TIMING_MONITOR
+typedef struct Sch_Timing_Info_T
+{
+    uint32_t u32Nominal;   /* group period from Sch_RunTaskTable, ticks */
+    uint32_t u32MinPeriod; /* shortest measured period, ticks */
+    uint32_t u32MaxPeriod; /* longest measured period, ticks */
+    uint32_t u32MaxLate;   /* worst task start behind its offset, ticks */
+    uint32_t u32Cycles;    /* completed periods */
+    int32_t  s32Drift;     /* sum of (measured - nominal) periods, ticks */
+} Sch_Timing_Info_T;
+#endif
+
+extern void Sch_TableInit(Sch_Const_Task_Info_T TaskTable);
+extern void Sch_RunOnce(void);
 extern void Sch_Main(void);
+extern void Sch_PostEvent(Sch_Event_T Event);
+extern void Sch_GetCpuLoad(Sch_Load_Info_T *pLoadInfo);
+extern void Sch_ClearCpuLoadPeak(void);
+#ifdef SCH_TIMING_MONITOR
+extern void Sch_GetTimingInfo(uint8_t u8Group, Sch_Timing_Info_T *pInfo);
+#endif
 
 #endif
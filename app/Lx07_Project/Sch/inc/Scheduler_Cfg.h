@@ -6,6 +6,19 @@
 #define SCH_EndOfList         (Sch_Task_T)0
 #define SCH_MS(Ms)            Ms
 #define SCH_TIMEDURATION(Idx) (SCH_1MSCOUNTER(64) * (Idx))
+#define SCH_SYSTICK_MASK      0x00FFFFFFu
+
+/* CPU load window and high load alarm (N windows in a row above PCT) */
+#define SCH_LOAD_WINDOW        SCH_TIMEDURATION(1000u)
+#define SCH_LOAD_ALARM_PCT     80u
+#define SCH_LOAD_ALARM_HYST    10u
+#define SCH_LOAD_ALARM_WINDOWS 3u
+
+/* Events posted from ISRs, dispatched by Sch_EventTable on the next loop */
+#define SCH_EVENT_TOUCH_INT 0u
+#define SCH_EVENT_CAN_RX    1u
+#define SCH_EVENT_I2C_DONE  2u
+#define SCH_EVENT_MAX_NUM   3u
 
 typedef struct TaskTablePara
 {
@@ -19,6 +32,7 @@ extern void Sch_Main(void);
 extern void GPIOIntInit(void);
 
 extern const Sch_Task_Info_T Sch_RunTaskTable[];
+extern const Sch_Task_T      Sch_EventTable[SCH_EVENT_MAX_NUM];
 extern uint8_t               u8BatCmdFlag;
 extern uint8_t               u8RegStsCmdFlag;
 extern uint16_t              u16BatVoltageVal;
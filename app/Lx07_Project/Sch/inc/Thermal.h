@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * @file Thermal.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef THERMAL_H
+#define THERMAL_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+#define THERMAL_SAMPLE_MS (1000u) // 温度采样周期，LCD与PCB错开半个周期，降额每周期更新一次
+
+#define THERMAL_PERMILLE (1000u) // 降额上限满量程：不降额
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum
+{
+    Thermal_Lcd,
+    Thermal_Pcb,
+
+    Thermal_Num
+} Thermal_enSensor;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+void     Thermal_vInit(void);
+void     Thermal_vHandle(void);                                                  // 5ms
+void     Thermal_vPutSample(Thermal_enSensor enSensor, int16_t s16Temp, bool boValid); // Adc读取完成后调用，温度单位0.1℃
+bool     Thermal_boGetTemp(Thermal_enSensor enSensor, int16_t *ps16Temp);            // 滤波后的温度，传感器无效返回false
+uint16_t Thermal_u16DeratePm(void);                                                  // 当前背光降额上限，千分比
+#endif
+/*****************************************************************************
+ * End file THERMAL_H
+ *****************************************************************************/
@@ -21,9 +21,28 @@
  * Global macros
  *****************************************************************************/
 // #define TOUCH_NEED_TPCOUNT
+
+#define TOUCH_POINT_MAX (10u) // 触摸芯片一帧最多上报的点数
+#define TOUCH_EVT_NUM   (32u) // 触摸事件缓存个数，2的幂
 /*****************************************************************************
  * Global data types
  *****************************************************************************/
+typedef enum // 与触摸芯片上报的事件类型一致
+{
+    Touch_Down,
+    Touch_Up,
+    Touch_Contact,
+} Touch_enEvtTyp;
+
+typedef struct
+{
+    uint16_t u16X;
+    uint16_t u16Y;
+    uint8_t  u8Id;   // 手指编号 0~9
+    uint8_t  u8Typ;  // Touch_enEvtTyp
+    uint8_t  u8Pres; // 压力
+    uint8_t  u8Area; // 接触面积
+} Touch_stEvent;
 
 /*****************************************************************************
  * Variant declarations
@@ -35,9 +54,11 @@ extern bool     Touch_boMisTpIntFlg;
  *****************************************************************************/
 void Touch_vInit(void);
 void Touch_vHandle(void);
+void Touch_vTpIntEvent(void);
 void Touch_vReadTpCoord(void);
 void Touch_vReadTpCount(void);
 void Touch_vWriteTpCount(void);
+bool Touch_boPopEvent(Touch_stEvent *pstEvt); // 取出最早的触摸事件，缓存为空返回false
 #endif
 /*****************************************************************************
  * End file TOUCH_H
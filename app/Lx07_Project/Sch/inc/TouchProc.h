@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * @file TouchProc.h
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+#ifndef TOUCHPROC_H
+#define TOUCHPROC_H
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "Touch.h"
+/*****************************************************************************
+ * Global macros
+ *****************************************************************************/
+// #define TOUCHPROC_PREDICT // 输出位置按当前速度外推一帧，抵消滤波和传输的延时
+
+#define TOUCHPROC_FRAME_MS (10u) // 触摸芯片上报周期
+
+/* 抖动滤波(One Euro)：静止时截止频率低、坐标稳定，移动越快截止频率越高、越跟手 */
+#define TOUCHPROC_MINCUT_CHZ (100u)  // 静止时的截止频率，0.01Hz
+#define TOUCHPROC_MAXCUT_CHZ (3000u) // 截止频率上限，0.01Hz
+#define TOUCHPROC_BETA       (70u)   // 截止频率随速度的增量，0.0001Hz/(像素/s)
+#define TOUCHPROC_DCUT_CHZ   (100u)  // 速度估计的截止频率，0.01Hz
+
+#define TOUCHPROC_SLOP_PX  (16u)  // 离按下位置小于该距离视为没有移动
+#define TOUCHPROC_TAP_MS   (200u) // 点击：未移动且在该时间内抬起
+#define TOUCHPROC_LONG_MS  (600u) // 长按：未移动且按住超过该时间，按住期间上报一次
+#define TOUCHPROC_SWIPE_PX (80u)  // 滑动：主方向移动超过该距离
+#define TOUCHPROC_SWIPE_MS (500u) // 滑动：在该时间内抬起
+/*****************************************************************************
+ * Global data types
+ *****************************************************************************/
+typedef enum // CAN 0x505 第1字节
+{
+    TouchProc_Rec_Down = 1,
+    TouchProc_Rec_Up,
+    TouchProc_Rec_Move,
+    TouchProc_Rec_Tap,
+    TouchProc_Rec_Long,
+    TouchProc_Rec_Swipe,
+} TouchProc_enRec;
+
+typedef enum // 滑动记录的第7字节
+{
+    TouchProc_Dir_Left,
+    TouchProc_Dir_Right,
+    TouchProc_Dir_Up,
+    TouchProc_Dir_Down,
+} TouchProc_enDir;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Global function prototypes
+ *****************************************************************************/
+/* 触摸事件经滤波和手势识别后，只把按下/抬起/手势及合并后的移动记录经CAN上报 */
+void TouchProc_vInit(void);
+void TouchProc_vPutEvent(const Touch_stEvent *pstEvt);         // 从触摸事件缓存取出后依次调用
+void TouchProc_vHandle(void);                                  // 5ms，在本周期的事件处理完后调用
+bool TouchProc_boGetPrimary(uint16_t *pu16X, uint16_t *pu16Y); // 编号最小的按下手指的输出坐标，没有按下返回false
+#endif
+/*****************************************************************************
+ * End file TOUCHPROC_H
+ *****************************************************************************/
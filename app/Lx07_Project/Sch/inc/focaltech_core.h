@@ -91,8 +91,8 @@ int fts_ft7254_write_backup_gamma(uint8_t *buf, uint32_t len, uint8_t mode);
 int platform_i2c_write(uint8_t *txBuffer, uint16_t len);
 int platform_i2c_read(uint8_t *txBuffer, uint16_t len);
 
-extern void I2C_vSendBuffer(I2C_Id_t i2cId, uint8_t *txBuffer, uint16_t len);
-extern void I2C_vReadBuffer(I2C_Id_t i2cId, uint8_t *rxBuffer, uint16_t len);
+extern bool I2C_boSendBuffer(I2C_Id_t i2cId, uint8_t *txBuffer, uint16_t len);
+extern bool I2C_boReadBuffer(I2C_Id_t i2cId, uint8_t *rxBuffer, uint16_t len);
 
 int fts_gpio_interrupt_handler(void);
 #endif /* __FOCALTECH_CORE_H__ */
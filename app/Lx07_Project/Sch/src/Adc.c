@@ -21,129 +21,182 @@
 #include "Uart2.h"
 #include "Config.h"
 #include "can.h"
-#include "BackL.h"
+#include "Thermal.h"
+#include "AdcScan.h"
+#include "Board.h"
 /*****************************************************************************
  * Local macros
  *****************************************************************************/
-#define ADC_ABS(a, b) ((a > b) ? (a - b) : (b - a))
-
 #define ADC_TMEP_OFFSET_PCB (40)
 #define ADC_TMEP_OFFSET_LCD (55)
 
-#define ADC_INVALID_TEMP (-999.0f) // 无效温度标识
+#define ADC_CODE_FULL (0x7FFu) // 满量程转换值，对应PGA量程4.096V
+#define ADC_VREF_MV   (4096u)
+#define ADC_VDIV_MV   (3300u)                                       // 热敏电阻分压电源
+#define ADC_CODE_VDIV ((ADC_VDIV_MV * ADC_CODE_FULL) / ADC_VREF_MV) // 分压电压不可能达到3.3V，超过该值的转换值无效
+
+#define ADC_RES_K_LCD   (10u) // LCD：R = 10 * V_ad / (3.3 - V_ad) kΩ
+#define ADC_RES_K_PCB   (1u)  // PCB：R = V_ad / (3.3 - V_ad) kΩ
+#define ADC_PCB_REF_NUM (34u) // PCB温度沿用LCD表的前34点（-55℃~110℃）换算
+
+#define ADC_TEMP_MIN (-999) // 温度换算结果限幅，0.1℃
+#define ADC_TEMP_MAX (1999)
+
+/* 表头（低温端）之外外推时电阻超出表头的上限，0.1Ω：外推到此已低于ADC_TEMP_MIN，
+ * 且基准点间隔5℃时分子(R1 - R) * 50不超出int32_t；高温端电阻不小于0，本身有界 */
+#define ADC_RES_EXT_MAX (20000000u)
+
+/* 温度表覆盖[ADC_LUT_LO, ADC_LUT_HI)，每16个转换值一项、项间线性插值，与逐点换算相差不超过0.3℃；
+ * 表外两端（LCD约108℃以上、-44℃以下，PCB约3℃以下）曲线弯曲大，逐点换算 */
+#define ADC_LUT_SHIFT (4u)
+#define ADC_LUT_LO    (128u)
+#define ADC_LUT_HI    (1584u)
+#define ADC_LUT_NUM   (((ADC_LUT_HI - ADC_LUT_LO) >> ADC_LUT_SHIFT) + 1u)
+
+#define ADC_REG_CONV (0x00u) // 转换结果寄存器
+#define ADC_REG_CFG  (0x01u) // 配置寄存器
+#define ADC_CFG_L    (0xc3u) // 3300SPS，关闭比较器
+#define ADC_CFG_OS   (0x80u) // 配置寄存器高字节bit7，读回1表示单次转换结束
+#define ADC_POLL_MAX (8u)    // 查询转换结束的次数上限，超过后直接读取结果
+#define ADC_READ_LEN (2u)    // 配置/结果寄存器均为16位
+
+#define ADC_CODE_NONE   (0xFFFFu) // 读取失败，没有转换值
+#define ADC_HW_TRY_MAX  (5u)      // 硬件版本分压读取失败的重试次数，用完按未知版本处理
 /*****************************************************************************
  * Local data types
  *****************************************************************************/
-// 电阻-温度映射表（center值）：{温度(℃), 电阻(kΩ)}，按温度升序排列
+// 电阻-温度映射表（center值）：{温度(℃), 电阻(0.1Ω)}，按温度升序排列
 typedef struct
 {
-    int   temp; // 温度基准点（每5℃一个基准）
-    float res;  // 对应温度的电阻center值
+    int      temp; // 温度基准点（每5℃一个基准）
+    uint32_t res;  // 对应温度的电阻center值
 } Adc_stResTempRef;
 
-typedef enum
+typedef struct
 {
-    ADC_PCB_TEMP,
-    ADC_LCD_TEMP,
-} Adc_enTempTyp;
+    uint8_t                 u8ResK; // 分压系数：R = K * V_ad / (3.3 - V_ad) kΩ
+    uint8_t                 u8RefNum;
+    const Adc_stResTempRef *pstRef;
+    int16_t                 as16Lut[ADC_LUT_NUM]; // 转换值 -> 温度(0.1℃)，Adc_vInit中由电阻表生成
+} Adc_stNtc;
 /*****************************************************************************
  * Variant declarations
  *****************************************************************************/
 // 基准数据：温度从-40℃到125℃，每5℃一个点（共34个基准点）  //  NCP15XH103F03RC
 static const Adc_stResTempRef stAdPcbResTempRefs[] = {
-    {-40, 195.6520},
-    {-35, 148.1710},
-    {-30, 113.3471},
-    {-25, 87.5588 },
-    {-20, 68.2367 },
-    {-15, 53.6496 },
-    {-10, 42.5062 },
-    {-5,  33.8922 },
-    {0,   27.2186 },
-    {5,   22.0211 },
-    {10,  17.9255 },
-    {15,  14.6735 },
-    {20,  12.0805 },
-    {25,  10.0000 },
-    {30,  8.3145  },
-    {35,  6.9479  },
-    {40,  5.8336  },
-    {45,  4.9169  },
-    {50,  4.1609  },
-    {55,  3.5350  },
-    {60,  3.0143  },
-    {65,  2.5861  },
-    {70,  2.2275  },
-    {75,  1.9245  },
-    {80,  1.6685  },
-    {85,  1.4521  },
-    {90,  1.2680  },
-    {95,  1.0965  },
-    {100, 0.9738  },
-    {105, 0.8798  },
-    {110, 0.8049  },
-    {115, 0.7305  },
-    {120, 0.6591  },
-    {125, 0.5821  }
+    {-40, 1956520},
+    {-35, 1481710},
+    {-30, 1133471},
+    {-25, 875588 },
+    {-20, 682367 },
+    {-15, 536496 },
+    {-10, 425062 },
+    {-5,  338922 },
+    {0,   272186 },
+    {5,   220211 },
+    {10,  179255 },
+    {15,  146735 },
+    {20,  120805 },
+    {25,  100000 },
+    {30,  83145  },
+    {35,  69479  },
+    {40,  58336  },
+    {45,  49169  },
+    {50,  41609  },
+    {55,  35350  },
+    {60,  30143  },
+    {65,  25861  },
+    {70,  22275  },
+    {75,  19245  },
+    {80,  16685  },
+    {85,  14521  },
+    {90,  12680  },
+    {95,  10965  },
+    {100, 9738   },
+    {105, 8798   },
+    {110, 8049   },
+    {115, 7305   },
+    {120, 6591   },
+    {125, 5821   }
 };
 
 // 基准数据：温度从-55℃到150℃，每5℃一个点（共42个基准点）   //NCU15XH103F6SRC
 static const Adc_stResTempRef stAdLcdResTempRefs[] = {
-    {-55, 470.1223},
-    {-50, 348.6184},
-    {-45, 260.2623},
-    {-40, 195.6520},
-    {-35, 148.1710},
-    {-30, 113.3471},
-    {-25, 87.5588 },
-    {-20, 68.2367 },
-    {-15, 53.6496 },
-    {-10, 42.5062 },
-    {-5,  33.8922 },
-    {0,   27.2186 },
-    {5,   22.0211 },
-    {10,  17.9255 },
-    {15,  14.6735 },
-    {20,  12.0805 },
-    {25,  10.0000 },
-    {30,  8.3145  },
-    {35,  6.9479  },
-    {40,  5.8336  },
-    {45,  4.9169  },
-    {50,  4.1609  },
-    {55,  3.5350  },
-    {60,  3.0143  },
-    {65,  2.5861  },
-    {70,  2.2275  },
-    {75,  1.9245  },
-    {80,  1.6685  },
-    {85,  1.4521  },
-    {90,  1.2680  },
-    {95,  1.0965  },
-    {100, 0.9738  },
-    {105, 0.8798  },
-    {110, 0.8049  },
-    {115, 0.7305  },
-    {120, 0.6591  },
-    {125, 0.5821  },
-    {130, 0.4742  },
-    {135, 0.4335  },
-    {140, 0.3897  },
-    {145, 0.3647  },
-    {150, 0.3095  }
+    {-55, 4701223},
+    {-50, 3486184},
+    {-45, 2602623},
+    {-40, 1956520},
+    {-35, 1481710},
+    {-30, 1133471},
+    {-25, 875588 },
+    {-20, 682367 },
+    {-15, 536496 },
+    {-10, 425062 },
+    {-5,  338922 },
+    {0,   272186 },
+    {5,   220211 },
+    {10,  179255 },
+    {15,  146735 },
+    {20,  120805 },
+    {25,  100000 },
+    {30,  83145  },
+    {35,  69479  },
+    {40,  58336  },
+    {45,  49169  },
+    {50,  41609  },
+    {55,  35350  },
+    {60,  30143  },
+    {65,  25861  },
+    {70,  22275  },
+    {75,  19245  },
+    {80,  16685  },
+    {85,  14521  },
+    {90,  12680  },
+    {95,  10965  },
+    {100, 9738   },
+    {105, 8798   },
+    {110, 8049   },
+    {115, 7305   },
+    {120, 6591   },
+    {125, 5821   },
+    {130, 4742   },
+    {135, 4335   },
+    {140, 3897   },
+    {145, 3647   },
+    {150, 3095   }
 };
+
+static Adc_stNtc Adc_stLcdNtc = {ADC_RES_K_LCD, sizeof(stAdLcdResTempRefs) / sizeof(stAdLcdResTempRefs[0]), stAdLcdResTempRefs, {0}};
+static Adc_stNtc Adc_stPcbNtc = {ADC_RES_K_PCB, ADC_PCB_REF_NUM, stAdLcdResTempRefs, {0}};
+
+#ifdef ADC_ONCHIP
+static bool Adc_boScanInit = false; // 硬件版本识别先于Adc_vInit时已启动扫描
+#endif
 /*****************************************************************************
  * Local function prototypes
  *****************************************************************************/
-static void  Adc_vFindResSegment(float res, int *left, int *right, const Adc_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp);
-static float Adc_flCalcTemperature(float res, const Adc_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp);
+static int16_t Adc_s16ResToTemp(uint32_t u32Res, const Adc_stResTempRef astResTempRef[], uint8_t u8ArrSize);
+static int16_t Adc_s16CodeToTemp(const Adc_stNtc *pstNtc, uint16_t u16Code);
+static void    Adc_vBuildLut(Adc_stNtc *pstNtc);
+static int16_t Adc_s16NtcTemp(const Adc_stNtc *pstNtc, uint16_t u16Code);
+static bool    Adc_boConvert(ProductLine_enI2cReadTyp enTyp, uint8_t u8CfgH, uint8_t *pu8Step, uint16_t *pu16Ad);
+#ifdef ADC_ONCHIP
+static void Adc_vScanInit(void);
+#endif
 /*****************************************************************************
  * function definitions
  *****************************************************************************/
 void Adc_vInit(void)
 {
-    ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_AdHw] = true;
-    // ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Batt] = true;
+    Adc_vBuildLut(&Adc_stLcdNtc);
+    Adc_vBuildLut(&Adc_stPcbNtc);
+
+#ifdef ADC_ONCHIP
+    Adc_vScanInit();
+#endif
+
+    ProductLine_boPost(ProDWork_Read_AdHw, NULL);
+    // ProductLine_boPost(ProDWork_Read_Batt, NULL);
 }
 
 void Adc_vHandle(void) // 5ms
@@ -154,128 +207,219 @@ void Adc_vHandle(void) // 5ms
 
     if (u16TrigCnt % MAIN_TIME_MS(1000) == 0)
     {
-        // if (!ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Batt])
-        //     ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Batt] = true;
+        // ProductLine_boPost(ProDWork_Read_Batt, NULL);
     }
     else
     {}
 
-    if (u16TrigCnt % MAIN_TIME_MS(1155) == 0)
-    {
-        // if (!ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_LcdTemp])
-        //     ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_LcdTemp] = true;
-    }
-    else
-    {}
+    // LCD/PCB温度由Thermal模块周期采样
 
-    if (u16TrigCnt % MAIN_TIME_MS(1355) == 0)
+    if (u16TrigCnt >= MAIN_TIME_MS(5000))
     {
-        // if (!ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_PcbTemp])
-        //     ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_PcbTemp] = true;
+        u16TrigCnt = 1;
     }
     else
     {}
+}
 
-    if (u16TrigCnt >= MAIN_TIME_MS(5000))
+#ifdef ADC_ONCHIP
+static void Adc_vScanInit(void) // 只启动一次
+{
+    if (!Adc_boScanInit)
     {
-        u16TrigCnt = 1;
+        Adc_boScanInit = true;
+        AdcScan_vInit();
     }
     else
     {}
 }
 
-void Adc_vReadLcdTemp(void) // NCU15XH103F6SRC
+/* 片内ADC由TDG周期扫描，直接取环形缓存中的平均值，折算成外部ADC的转换值后沿用原换算，不访问I2C总线。
+ * 上电后第一轮扫描结束前没有数据，*pu8Step作为等待次数，用完仍无数据按读取失败处理 */
+static bool Adc_boConvert(ProductLine_enI2cReadTyp enTyp, uint8_t u8CfgH, uint8_t *pu8Step, uint16_t *pu16Ad)
 {
-    static uint8_t u8StepLcbT = 3;
+    AdcScan_enCh enCh;
+    uint16_t     u16Mv = 0;
+    uint32_t     u32Code;
 
-    uint8_t  u8ConfigArray[] = {0x01u, 0xd3, 0xc3};
-    uint16_t u16ReadAd       = 0;
-    double   dbAdVol, dbRes = 0.0;
-    uint8_t  u8Temp          = 0;
-    float    flTemp          = 0.0;
-    uint8_t  au8UartTxData[] = {0x74, 0x37, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x20, 0x32, 0x35, 0x22, 0xff, 0xff, 0xff};
+    (void)u8CfgH;
 
-    if (3 == u8StepLcbT)
+    if (ProD_I2c_Read_LcdTemp == enTyp)
+    {
+        enCh = AdcScan_LcdTemp;
+    }
+    else if (ProD_I2c_Read_PcbTemp == enTyp)
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x49);
-        I2C_Enable(I2C0_ID);
-        u8StepLcbT = 2;
+        enCh = AdcScan_PcbTemp;
     }
-    else if (2 == u8StepLcbT)
+    else if (ProD_I2c_Read_Batt == enTyp)
     {
-        Ex_MstWriteDoubleByte(I2C0_ID, (uint8_t *)(u8ConfigArray));
-        u8StepLcbT = 1;
+        enCh = AdcScan_Batt;
     }
-    else if (1 == u8StepLcbT)
+    else
     {
-        uint8_t addr_ad = 0;
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&addr_ad));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_LcdTemp] = true;
+        enCh = AdcScan_Hw;
+    }
 
-        u8StepLcbT = 0;
+    if (AdcScan_boGetMv(enCh, &u16Mv))
+    {
+        u32Code = ((uint32_t)u16Mv * ADC_CODE_FULL + ADC_VREF_MV / 2u) / ADC_VREF_MV;
+        *pu16Ad = (u32Code > ADC_CODE_FULL) ? ADC_CODE_FULL : (uint16_t)u32Code;
     }
-    else if (0 == u8StepLcbT)
+    else if (*pu8Step > 0u)
     {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_LcdTemp])
-        {
-            u8StepLcbT = 3;
+        (*pu8Step)--;
+        return false;
+    }
+    else
+    {
+        *pu16Ad = ADC_CODE_NONE;
+    }
 
-            ProductLine_enCurWorkSts = ProDWork_Idle;
+    *pu8Step = 3;
 
-            u16ReadAd = (ProductLine_stI2cRWMsgs.Read_t.au8Data[0] << 4u) | (ProductLine_stI2cRWMsgs.Read_t.au8Data[1] >> 4u);
-            dbAdVol   = (u16ReadAd * 4.096) / 0x7FF;
+    return true;
+}
+#else
+/* 单次转换：写配置启动 -> 查询OS位 -> 读结果，每步在上一步的I2C读完成事件中接着执行，
+ * 写配置和第一次查询在同一次调用中排入总线队列。各ADC任务同属DEV_ADC，不会同时执行，共用查询计数。
+ * 任何一次读取未完成，或读回的配置（除OS位）与写入的不同（配置写入失败，结果寄存器还是上一通道的），
+ * 结束本次转换并给出ADC_CODE_NONE */
+static bool Adc_boConvert(ProductLine_enI2cReadTyp enTyp, uint8_t u8CfgH, uint8_t *pu8Step, uint16_t *pu16Ad)
+{
+    static uint8_t u8Poll = 0;
 
-            /*R = 10 * V_ad / (3.3 - V_ad)*/
-            if (dbAdVol >= 3.3)
+    uint8_t  au8Cfg[] = {ADC_REG_CFG, u8CfgH, ADC_CFG_L};
+    uint8_t *pu8Data  = ProductLine_stI2cRWMsgs.Read_t.au8Data[enTyp];
+    bool     boRte    = false;
+
+    if (3 == *pu8Step)
+    {
+        if (ProductLine_boI2cWrite(DEV_ADC, au8Cfg, sizeof(au8Cfg)))
+        {
+            u8Poll   = 0;
+            *pu8Step = 2;
+        }
+        else
+        {}
+    }
+
+    if (2 == *pu8Step)
+    {
+        if (ProductLine_boI2cRead(enTyp, DEV_ADC, ADC_REG_CFG))
+        {
+            u8Poll++;
+            *pu8Step = 1;
+        }
+        else
+        {}
+    }
+    else if (1 == *pu8Step)
+    {
+        if (ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp])
+        {}
+        else if ((ADC_READ_LEN != ProductLine_stI2cRWMsgs.Read_t.au8Count[enTyp]) || (0u != ((pu8Data[0] ^ u8CfgH) & (uint8_t)~ADC_CFG_OS)))
+        {
+            *pu16Ad  = ADC_CODE_NONE;
+            *pu8Step = 3;
+            boRte    = true;
+        }
+        else if ((0u == (pu8Data[0] & ADC_CFG_OS)) && (u8Poll < ADC_POLL_MAX)) // 仍在转换，再查询一次
+        {
+            if (ProductLine_boI2cRead(enTyp, DEV_ADC, ADC_REG_CFG))
             {
-                // 理论上采集的电压不可能大于3.3v
+                u8Poll++;
             }
             else
             {
-                dbRes  = 10 * dbAdVol / (3.3 - dbAdVol);
-                flTemp = Adc_flCalcTemperature((float)dbRes, stAdLcdResTempRefs, ADC_LCD_TEMP);
+                *pu8Step = 2;
             }
+        }
+        else if (ProductLine_boI2cRead(enTyp, DEV_ADC, ADC_REG_CONV))
+        {
+            *pu8Step = 0;
+        }
+        else
+        {}
+    }
+    else if (0 == *pu8Step)
+    {
+        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp])
+        {
+            *pu16Ad  = (ADC_READ_LEN == ProductLine_stI2cRWMsgs.Read_t.au8Count[enTyp]) ? (uint16_t)((pu8Data[0] << 4u) | (pu8Data[1] >> 4u)) : ADC_CODE_NONE;
+            *pu8Step = 3;
+            boRte    = true;
+        }
+        else
+        {}
+    }
+    else
+    {}
 
-            if (flTemp >= 0)
-            {
-                u8Temp           = (uint8_t)(flTemp + 0.5);
-                au8UartTxData[8] = 0x20; // 空格
+    return boRte;
+}
+#endif
 
-                BackL_vDireating(u8Temp);
-            }
-            else
-            {
-                u8Temp           = (uint8_t)((flTemp - 0.5) * (-1));
-                au8UartTxData[8] = 0x2d; // 负号
-            }
+void Adc_vReadLcdTemp(void) // NCU15XH103F6SRC
+{
+    static uint8_t u8StepLcbT = 3;
 
-            if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp])
-            {
-                /*Tx 0x500*/
-                memset(stCanRxBuf.data, 0, 8);
+    uint16_t u16ReadAd       = 0;
+    int16_t  s16Temp         = 0; // 0.1℃
+    uint8_t  u8Temp          = 0;
+    uint8_t  au8UartTxData[] = {0x74, 0x37, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x20, 0x32, 0x35, 0x22, 0xff, 0xff, 0xff};
 
-                if (flTemp >= 0)
-                {
-                    stCanRxBuf.data[4] = u8Temp + ADC_TMEP_OFFSET_LCD;
-                }
-                else
-                {
-                    stCanRxBuf.data[4] = ADC_TMEP_OFFSET_LCD - u8Temp;
-                }
+    if (!Adc_boConvert(ProD_I2c_Read_LcdTemp, 0xd3, &u8StepLcbT, &u16ReadAd))
+    {}
+    else if (ADC_CODE_NONE == u16ReadAd)
+    {
+        ProductLine_vJobDone(ProDWork_Read_LcdTemp);
+        Thermal_vPutSample(Thermal_Lcd, 0, false); // 读取失败按无效采样计数，不上报
+    }
+    else
+    {
+        ProductLine_vJobDone(ProDWork_Read_LcdTemp);
 
-                CAN_Send_Msg(0x500, stCanRxBuf.data);
+        s16Temp = Adc_s16NtcTemp(&Adc_stLcdNtc, u16ReadAd);
 
-                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp] = false;
+        Thermal_vPutSample(Thermal_Lcd, s16Temp, (u16ReadAd > 0) && (u16ReadAd <= ADC_CODE_VDIV)); // 0或超过分压上限为NTC开路/短路
+
+        if (s16Temp >= 0)
+        {
+            u8Temp           = (uint8_t)((s16Temp + 5) / 10);
+            au8UartTxData[8] = 0x20; // 空格
+        }
+        else
+        {
+            u8Temp           = (uint8_t)((5 - s16Temp) / 10);
+            au8UartTxData[8] = 0x2d; // 负号
+        }
+
+        if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp])
+        {
+            /*Tx 0x500*/
+            memset(stCanRxBuf.data, 0, 8);
+
+            if (s16Temp >= 0)
+            {
+                stCanRxBuf.data[4] = u8Temp + ADC_TMEP_OFFSET_LCD;
             }
             else
-            {}
+            {
+                stCanRxBuf.data[4] = ADC_TMEP_OFFSET_LCD - u8Temp;
+            }
 
-            au8UartTxData[9]  = 0x30 + u8Temp / 10;
-            au8UartTxData[10] = 0x30 + (u8Temp % 10);
+            CAN_Send_Msg(0x500, stCanRxBuf.data);
 
-            Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
+            ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp] = false;
         }
+        else
+        {}
+
+        au8UartTxData[9]  = 0x30 + u8Temp / 10;
+        au8UartTxData[10] = 0x30 + (u8Temp % 10);
+
+        Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
     }
 }
 
@@ -283,92 +427,62 @@ void Adc_vReadPcbTemp(void) // NCP15XH103F03RC
 {
     static uint8_t u8StepPcbT = 3;
 
-    uint8_t  u8ConfigArray[] = {0x01u, 0xf3, 0xc3};
     uint16_t u16ReadAd       = 0;
-    double   dbAdVol, dbRes = 0.0;
+    int16_t  s16Temp         = 0; // 0.1℃
     uint8_t  u8Temp          = 0;
-    float    flTemp          = 0.0;
     uint8_t  au8UartTxData[] = {0x74, 0x31, 0x35, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x20, 0x33, 0x35, 0x22, 0xff, 0xff, 0xff};
 
-    if (3 == u8StepPcbT)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x49);
-        I2C_Enable(I2C0_ID);
-        u8StepPcbT = 2;
-    }
-    else if (2 == u8StepPcbT)
+    if (!Adc_boConvert(ProD_I2c_Read_PcbTemp, 0xf3, &u8StepPcbT, &u16ReadAd))
+    {}
+    else if (ADC_CODE_NONE == u16ReadAd)
     {
-        Ex_MstWriteDoubleByte(I2C0_ID, (uint8_t *)(u8ConfigArray));
-        u8StepPcbT = 1;
+        ProductLine_vJobDone(ProDWork_Read_PcbTemp);
+        Thermal_vPutSample(Thermal_Pcb, 0, false); // 读取失败按无效采样计数，不上报
     }
-    else if (1 == u8StepPcbT)
+    else
     {
-        uint8_t addr_ad = 0;
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&addr_ad));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_PcbTemp] = true;
+        ProductLine_vJobDone(ProDWork_Read_PcbTemp);
 
-        u8StepPcbT = 0;
-    }
-    else if (0 == u8StepPcbT)
-    {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_PcbTemp])
-        {
-            u8StepPcbT = 3;
+        s16Temp = Adc_s16NtcTemp(&Adc_stPcbNtc, u16ReadAd);
 
-            ProductLine_enCurWorkSts = ProDWork_Idle;
+        Thermal_vPutSample(Thermal_Pcb, s16Temp, (u16ReadAd > 0) && (u16ReadAd <= ADC_CODE_VDIV));
 
-            u16ReadAd = (ProductLine_stI2cRWMsgs.Read_t.au8Data[0] << 4u) | (ProductLine_stI2cRWMsgs.Read_t.au8Data[1] >> 4u);
-            dbAdVol   = (u16ReadAd * 4.096) / 0x7FF;
+        if (s16Temp >= 0)
+        {
+            u8Temp           = (uint8_t)((s16Temp + 5) / 10);
+            au8UartTxData[9] = 0x20; // 空格
+        }
+        else
+        {
+            u8Temp           = (uint8_t)((5 - s16Temp) / 10);
+            au8UartTxData[9] = 0x2d; // 负号
+        }
 
-            /*R = v_ad / (3.3 - V_ad)*/
-            if (dbAdVol >= 3.3)
-            {
-                // 理论上采集的电压不可能大于3.3v
-            }
-            else
-            {
-                dbRes  = dbAdVol / (3.3 - dbAdVol);
-                flTemp = Adc_flCalcTemperature((float)dbRes, stAdLcdResTempRefs, ADC_PCB_TEMP);
-            }
+        if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp])
+        {
+            /*Tx 0x500*/
+            memset(stCanRxBuf.data, 0, 8);
 
-            if (flTemp >= 0)
+            if (s16Temp >= 0)
             {
-                u8Temp           = (uint8_t)(flTemp + 0.5);
-                au8UartTxData[9] = 0x20; // 空格
+                stCanRxBuf.data[5] = u8Temp + ADC_TMEP_OFFSET_PCB;
             }
             else
             {
-                u8Temp           = (uint8_t)((flTemp - 0.5) * (-1));
-                au8UartTxData[9] = 0x2d; // 负号
+                stCanRxBuf.data[5] = ADC_TMEP_OFFSET_PCB - u8Temp;
             }
 
-            if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp])
-            {
-                /*Tx 0x500*/
-                memset(stCanRxBuf.data, 0, 8);
-
-                if (flTemp >= 0)
-                {
-                    stCanRxBuf.data[5] = u8Temp + ADC_TMEP_OFFSET_PCB;
-                }
-                else
-                {
-                    stCanRxBuf.data[5] = ADC_TMEP_OFFSET_PCB - u8Temp;
-                }
-
-                CAN_Send_Msg(0x500, stCanRxBuf.data);
+            CAN_Send_Msg(0x500, stCanRxBuf.data);
 
-                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp] = false;
-            }
-            else
-            {}
+            ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp] = false;
+        }
+        else
+        {}
 
-            au8UartTxData[10] = 0x30 + u8Temp / 10;
-            au8UartTxData[11] = 0x30 + (u8Temp % 10);
+        au8UartTxData[10] = 0x30 + u8Temp / 10;
+        au8UartTxData[11] = 0x30 + (u8Temp % 10);
 
-            Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
-        }
+        Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
     }
 }
 
@@ -376,231 +490,227 @@ void Adc_vReadBatt(void)
 {
     static uint8_t u8StepBatt = 3;
 
-    uint8_t  u8ConfigArray[] = {0x01u, 0xc3, 0xc3}; // batt
-    uint16_t u16ReadAd       = 0;
+    uint16_t u16ReadAd = 0;
     double   dbAdVol, dbBatt, dbCalcuBatt = 0.0;
 
-    if (3 == u8StepBatt)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x49);
-        I2C_Enable(I2C0_ID);
-        u8StepBatt = 2;
-    }
-    else if (2 == u8StepBatt)
+    if (!Adc_boConvert(ProD_I2c_Read_Batt, 0xc3, &u8StepBatt, &u16ReadAd))
+    {}
+    else if (ADC_CODE_NONE == u16ReadAd)
     {
-        Ex_MstWriteDoubleByte(I2C0_ID, (uint8_t *)(u8ConfigArray));
-        u8StepBatt = 1;
+        ProductLine_vJobDone(ProDWork_Read_Batt); // 读取失败，不上报
     }
-    else if (1 == u8StepBatt)
+    else
     {
-        uint8_t addr_ad = 0;
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&addr_ad));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Batt] = true;
+        ProductLine_vJobDone(ProDWork_Read_Batt);
 
-        u8StepBatt = 0;
-    }
-    else if (0 == u8StepBatt)
-    {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Batt])
-        {
-            u8StepBatt = 3;
+        dbAdVol = (u16ReadAd * 4.096) / 0x7FF;
+        dbBatt  = dbAdVol / (20.0 / (150 + 20));
 
-            ProductLine_enCurWorkSts = ProDWork_Idle;
+        dbCalcuBatt = dbBatt + 0.45;
 
-            u16ReadAd = (ProductLine_stI2cRWMsgs.Read_t.au8Data[0] << 4u) | (ProductLine_stI2cRWMsgs.Read_t.au8Data[1] >> 4u);
-
-            dbAdVol = (u16ReadAd * 4.096) / 0x7FF;
-            dbBatt  = dbAdVol / (20.0 / (150 + 20));
-
-            dbCalcuBatt = dbBatt + 0.45;
-
-            if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt])
-            {
-                /*Tx 0x500*/
-                memset(stCanRxBuf.data, 0, 8);
+        if (ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt])
+        {
+            /*Tx 0x500*/
+            memset(stCanRxBuf.data, 0, 8);
 
-                dbCalcuBatt >= 25.5 ? dbCalcuBatt = 25.5 : dbCalcuBatt;
+            dbCalcuBatt >= 25.5 ? dbCalcuBatt = 25.5 : dbCalcuBatt;
 
-                stCanRxBuf.data[6] = (uint8_t)(dbCalcuBatt * 10);
+            stCanRxBuf.data[6] = (uint8_t)(dbCalcuBatt * 10);
 
-                CAN_Send_Msg(0x500, stCanRxBuf.data);
+            CAN_Send_Msg(0x500, stCanRxBuf.data);
 
-                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt] = false;
-            }
-            else
-            {}
-
-            // UART_PRINTF("Ad_Val = %d, dbCalcuBatt = %.3f\r\n", u16ReadAd, dbCalcuBatt);
+            ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt] = false;
         }
+        else
+        {}
+
+        // UART_PRINTF("Ad_Val = %d, dbCalcuBatt = %.3f\r\n", u16ReadAd, dbCalcuBatt);
     }
 }
 
 void Adc_vReadHw(void)
 {
     static uint8_t u8StepHw = 3;
+    static uint8_t u8TryHw  = 0;
 
-    uint8_t  u8ConfigArray[] = {0x01u, 0xe3, 0xc3};
     uint16_t u16ReadAd       = 0;
-    double   dbAdVol         = 0.0;
     uint8_t  au8UartTxData[] = {0x74, 0x32, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x32, 0x2e, 0x30, 0x2e, 0x30, 0x22, 0xff, 0xff, 0xff};
-    uint8_t  u8MinIndex      = 0;
-    float    aflVad[5]       = {3.3, 3, 2.24, 1.65, 1.1};
-    float    aflAbs[5]       = {0};
 
-    if (3 == u8StepHw)
+    if (Board_boReady())
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x49);
-        I2C_Enable(I2C0_ID);
-        u8StepHw = 2;
+        ProductLine_vJobDone(ProDWork_Read_AdHw); // 上电已识别，直接回复
     }
-    else if (2 == u8StepHw)
+    else if (!Adc_boConvert(ProD_I2c_Read_AdHw, 0xe3, &u8StepHw, &u16ReadAd))
     {
-        Ex_MstWriteDoubleByte(I2C0_ID, (uint8_t *)(u8ConfigArray));
-        u8StepHw = 1;
+        return;
     }
-    else if (1 == u8StepHw)
+    else if ((ADC_CODE_NONE == u16ReadAd) && (++u8TryHw < ADC_HW_TRY_MAX))
     {
-        uint8_t addr_ad = 0;
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&addr_ad));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_AdHw] = true;
-
-        u8StepHw = 0;
+        return; // 读取失败不能用来识别，下次调用重新转换
     }
-    else if (0 == u8StepHw)
+    else if (ADC_CODE_NONE == u16ReadAd)
     {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_AdHw])
-        {
-            u8StepHw = 3;
-
-            ProductLine_enCurWorkSts = ProDWork_Idle;
-
-            u16ReadAd = (ProductLine_stI2cRWMsgs.Read_t.au8Data[0] << 4u) | (ProductLine_stI2cRWMsgs.Read_t.au8Data[1] >> 4u);
-            dbAdVol   = (u16ReadAd * 4.096) / 0x7FF;
-
-            /*
-                R = (33 / V_ad) - 10                理论计算V_ad
-                R = 0;      Hw version = 1.0.0      3.3v
-                R = 1k;     Hw version = 1.1.0      3v
-                R = 4.7k;   Hw version = 1.2.0      2.24v
-                R = 10k;    Hw version = 1.3.0      1.65v
-                R = 20k;    Hw version = 1.4.0      1.1v
-            */
+        ProductLine_vJobDone(ProDWork_Read_AdHw);
+        Board_vIdentify(BOARD_STRAP_NONE); // 按未知版本锁定，保持默认地址
+    }
+    else
+    {
+        ProductLine_vJobDone(ProDWork_Read_AdHw);
+        Board_vIdentify((uint16_t)(((uint32_t)u16ReadAd * ADC_VREF_MV + ADC_CODE_FULL / 2u) / ADC_CODE_FULL));
+    }
 
-            for (uint8_t i = 0; i < 5; i++)
-            {
-                aflAbs[i] = ADC_ABS(dbAdVol, aflVad[i]);
-            }
+    au8UartTxData[10] = 0x30 + Board_pstGet()->u8Minor;
 
-            float flAbsMin = aflAbs[0];
+    Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
+}
 
-            for (uint8_t j = 0; j < 5; j++)
-            {
-                if (aflAbs[j] < flAbsMin)
-                {
-                    flAbsMin   = aflAbs[j]; // 更新最小值
-                    u8MinIndex = j;         // 更新最小ID
-                }
-            }
+bool Adc_boIdentifyHw(void) // 上电时序中LOCK之后调用，此时产线任务还未启动，直接执行读取步骤
+{
+#ifdef ADC_ONCHIP
+    Adc_vScanInit();
+#endif
 
-            switch (u8MinIndex)
-            {
-                case 0: // 1.0.0
-                    au8UartTxData[10] = 0x30;
-                    break;
-                case 1: // 1.1.0
-                    au8UartTxData[10] = 0x31;
-                    break;
-                case 2: // 1.2.0
-                    au8UartTxData[10] = 0x32;
-                    break;
-                case 3: // 1.3.0
-                    au8UartTxData[10] = 0x33;
-                    break;
-                case 4: // 1.4.0
-                    au8UartTxData[10] = 0x34;
-                    break;
-                default:
-                    break;
-            }
-            Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
-        }
+    if (!Board_boReady())
+    {
+        Adc_vReadHw();
     }
+    else
+    {}
+
+    return Board_boReady();
 }
 
 /**
- * @brief 二分查找电阻所在的基准段
- * @param res 输入电阻值（kΩ）
- * @param left 输出段左基准索引
- * @param right 输出段右基准索引
- * @return true：找到有效段，false：电阻超出范围
+ * @brief 根据电阻值计算温度（分段线性插值，整数运算）
+ * @param u32Res 输入电阻值（0.1Ω）
+ * @return 温度（0.1℃），超出表范围时按两端的段外推，结果限幅
  */
-static void Adc_vFindResSegment(float res, int *left, int *right, const Adc_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp)
+static int16_t Adc_s16ResToTemp(uint32_t u32Res, const Adc_stResTempRef astResTempRef[], uint8_t u8ArrSize)
 {
-    uint8_t u8ArrSize = 0;
+    uint8_t  u8Low  = 0;
+    uint8_t  u8High = u8ArrSize - 1;
+    uint8_t  u8Mid  = 0;
+    uint32_t u32Find = u32Res;
+    int32_t  s32Num, s32Den, s32Temp;
 
-    if (ADC_PCB_TEMP == enTempTyp)
+    if (u32Res > (astResTempRef[0].res + ADC_RES_EXT_MAX))
     {
-        u8ArrSize = 34;
+        u32Res = astResTempRef[0].res + ADC_RES_EXT_MAX; // 外推结果同样限幅为ADC_TEMP_MIN
     }
     else
-    {
-        u8ArrSize = 42;
-    }
+    {}
 
     // 电阻特性：温度升高，电阻减小（基准数据按温度升序，电阻降序）
-    if (res > astResTempRef[0].res)
+    if (u32Find > astResTempRef[0].res)
     {
-        res = astResTempRef[0].res;
+        u32Find = astResTempRef[0].res;
     }
-    else if (res < astResTempRef[u8ArrSize - 1].res)
+    else if (u32Find < astResTempRef[u8High].res)
     {
-        res = astResTempRef[u8ArrSize - 1].res;
+        u32Find = astResTempRef[u8High].res;
     }
     else
     {}
 
-    // 二分查找（O(log n)效率，比线性遍历快）
-    int low = 0, high = u8ArrSize - 1;
-    while (low + 1 < high)
+    while (u8Low + 1 < u8High)
     {
-        int mid = (low + high) / 2;
-        if (res > astResTempRef[mid].res)
+        u8Mid = (u8Low + u8High) / 2;
+
+        if (u32Find > astResTempRef[u8Mid].res)
         {
-            high = mid; // 电阻较大，对应温度较低，往左侧找
+            u8High = u8Mid; // 电阻较大，对应温度较低，往左侧找
         }
         else
         {
-            low = mid; // 电阻较小，对应温度较高，往右侧找
+            u8Low = u8Mid; // 电阻较小，对应温度较高，往右侧找
         }
     }
 
-    *left  = low;
-    *right = high;
+    // T = T1 + (R1 - R) * (T2 - T1) / (R1 - R2)，用未限幅的R计算，表外与原浮点算法一样线性外推
+    s32Num = ((int32_t)astResTempRef[u8Low].res - (int32_t)u32Res) * ((astResTempRef[u8High].temp - astResTempRef[u8Low].temp) * 10);
+    s32Den = (int32_t)(astResTempRef[u8Low].res - astResTempRef[u8High].res);
+
+    if (s32Num >= 0)
+    {
+        s32Temp = astResTempRef[u8Low].temp * 10 + (s32Num + s32Den / 2) / s32Den;
+    }
+    else
+    {
+        s32Temp = astResTempRef[u8Low].temp * 10 - (-s32Num + s32Den / 2) / s32Den;
+    }
+
+    if (s32Temp < ADC_TEMP_MIN)
+    {
+        s32Temp = ADC_TEMP_MIN; // 传感器开路
+    }
+    else if (s32Temp > ADC_TEMP_MAX)
+    {
+        s32Temp = ADC_TEMP_MAX; // 传感器短路
+    }
+    else
+    {}
+
+    return (int16_t)s32Temp;
 }
 
 /**
- * @brief 根据电阻值计算温度（分段线性插值）
- * @param res 输入电阻值（kΩ）
- * @return 计算出的温度（℃），无效返回INVALID_TEMP
+ * @brief 转换值逐点换算温度，温度表两端之外及生成温度表时调用
+ * @return 温度（0.1℃），分压电压不小于3.3V时返回0
  */
-static float Adc_flCalcTemperature(float res, const Adc_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp)
+static int16_t Adc_s16CodeToTemp(const Adc_stNtc *pstNtc, uint16_t u16Code)
 {
-    int left_idx, right_idx;
+    uint64_t u64Num;
+    uint32_t u32Den;
 
-    // 1. 查找电阻所在的基准段
-    Adc_vFindResSegment(res, &left_idx, &right_idx, astResTempRef, enTempTyp);
+    if (u16Code > ADC_CODE_VDIV) // 含负电压（bit11置位）
+    {
+        return 0; // 理论上采集的电压不可能大于3.3v
+    }
+    else
+    {}
 
-    // 2. 获取段内两个基准点的温度和电阻
-    const Adc_stResTempRef *left  = &astResTempRef[left_idx];
-    const Adc_stResTempRef *right = &astResTempRef[right_idx];
+    // V_ad / (3.3 - V_ad) = 4096 * code / (3300 * 0x7FF - 4096 * code)，kΩ换算为0.1Ω乘10000
+    u64Num = (uint64_t)pstNtc->u8ResK * 10000u * ADC_VREF_MV * u16Code;
+    u32Den = ADC_VDIV_MV * ADC_CODE_FULL - ADC_VREF_MV * u16Code;
 
-    // 3. 分段线性插值计算（T = T1 + (R - R1) * (T2 - T1)/(R2 - R1)）
-    // 避免除以零（基准数据保证R1 != R2）
-    float temp = left->temp + (res - left->res) * (right->temp - left->temp) / (right->res - left->res);
+    return Adc_s16ResToTemp((uint32_t)(u64Num / u32Den), pstNtc->pstRef, pstNtc->u8RefNum);
+}
+
+static void Adc_vBuildLut(Adc_stNtc *pstNtc)
+{
+    uint16_t u16Idx;
+
+    for (u16Idx = 0; u16Idx < ADC_LUT_NUM; u16Idx++)
+    {
+        pstNtc->as16Lut[u16Idx] = Adc_s16CodeToTemp(pstNtc, (uint16_t)(ADC_LUT_LO + (u16Idx << ADC_LUT_SHIFT)));
+    }
+}
+
+static int16_t Adc_s16NtcTemp(const Adc_stNtc *pstNtc, uint16_t u16Code) // 转换值 -> 温度（0.1℃），不使用浮点
+{
+    uint16_t u16Idx;
+    int32_t  s32Diff;
+
+    if ((u16Code < ADC_LUT_LO) || (u16Code >= ADC_LUT_HI))
+    {
+        return Adc_s16CodeToTemp(pstNtc, u16Code);
+    }
+    else
+    {}
+
+    u16Idx  = (u16Code - ADC_LUT_LO) >> ADC_LUT_SHIFT;
+    s32Diff = (pstNtc->as16Lut[u16Idx + 1] - pstNtc->as16Lut[u16Idx]) * (int32_t)(u16Code & ((1u << ADC_LUT_SHIFT) - 1u));
+
+    if (s32Diff >= 0)
+    {
+        s32Diff = (s32Diff + (1 << (ADC_LUT_SHIFT - 1))) >> ADC_LUT_SHIFT;
+    }
+    else
+    {
+        s32Diff = -((-s32Diff + (1 << (ADC_LUT_SHIFT - 1))) >> ADC_LUT_SHIFT);
+    }
 
-    return temp;
+    return (int16_t)(pstNtc->as16Lut[u16Idx] + s32Diff);
 }
 /*****************************************************************************
  * End file Adc.c
@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * @file AdcScan.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "AdcScan.h"
+#include "Config.h"
+
+#ifdef ADC_ONCHIP
+#include "Z20K11xM_adc.h"
+#include "Z20K11xM_tdg.h"
+#include "Z20K11xM_dma.h"
+#include "Z20K11xM_gpio.h"
+#include "Z20K11xM_clock.h"
+#include "Z20K11xM_sysctrl.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define ADCSCAN_RING_NUM (AdcScan_Num * ADCSCAN_AVG_NUM)
+#define ADCSCAN_CODE_MAX (0xFFFu)       // 12位转换结果
+#define ADCSCAN_EMPTY    (0xFFFFFFFFuL) // 通道号字段为31，与任何已配置通道都不匹配
+
+#define ADCSCAN_DMA_CH   (DMA_CHANNEL4) // DMA_CHANNEL0~3由I2cXfer使用
+#define ADCSCAN_DATA_OFS (0x20UL)       // ADC_DATA_RD
+
+/* TDG计数时钟40MHz/128 = 312.5kHz：每10ms触发一轮，轮内每个通道间隔约1ms */
+#define ADCSCAN_TDG_MOD (3125u)
+#define ADCSCAN_TDG_GAP (312u)
+
+#define ADCSCAN_SAMPLE_TIME (12u) // 采样时间，热敏电阻分压源阻抗较高，取较长值
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+typedef struct
+{
+    PORT_ID_t         enPort;
+    PORT_GPIONO_t     enPin;
+    PORT_PinMuxFunc_t enMux;
+    ADC_P_Channel_t   enAdcCh;
+} AdcScan_stChCfg;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+/* 占位配置：PTB0~PTB3/CH4~CH7尚未按原理图确认，打开ADC_ONCHIP前须按板上实际走线修改；
+ * 顺序与AdcScan_enCh一致，也是一轮内的转换顺序 */
+static const AdcScan_stChCfg AdcScan_astChCfg[AdcScan_Num] = {
+    {PORT_B, GPIO_0, PTB0_ADC0_CH4, ADC_P_CH4}, // AdcScan_LcdTemp
+    {PORT_B, GPIO_1, PTB1_ADC0_CH5, ADC_P_CH5}, // AdcScan_PcbTemp
+    {PORT_B, GPIO_2, PTB2_ADC0_CH6, ADC_P_CH6}, // AdcScan_Batt
+    {PORT_B, GPIO_3, PTB3_ADC0_CH7, ADC_P_CH7}, // AdcScan_Hw
+};
+
+static volatile uint32_t AdcScan_au32Ring[ADCSCAN_RING_NUM]; // DMA写入，结果中带通道号
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static void AdcScan_vAdcInit(void);
+static void AdcScan_vDmaInit(void);
+static void AdcScan_vTdgInit(void);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void AdcScan_vInit(void)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0; u8Idx < ADCSCAN_RING_NUM; u8Idx++)
+    {
+        AdcScan_au32Ring[u8Idx] = ADCSCAN_EMPTY;
+    }
+
+    for (u8Idx = 0; u8Idx < AdcScan_Num; u8Idx++)
+    {
+        PORT_PinmuxConfig(AdcScan_astChCfg[u8Idx].enPort, AdcScan_astChCfg[u8Idx].enPin, AdcScan_astChCfg[u8Idx].enMux);
+    }
+
+    AdcScan_vAdcInit();
+    AdcScan_vDmaInit();
+    AdcScan_vTdgInit(); // 最后启动触发
+}
+
+bool AdcScan_boGetMv(AdcScan_enCh enCh, uint16_t *pu16Mv)
+{
+    ADC_Conversion_Result_t unRes;
+    uint32_t                u32Sum = 0;
+    uint8_t                 u8Num  = 0;
+    uint8_t                 u8Idx;
+
+    if (enCh >= AdcScan_Num)
+    {
+        return false;
+    }
+    else
+    {}
+
+    for (u8Idx = 0; u8Idx < ADCSCAN_RING_NUM; u8Idx++)
+    {
+        unRes.adcResult = AdcScan_au32Ring[u8Idx]; // 32位读取是原子的，DMA同时写入也只会取到新值或旧值
+
+        if ((uint32_t)AdcScan_astChCfg[enCh].enAdcCh == unRes.bf.channel)
+        {
+            u32Sum += unRes.bf.data;
+            u8Num++;
+        }
+        else
+        {}
+    }
+
+    if (0u == u8Num)
+    {
+        return false;
+    }
+    else
+    {}
+
+    *pu16Mv = (uint16_t)((u32Sum * ADCSCAN_VREF_MV + (u8Num * ADCSCAN_CODE_MAX) / 2u) / (u8Num * ADCSCAN_CODE_MAX));
+
+    return true;
+}
+
+static void AdcScan_vAdcInit(void) // TDG映射模式：第i个延时输出触发CMDi，转换结果进FIFO后请求DMA
+{
+    const ADC_Config_t stCfg = {
+        .adcResolution     = ADC_RESOLUTION_12BIT,
+        .adcVrefSource     = ADC_VREF_INTERNAL,
+        .adcTriggerMode    = ADC_TDG_TRIGGER,
+        .adcConversionMode = ADC_CONVERSION_SINGLE,
+        .adcAvgsSelect     = ADC_AVGS_4, // 硬件4次平均，环形缓存再做多轮平均
+        .adcSampleTime     = ADCSCAN_SAMPLE_TIME,
+    };
+    const ADC_ChannelConfig_t stChCfg = {
+        .adcDifferentialMode = ADC_SINGLE_MODE,
+        .adcChannelP         = AdcScan_astChCfg[0].enAdcCh,
+        .adcChannelN         = ADC_N_NONE,
+    };
+    const ADC_TDGTriggerConfig_t stTrigCfg = {
+        .adcTDGTrigMode = ADC_MAPPING_MODE,
+        .adcCmd0        = AdcScan_astChCfg[AdcScan_LcdTemp].enAdcCh,
+        .adcCmd1        = AdcScan_astChCfg[AdcScan_PcbTemp].enAdcCh,
+        .adcCmd2        = AdcScan_astChCfg[AdcScan_Batt].enAdcCh,
+        .adcCmd3        = AdcScan_astChCfg[AdcScan_Hw].enAdcCh,
+        .adcCmd4        = AdcScan_astChCfg[AdcScan_Hw].enAdcCh, // 未使用
+        .adcCmd5        = AdcScan_astChCfg[AdcScan_Hw].enAdcCh,
+    };
+
+    CLK_ModuleSrc(CLK_ADC0, CLK_SRC_FIRC64M);
+    CLK_SetClkDivider(CLK_ADC0, CLK_DIV_4);
+    SYSCTRL_ResetModule(SYSCTRL_ADC0);
+    SYSCTRL_EnableModule(SYSCTRL_ADC0);
+
+    ADC_SoftwareReset(ADC0_ID);
+    ADC_Init(ADC0_ID, &stCfg);
+    ADC_ChannelConfig(ADC0_ID, &stChCfg);
+    ADC_TDGTriggerConfig(ADC0_ID, &stTrigCfg);
+    ADC_FifoWatermarkConfig(ADC0_ID, 0u); // FIFO中有1个结果即请求DMA
+    ADC_DmaRequestCmd(ADC0_ID, ENABLE);
+    ADC_Enable(ADC0_ID);
+}
+
+static void AdcScan_vDmaInit(void) // 主循环结束后自动回到缓存起点，不需要中断
+{
+    const DMA_TransferConfig_t stCfg = {
+        .channel                    = ADCSCAN_DMA_CH,
+        .channelPriority            = DMA_CHN_PRIORITY0, // 低于I2C读写
+        .channelPreempt             = DMA_NOSUSPEND_NOPREEMPT,
+        .source                     = DMA_REQ_ADC0,
+        .doneIntMask                = MASK,
+        .errorIntMask               = MASK,
+        .minorLoopNum               = ADCSCAN_RING_NUM,
+        .srcAddr                    = ADC0_BASE_ADDR + ADCSCAN_DATA_OFS,
+        .destAddr                   = (uint32_t)AdcScan_au32Ring,
+        .minorLoopSrcOffset         = 0,
+        .minorLoopDestOffset        = 4,
+        .majorLoopSrcOffset         = 0,
+        .majorLoopDestOffset        = -(int16_t)sizeof(AdcScan_au32Ring),
+        .transferByteNum            = 4u, // 每次请求搬运一个转换结果
+        .srcTransferSize            = DMA_TRANSFER_SIZE_4B,
+        .destTransferSize           = DMA_TRANSFER_SIZE_4B,
+        .disableRequestAfterDoneCmd = DISABLE,
+    };
+
+    SYSCTRL_EnableModule(SYSCTRL_DMA); // DMA控制器已由I2cXfer初始化，这里只占用一个通道
+    SYSCTRL_EnableModule(SYSCTRL_DMAMUX);
+
+    (void)DMA_ConfigTransfer(&stCfg);
+    DMA_ChannelRequestEnable(ADCSCAN_DMA_CH);
+}
+
+static void AdcScan_vTdgInit(void)
+{
+    const TDG_InitConfig_t stCfg = {
+        .modVal     = ADCSCAN_TDG_MOD,
+        .countMode  = TDG_COUNT_INFINITY,
+        .clkDivide  = TDG_CLK_DIVIDE_128,
+        .trigSource = TDG_TRIG_SW,
+        .updateMode = TDG_UPDATE_IMMEDIATELY,
+        .clearMode  = TDG_CLEAR_MODULATOR,
+    };
+    TDG_DelayOutputConfig_t astDo[AdcScan_Num];
+    TDG_ChannelConfig_t     stChCfg = {
+        .channelId   = TDG_CHANNEL_0,
+        .intDelayVal = 0u,
+        .doNum       = AdcScan_Num,
+        .doConfig    = astDo,
+    };
+    uint8_t u8Idx;
+
+    for (u8Idx = 0; u8Idx < AdcScan_Num; u8Idx++)
+    {
+        astDo[u8Idx].doId   = (TDG_DelayOutputId_t)u8Idx;
+        astDo[u8Idx].offset = (uint16_t)(ADCSCAN_TDG_GAP * (u8Idx + 1u));
+        astDo[u8Idx].cmd    = ENABLE;
+    }
+
+    CLK_ModuleSrc(CLK_TDG0, CLK_SRC_OSC40M);
+    CLK_SetClkDivider(CLK_TDG0, CLK_DIV_1);
+    SYSCTRL_ResetModule(SYSCTRL_TDG0);
+    SYSCTRL_EnableModule(SYSCTRL_TDG0);
+
+    TDG_InitConfig(TDG0_ID, &stCfg);
+    TDG_ChannelDelayOutputConfig(TDG0_ID, &stChCfg, ENABLE);
+    TDG_Enable(TDG0_ID, ENABLE);
+    (void)TDG_LoadCmd(TDG0_ID);
+    TDG_SoftwareTrig(TDG0_ID);
+}
+#endif
+/*****************************************************************************
+ * End file AdcScan.c
+ *****************************************************************************/
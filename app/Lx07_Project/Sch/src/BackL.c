@@ -21,11 +21,33 @@
 #include "uart.h"
 #include "Debounce.h"
 #include "can.h"
+#include "Thermal.h"
 /*****************************************************************************
  * Local macros
  *****************************************************************************/
 // #define BACKL_REG_MAX (0x3FFF - 3)
 #define BACKL_REG_MAX (0x2666) // 60%
+
+#define BACKL_PM_MAX   (1000u) // 亮度等级满量程（感知亮度，千分比），按键/CAN调节的都是该等级
+#define BACKL_KEY_STEP (100u)  // 按键每次调节10%
+#define BACKL_RAMP_MS  (300u)  // 从当前亮度渐变到新目标的时间，与变化量无关
+
+#define BACKL_CAN_NONE (0xFFFFu) // 没有待处理的CAN调光请求
+#define BACKL_REG_NONE (0xFFFFu) // 写入失败，芯片中的占空比未知
+
+#define BACKL_RAMP_FRAC (16u) // 渐变累加值的小数位数
+
+#define BACKL_GAMMA_SHIFT (5u)  // 伽马表每32个等级(1/1024)一项，项间线性插值
+#define BACKL_GAMMA_ONE   (15u) // 伽马表满量程 1 << 15
+
+/* M0+没有除法指令，百分比换算用预先算好的倒数乘移位，结果与四舍五入的除法在全量程内逐值一致 */
+#define BACKL_PM_SHIFT  (11u)
+#define BACKL_PM_RECIP  (205u)     // 2^11 / 10，千分比 -> 百分比，0~1005有效
+#define BACKL_DEC_SHIFT (10u)
+#define BACKL_DEC_RECIP (103u)     // 2^10 / 10，取十位，0~100有效
+#define BACKL_PMX_SHIFT (16u)
+#define BACKL_GAM_RECIP (67109uL)  // 1024 * 2^16 / BACKL_PM_MAX，千分比 -> 伽马表坐标
+#define BACKL_CAP_RECIP (644219uL) // BACKL_REG_MAX * 2^16 / THERMAL_PERMILLE，降额千分比 -> 寄存器值
 /*****************************************************************************
  * Local data types
  *****************************************************************************/
@@ -33,11 +55,35 @@
 /*****************************************************************************
  * Variant declarations
  *****************************************************************************/
-static uint16_t u16Level = BACKL_REG_MAX;
-static uint8_t  Level_H, Level_L = 0;
+/* 感知亮度 -> 占空比：(i / 32)^2.2 * 32768，调光时亮度变化在人眼看来均匀 */
+static const uint16_t BackL_au16Gamma[] = {
+    0,     16,    74,    179,   338,   552,   824,   1157,  1552,  2011,  2536,
+    3127,  3787,  4516,  5316,  6188,  7132,  8149,  9241,  10408, 11652, 12972,
+    14370, 15846, 17401, 19037, 20752, 22549, 24427, 26387, 28431, 30557, 32768,
+};
+
+static uint16_t BackL_u16TargetPm = BACKL_PM_MAX;  // 用户设置的亮度等级
+static uint16_t BackL_u16CurPm    = BACKL_PM_MAX;  // 渐变过程中的当前等级
+static uint16_t BackL_u16RampTick = 0;             // 渐变剩余周期数
+static int32_t  BackL_s32RampAcc  = 0;             // 渐变中的等级，BACKL_RAMP_FRAC位小数
+static int32_t  BackL_s32RampStep = 0;             // 每周期的等级变化量，开始渐变时计算一次
+static bool     BackL_boWrPend    = false;         // 写任务已提交未完成，期间不重复提交
+static bool     BackL_boShowPend  = false;         // 等级改变后，渐变结束且芯片已是最终占空比时刷新屏幕上的显示
+
+static volatile uint16_t BackL_u16CanPm = BACKL_CAN_NONE; // CAN中断中只记录请求，主循环中开始渐变
+static volatile uint16_t BackL_u16WrReg = BACKL_REG_MAX;  // 芯片中的占空比，与上电配置表一致；写入失败时在中断中置为BACKL_REG_NONE
+
+static uint16_t BackL_u16DeratePm = THERMAL_PERMILLE; // 温度降额上限，千分比，不改动用户设置的亮度等级
 /*****************************************************************************
  * Local function prototypes
  *****************************************************************************/
+static uint16_t BackL_u16OutLevel(void);
+static uint16_t BackL_u16Gamma(uint16_t u16Pm);
+static void     BackL_vSetTarget(uint16_t u16Pm);
+static void     BackL_vRamp(void);
+static uint8_t  BackL_u8PmToPct(uint16_t u16Pm);
+static void     BackL_vSendPct(uint8_t u8Pct);
+static void     BackL_vWriteDone(bool boOk);
 
 /*****************************************************************************
  * function definitions
@@ -48,30 +94,34 @@ void BackL_vInit(void)
     Debounce_vInit(&Debounce_StSw2, MAIN_TIME_MS(200)); // up bkl 10%
 }
 
-void BackL_vHandle(void)
+void BackL_vHandle(void) // 5ms，按键只改目标等级，渐变和写入在后台逐步完成
 {
+    uint16_t u16CanPm = BackL_u16CanPm;
+
     Debounce_vCheck(&Debounce_StSw1);
     Debounce_vCheck(&Debounce_StSw2);
 
-    if (Debounce_boGetValidStu(&Debounce_StSw1))
+    if (BACKL_CAN_NONE != u16CanPm)
     {
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl] = true;
+        BackL_u16CanPm = BACKL_CAN_NONE;
+        BackL_vSetTarget(u16CanPm);
+    }
+    else
+    {}
 
-        if (u16Level == 0)
+    if (Debounce_boGetValidStu(&Debounce_StSw1))
+    {
+        if (0 == BackL_u16TargetPm)
+        {
+            BackL_vSetTarget(BACKL_PM_MAX);
+        }
+        else if (BackL_u16TargetPm < BACKL_KEY_STEP)
         {
-            u16Level = BACKL_REG_MAX;
+            BackL_vSetTarget(0);
         }
         else
         {
-            if (u16Level < BACKL_REG_MAX / 10)
-            {
-                u16Level = 0;
-            }
-            else
-            {
-                u16Level -= (BACKL_REG_MAX / 10);
-            }
+            BackL_vSetTarget(BackL_u16TargetPm - BACKL_KEY_STEP);
         }
     }
     else
@@ -79,202 +129,173 @@ void BackL_vHandle(void)
 
     if (Debounce_boGetValidStu(&Debounce_StSw2))
     {
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl] = true;
-
-        if (u16Level >= BACKL_REG_MAX)
+        if (BackL_u16TargetPm >= BACKL_PM_MAX)
+        {
+            BackL_vSetTarget(0);
+        }
+        else if (BackL_u16TargetPm + BACKL_KEY_STEP >= BACKL_PM_MAX)
         {
-            u16Level = 0;
+            BackL_vSetTarget(BACKL_PM_MAX);
         }
         else
         {
-            u16Level += (BACKL_REG_MAX / 10);
-
-            if (u16Level >= BACKL_REG_MAX)
-            {
-                u16Level = BACKL_REG_MAX;
-            }
-            else
-            {}
+            BackL_vSetTarget(BackL_u16TargetPm + BACKL_KEY_STEP);
         }
     }
     else
     {}
-}
-
-void BackL_vReadLevel(void)
-{
-    static uint8_t u8StepReadBkl = 5;
-    static uint8_t u8BklLel_H, u8BklLel_L = 0;
 
-    uint16_t u16BklAddr, u16BklRegVal = 0;
-    float    flPercent = 0.0;
-    uint8_t  u8Percnet = 0;
+    BackL_vRamp();
 
-    uint8_t au8UartTxData[] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
-
-    if (5 == u8StepReadBkl)
+    if (!BackL_boWrPend && (BackL_u16OutLevel() != BackL_u16WrReg))
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, DEV_BKL);
-        I2C_Enable(I2C0_ID);
-
-        u8StepReadBkl = 4;
+        BackL_boWrPend = ProductLine_boPost(ProDWork_Write_Bkl, NULL); // 写入时取最新的输出值，总线忙时自然跳过中间值
     }
-    else if (4 == u8StepReadBkl)
+    else if (!BackL_boWrPend && BackL_boShowPend && (0 == BackL_u16RampTick)) // 占空比可能在渐变结束前就已到达最终值
     {
-        u16BklAddr = 0x0005; // addr_h
-        Ex_MstReadBuffersss(I2C0_ID, (uint8_t *)(&u16BklAddr));
+        BackL_boShowPend = false;
+        BackL_vSendPct(BackL_u8PmToPct(BackL_u16CurPm));
+    }
+    else
+    {}
+}
 
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Bkl] = true;
+void BackL_vReadLevel(void) // 回复用户设置的亮度等级：与按键/CAN调节的百分比同为感知亮度，芯片中的是伽马换算后的占空比
+{
+    ProductLine_vJobDone(ProDWork_Read_Bkl);
 
-        u8StepReadBkl = 3;
-    }
-    else if (3 == u8StepReadBkl)
-    {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Bkl])
-        {
-            u8BklLel_H = ProductLine_stI2cRWMsgs.Read_t.au8Data[0];
+    BackL_vSendPct(BackL_u8PmToPct(BackL_u16TargetPm));
+}
 
-            u8StepReadBkl = 2;
-        }
-        else
-        {}
-    }
-    else if (2 == u8StepReadBkl)
-    {
-        u16BklAddr = 0x0006; // addr_l
-        Ex_MstReadBuffersss(I2C0_ID, (uint8_t *)(&u16BklAddr));
+void BackL_vWriteLevel(void)
+{
+    uint16_t u16Out   = BackL_u16OutLevel();
+    uint8_t  au8Wr[3] = {0x05, (uint8_t)(u16Out >> 8u), (uint8_t)u16Out}; // IN_I2CDIM_H/L地址连续，一次自增写
 
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Bkl] = true;
+    BackL_u16WrReg = u16Out; // 提交前记录，完成回调可能先于下一行执行
 
-        u8StepReadBkl = 1;
-    }
-    else if (1 == u8StepReadBkl)
+    if (!ProductLine_boI2cWriteCb(DEV_BKL, au8Wr, sizeof(au8Wr), BackL_vWriteDone))
     {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Bkl])
-        {
-            u8BklLel_L = ProductLine_stI2cRWMsgs.Read_t.au8Data[0];
-
-            u8StepReadBkl            = 5;
-            ProductLine_enCurWorkSts = ProDWork_Idle;
-
-            u16BklRegVal = (u8BklLel_H << 8u) | u8BklLel_L;
-            flPercent    = u16BklRegVal * 1.0 / BACKL_REG_MAX;
-            u8Percnet    = (flPercent + 0.005) * 100;
-
-            if (u8Percnet == 100)
-            {
-                au8UartTxData[7] = 0x30 + u8Percnet / 100;
-                au8UartTxData[8] = 0x30 + (u8Percnet % 100) / 10;
-                au8UartTxData[9] = 0x30 + u8Percnet % 10;
-            }
-            else
-            {
-                au8UartTxData[7] = 0x30;
-                au8UartTxData[8] = 0x30 + u8Percnet / 10;
-                au8UartTxData[9] = 0x30 + u8Percnet % 10;
-            }
-
-            Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
-        }
-        else
-        {}
+        BackL_u16WrReg = BACKL_REG_NONE; // 未能提交，下个周期重试
+        return;
     }
     else
     {}
+
+    ProductLine_vJobDone(ProDWork_Write_Bkl);
+    BackL_boWrPend = false;
 }
 
-void BackL_vWriteLevel(void)
+static void BackL_vWriteDone(bool boOk) // I2C中断中执行
 {
-    uint8_t u8Addr_H, u8Addr_L, u8BklPercent = 0;
-
-    uint8_t au8Uart0TxBkl[] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
-
-    static uint8_t u8StepWBkl = 2;
-
-    if (2 == u8StepWBkl)
+    if (!boOk)
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, DEV_BKL);
-        I2C_Enable(I2C0_ID);
+        BackL_u16WrReg = BACKL_REG_NONE; // 芯片仍是原占空比，BackL_vHandle重新提交
+    }
+    else
+    {}
+}
 
-        u8StepWBkl = 1;
+void BackL_vWriteLevFromCan(uint8_t u8Percent) // CAN中断调用
+{
+    if (u8Percent > 100)
+    {
+        /*Invalid value*/
     }
-    else if (1 == u8StepWBkl)
+    else
     {
-        Level_L = u16Level;
-        Level_H = u16Level >> 8u;
+        BackL_u16CanPm = (uint16_t)u8Percent * 10u;
+    }
+}
 
-        u8Addr_H = 0x05;
-        Lx07_MstWriteByte(I2C0_ID, (uint8_t *)&u8Addr_H, (uint8_t *)&Level_H);
-        u8Addr_L = 0x06;
-        Lx07_MstWriteByte(I2C0_ID, (uint8_t *)&u8Addr_L, (uint8_t *)&Level_L);
+void BackL_vSetDerate(uint16_t u16Permille) // 输出值变化后由BackL_vHandle提交写入
+{
+    BackL_u16DeratePm = (u16Permille > THERMAL_PERMILLE) ? THERMAL_PERMILLE : u16Permille;
+}
 
-        ProductLine_enCurWorkSts = ProDWork_Idle;
-        u8StepWBkl               = 2;
+static uint16_t BackL_u16OutLevel(void) // 当前等级经伽马换算后与降额上限取小
+{
+    uint16_t u16Reg = BackL_u16Gamma(BackL_u16CurPm);
+    uint16_t u16Cap = (uint16_t)(((uint32_t)BackL_u16DeratePm * BACKL_CAP_RECIP) >> BACKL_PMX_SHIFT);
 
-        float Percent = u16Level * 1.0 / BACKL_REG_MAX;
+    return (u16Reg < u16Cap) ? u16Reg : u16Cap;
+}
 
-        // UART_PRINTF("PercentLevel = %.2f\r\n", Percent);
+static uint16_t BackL_u16Gamma(uint16_t u16Pm) // 亮度等级 -> 占空比寄存器值
+{
+    uint32_t u32X    = ((uint32_t)u16Pm * BACKL_GAM_RECIP) >> BACKL_PMX_SHIFT; // 0~1024
+    uint32_t u32Idx  = u32X >> BACKL_GAMMA_SHIFT;
+    uint32_t u32Frac = u32X & ((1u << BACKL_GAMMA_SHIFT) - 1u);
+    uint32_t u32Val;
+    uint16_t u16Reg;
+
+    if (u32Idx >= (sizeof(BackL_au16Gamma) / sizeof(BackL_au16Gamma[0]) - 1u))
+    {
+        u32Val = BackL_au16Gamma[sizeof(BackL_au16Gamma) / sizeof(BackL_au16Gamma[0]) - 1u];
+    }
+    else
+    {
+        u32Val = BackL_au16Gamma[u32Idx] + (((BackL_au16Gamma[u32Idx + 1u] - BackL_au16Gamma[u32Idx]) * u32Frac) >> BACKL_GAMMA_SHIFT);
+    }
 
-        u8BklPercent = (Percent + 0.005) * 100;
+    u16Reg = (uint16_t)((u32Val * BACKL_REG_MAX + (1u << (BACKL_GAMMA_ONE - 1u))) >> BACKL_GAMMA_ONE);
 
-        if (u8BklPercent == 100)
-        {
-            au8Uart0TxBkl[7] = 0x30 + u8BklPercent / 100;
-            au8Uart0TxBkl[8] = 0x30 + (u8BklPercent % 100) / 10;
-            au8Uart0TxBkl[9] = 0x30 + u8BklPercent % 10;
-        }
-        else
-        {
-            au8Uart0TxBkl[7] = 0x30;
-            au8Uart0TxBkl[8] = 0x30 + u8BklPercent / 10;
-            au8Uart0TxBkl[9] = 0x30 + u8BklPercent % 10;
-        }
+    return ((0u != u16Pm) && (0u == u16Reg)) ? 1u : u16Reg; // 非0等级不能熄灭
+}
 
-        Uart_Transmit(au8Uart0TxBkl, sizeof(au8Uart0TxBkl));
+static void BackL_vSetTarget(uint16_t u16Pm) // 从当前位置重新开始渐变
+{
+    if (u16Pm == BackL_u16TargetPm)
+    {
+        return;
     }
+    else
+    {}
+
+    BackL_u16TargetPm = u16Pm;
+    BackL_u16RampTick = MAIN_TIME_MS(BACKL_RAMP_MS);
+    BackL_s32RampAcc  = (int32_t)BackL_u16CurPm << BACKL_RAMP_FRAC;
+    BackL_s32RampStep = ((int32_t)u16Pm - BackL_u16CurPm) * ((int32_t)1 << BACKL_RAMP_FRAC) / (int32_t)MAIN_TIME_MS(BACKL_RAMP_MS); // 每次渐变只除一次，有符号除法
+    BackL_boShowPend  = true;
 }
 
-void BackL_vWriteLevFromCan(uint8_t u8Percent)
+static void BackL_vRamp(void) // 感知亮度上线性插值，最后一个周期直接到达目标，消除步长的截断误差
 {
-    if (u8Percent > 100)
+    if (BackL_u16RampTick > 1u)
     {
-        /*Invalid value*/
+        BackL_u16RampTick--;
+        BackL_s32RampAcc += BackL_s32RampStep;
+        BackL_u16CurPm    = (uint16_t)((BackL_s32RampAcc + ((int32_t)1 << (BACKL_RAMP_FRAC - 1u))) >> BACKL_RAMP_FRAC);
     }
     else
     {
-        u16Level = BACKL_REG_MAX * 1.0 / 100 * u8Percent;
+        BackL_u16RampTick = 0;
+        BackL_u16CurPm    = BackL_u16TargetPm;
     }
 }
 
-void BackL_vDireating(uint8_t u8Temp)
+static uint8_t BackL_u8PmToPct(uint16_t u16Pm) // 四舍五入
 {
-    float flBklPercent = 0;
+    return (uint8_t)(((uint32_t)(u16Pm + 5u) * BACKL_PM_RECIP) >> BACKL_PM_SHIFT);
+}
 
-    if (u8Temp < 65)
-    {
-        // LCD最大亮度可以是100%，不做处理
-    }
-    else if (u8Temp > 85)
+static void BackL_vSendPct(uint8_t u8Pct) // 屏幕n2控件：n2.val=xxx，固定3位
+{
+    uint8_t au8UartTx[] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x30, 0x30, 0x30, 0xFF, 0xFF, 0xFF};
+    uint8_t u8Tens;
+
+    if (u8Pct >= 100u)
     {
-        // 10%
-        flBklPercent = 10;
-        if (u16Level > (BACKL_REG_MAX * 1.0 / 100 * flBklPercent))
-            u16Level = BACKL_REG_MAX * 1.0 / 100 * flBklPercent;
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl] = true;
+        au8UartTx[7] = 0x31; // 100
     }
     else
     {
-        flBklPercent = 392.5 - 4.5 * u8Temp;
-
-        if (u16Level > (BACKL_REG_MAX * 1.0 / 100 * flBklPercent))
-            u16Level = BACKL_REG_MAX * 1.0 / 100 * flBklPercent;
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl] = true;
+        u8Tens       = (uint8_t)(((uint16_t)u8Pct * BACKL_DEC_RECIP) >> BACKL_DEC_SHIFT);
+        au8UartTx[8] = 0x30 + u8Tens;
+        au8UartTx[9] = 0x30 + (u8Pct - u8Tens * 10u);
     }
+
+    Uart_Transmit(au8UartTx, sizeof(au8UartTx));
 }
 /*****************************************************************************
  * End file BackL.c
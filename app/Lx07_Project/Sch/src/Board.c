@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * @file Board.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "Board.h"
+#include "Config.h"
+#include "I2cXfer.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define BOARD_STRAP_1_0 (3300u) // 各版本硬件版本电阻分压的标称电压，mV
+#define BOARD_STRAP_1_1 (3000u)
+#define BOARD_STRAP_1_2 (2240u)
+#define BOARD_STRAP_1_3 (1650u)
+#define BOARD_STRAP_1_4 (1100u)
+
+#define BOARD_STRAP_HI (BOARD_STRAP_1_0 + (BOARD_STRAP_1_0 - BOARD_STRAP_1_1) / 2u) // 各版本范围的上下限，两端各留半个间隔
+#define BOARD_STRAP_LO (BOARD_STRAP_1_4 - (BOARD_STRAP_1_3 - BOARD_STRAP_1_4) / 2u)
+
+#define BOARD_MID(a, b) (((a) + (b)) / 2u)
+
+#define BOARD_DEFAULT (Board_Rev_1_0) // 识别前使用的版本
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+/* 按电压降序排列，第一个不低于下限的即为该版本；
+ * 各版本解串器/背光芯片的实际地址在此处配置，寄存器表不用改动
+ * （改用0x4C/0x3A地址的硬件确定分压电阻后在此增加版本） */
+static const Board_stDesc Board_astDesc[Board_Rev_Num] = {
+    {Board_Rev_1_0, 0u, BOARD_MID(BOARD_STRAP_1_0, BOARD_STRAP_1_1), DEV_DES, DEV_BKL},
+    {Board_Rev_1_1, 1u, BOARD_MID(BOARD_STRAP_1_1, BOARD_STRAP_1_2), DEV_DES, DEV_BKL},
+    {Board_Rev_1_2, 2u, BOARD_MID(BOARD_STRAP_1_2, BOARD_STRAP_1_3), DEV_DES, DEV_BKL},
+    {Board_Rev_1_3, 3u, BOARD_MID(BOARD_STRAP_1_3, BOARD_STRAP_1_4), DEV_DES, DEV_BKL},
+    {Board_Rev_1_4, 4u, BOARD_STRAP_LO, DEV_DES, DEV_BKL},
+};
+
+static const Board_stDesc *Board_pstDesc  = &Board_astDesc[BOARD_DEFAULT];
+static bool                Board_boLocked = false;
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void Board_vIdentify(uint16_t u16StrapMv)
+{
+    uint8_t u8Idx;
+
+    if (Board_boLocked)
+    {
+        return;
+    }
+    else
+    {}
+
+    u8Idx = Board_Rev_Num;
+
+    if (u16StrapMv <= BOARD_STRAP_HI)
+    {
+        for (u8Idx = 0; (u8Idx < Board_Rev_Num) && (u16StrapMv < Board_astDesc[u8Idx].u16MinMv); u8Idx++)
+        {}
+    }
+    else
+    {}
+
+    Board_pstDesc  = (u8Idx < Board_Rev_Num) ? &Board_astDesc[u8Idx] : &Board_astDesc[BOARD_DEFAULT]; // 未知版本保持默认地址
+    Board_boLocked = true;
+
+    I2cXfer_vForgetTarget(); // 控制器可能仍指向默认版本的地址
+}
+
+bool Board_boReady(void)
+{
+    return Board_boLocked;
+}
+
+const Board_stDesc *Board_pstGet(void)
+{
+    return Board_pstDesc;
+}
+
+uint8_t Board_u8BusAddr(uint8_t u8Dev)
+{
+    if (DEV_DES == u8Dev)
+    {
+        return Board_pstDesc->u8DesAddr;
+    }
+    else if (DEV_BKL == u8Dev)
+    {
+        return Board_pstDesc->u8BklAddr;
+    }
+    else
+    {
+        return u8Dev;
+    }
+}
+/*****************************************************************************
+ * End file Board.c
+ *****************************************************************************/
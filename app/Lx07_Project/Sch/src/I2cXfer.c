@@ -0,0 +1,980 @@
+/*****************************************************************************
+ * @file I2cXfer.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "I2cXfer.h"
+#include "i2c.h"
+#include "Config.h"
+#include "RegCache.h"
+#include "Board.h"
+#include "IrqLock.h"
+#include "Z20K11xM_dma.h"
+#include "Z20K11xM_clock.h"
+#include "Z20K11xM_sysctrl.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define I2CXFER_RX_INFLIGHT_MAX (4u) // 已发出但未取走的读命令上限，防止RX FIFO溢出
+
+#define I2CXFER_TARGET_NONE (0xFFu) // 目标地址未知，下次传输必须重新设置
+
+#define I2CXFER_DEV_NUM   (sizeof(I2cXfer_astDevCfg) / sizeof(I2cXfer_astDevCfg[0]))
+#define I2CXFER_NACK_MASK ((1uL << (uint32_t)ERR_7BIT_ADDR_NO_ACK) | (1uL << (uint32_t)ERR_DATA_NO_ACK))
+
+#define I2CXFER_DMA_TX_LVL (2u)     // TX FIFO不多于2个时请求DMA
+#define I2CXFER_DMA_RX_LVL (0u)     // RX FIFO有1个数据即请求DMA
+#define I2CXFER_DATA_OFS   (0x20UL) // I2C_COMMAND_DATA
+
+#ifdef I2CXFER_I2C1_TP_ADC
+#define I2CXFER_TP_ADC_BUS (I2C1_ID)
+#else
+#define I2CXFER_TP_ADC_BUS (I2C0_ID)
+#endif
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+typedef struct
+{
+    uint8_t     u8DevAddr;
+    I2C_Id_t    enBus;
+    I2C_Speed_t enSpeed;
+} I2cXfer_stDevCfg;
+
+typedef struct
+{
+    uint16_t u16HCnt; // 由I2c_vSetScl写入控制器
+    uint16_t u16LCnt;
+    uint8_t  u8SpkLen; // 与Z20K11xM_i2c.c中各速率的设置一致
+} I2cXfer_stSclCnt;
+
+typedef struct
+{
+    DMA_Channel_t       enTxCh;
+    DMA_Channel_t       enRxCh;
+    DMA_RequestSource_t enTxReq;
+    DMA_RequestSource_t enRxReq;
+    uint32_t            u32DataReg;
+} I2cXfer_stDmaCfg;
+
+typedef struct // 每个控制器一份，队列和状态互不影响
+{
+    I2C_Id_t                enId;
+    const I2cXfer_stDmaCfg *pstDma;
+
+    I2cXfer_stDesc *apstQueue[I2CXFER_QUEUE_SIZE];
+    uint8_t         u8Head;
+    uint8_t         u8Count;
+
+    I2cXfer_stDesc *volatile pstCur;      // 当前在总线上的事务
+    uint8_t                  u8CmdIdx;    // 已写入TX FIFO的命令数(写字节+读命令)
+    uint8_t                  u8RxIdx;     // 已取走的读数据个数
+    bool                     boAbort;
+    uint8_t                  u8Target;    // 控制器当前的目标地址
+    I2C_Speed_t              enSpeed;     // 控制器当前的速率，I2c_Init按标准速率初始化
+    uint8_t                  u8StallTick; // 总线无进展的5ms周期数
+    bool                     boRecover;   // 正在用GPIO恢复总线，期间不启动新事务
+
+    volatile bool boDmaTxEnd;
+    volatile bool boDmaRxEnd;
+
+    uint32_t u32BusyUs; // 当前统计窗口内按时间模型累计的总线占用
+    uint8_t  u8Load;    // 上一个窗口的总线占用率%
+} I2cXfer_stBus;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+/* 未列出的器件走I2C0、按标准速率访问 */
+static const I2cXfer_stDevCfg I2cXfer_astDevCfg[] = {
+    {DEV_SER, I2C0_ID, I2C_SPEED_FAST_PLUS}, // 板上串行器，走线短；总线上拉不足时改为I2C_SPEED_FAST
+    {DEV_DES, I2C0_ID, I2C_SPEED_FAST},      // 经链路透传的远端解串器
+    {DEV_BKL, I2C0_ID, I2C_SPEED_FAST},
+    {DEV_TP, I2CXFER_TP_ADC_BUS, I2C_SPEED_FAST},
+    {DEV_ADC, I2CXFER_TP_ADC_BUS, I2C_SPEED_FAST},
+    {DEV_EEP, I2C0_ID, I2C_SPEED_FAST},
+};
+
+/* 按I2CXFER_CLK_KHZ计算：高电平 = HCNT + SPKLEN + 7，低电平 = LCNT + 1 个功能时钟（不计上升沿时间）；
+ * 标准/FM+与SDK的固定计数相同，SDK的FS计数（0x28/0x2F）按20MHz只有208kHz，这里重新计算 */
+static const I2cXfer_stSclCnt I2cXfer_astSclCnt[] = {
+    {0xC0u, 0xC7u, 1u}, // I2C_SPEED_STANDARD
+    {16u, 25u, 1u},     // I2C_SPEED_FAST：低电平26个时钟1.3us，高电平24个时钟1.2us，共50个时钟400kHz
+    {0x09u, 0x11u, 2u}, // I2C_SPEED_FAST_PLUS
+};
+
+static const I2cXfer_stDmaCfg I2cXfer_astDmaCfg[I2CXFER_BUS_NUM] = {
+    {DMA_CHANNEL0, DMA_CHANNEL1, DMA_REQ_I2C0_TX, DMA_REQ_I2C0_RX, I2C0_BASE_ADDR + I2CXFER_DATA_OFS},
+    {DMA_CHANNEL2, DMA_CHANNEL3, DMA_REQ_I2C1_TX, DMA_REQ_I2C1_RX, I2C1_BASE_ADDR + I2CXFER_DATA_OFS},
+};
+
+static I2cXfer_stBus I2cXfer_astBus[I2CXFER_BUS_NUM] = {
+    {.enId = I2C0_ID, .pstDma = &I2cXfer_astDmaCfg[0], .u8Target = I2CXFER_TARGET_NONE, .enSpeed = I2C_SPEED_STANDARD},
+    {.enId = I2C1_ID, .pstDma = &I2cXfer_astDmaCfg[1], .u8Target = I2CXFER_TARGET_NONE, .enSpeed = I2C_SPEED_STANDARD},
+};
+
+static I2cXfer_stErrCnt I2cXfer_astErrCnt[I2CXFER_DEV_NUM + 1u]; // 最后一项为表外器件
+static uint16_t         I2cXfer_u16Recover  = 0u;                // 总线恢复次数
+static uint16_t         I2cXfer_u16LoadTick = 0u;                // 占用率统计窗口计时
+
+static bool I2cXfer_boDmaInit = false;
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static void     I2cXfer_vStartNext(I2cXfer_stBus *pstBus);
+static void     I2cXfer_vFinish(I2cXfer_stBus *pstBus, I2cXfer_enSts enSts);
+static void     I2cXfer_vComplete(I2cXfer_stDesc *pstDesc, I2cXfer_enSts enSts);
+static bool     I2cXfer_boCanRetry(const I2cXfer_stBus *pstBus, const I2cXfer_stDesc *pstDesc);
+static void     I2cXfer_vRequeue(I2cXfer_stBus *pstBus, I2cXfer_stDesc *pstDesc);
+static void     I2cXfer_vRetryOrFail(I2cXfer_stBus *pstBus);
+static void     I2cXfer_vRecover(I2cXfer_stBus *pstBus, I2cXfer_stDesc *pstDesc);
+static uint8_t  I2cXfer_u8DevIdx(uint8_t u8DevAddr);
+static uint32_t I2cXfer_u32DescUs(const I2cXfer_stDesc *pstDesc, I2C_Speed_t enSpeed);
+static void     I2cXfer_vDmaInit(void);
+static void     I2cXfer_vDmaStart(I2cXfer_stBus *pstBus, const I2cXfer_stDesc *pstDesc);
+static void     I2cXfer_vDmaStop(const I2cXfer_stBus *pstBus);
+static bool     I2cXfer_boDmaEnd(const I2cXfer_stBus *pstBus);
+static void     I2cXfer_vRetarget(I2cXfer_stBus *pstBus, uint8_t u8DevAddr);
+static const I2cXfer_stSclCnt *I2cXfer_pstSclCnt(I2C_Speed_t enSpeed);
+static void     I2cXfer_vDmaRxDone(I2cXfer_stBus *pstBus);
+static void     I2cXfer_vDma0TxDone(void);
+static void     I2cXfer_vDma0RxDone(void);
+static void     I2cXfer_vDma1TxDone(void);
+static void     I2cXfer_vDma1RxDone(void);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void I2cXfer_vInit(void) // I2c_Init使能并配置两个控制器后调用，未完成的事务全部以错误结束
+{
+    uint32_t       u32PriMask;
+    uint8_t        u8Bus;
+    I2cXfer_stBus *pstBus;
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    I2cXfer_vDmaInit();
+
+    for (u8Bus = 0u; u8Bus < I2CXFER_BUS_NUM; u8Bus++)
+    {
+        pstBus = &I2cXfer_astBus[u8Bus];
+
+        I2C_IntCmd(pstBus->enId, I2C_INT_TX_EMPTY, DISABLE);
+        pstBus->u8Target  = I2CXFER_TARGET_NONE; // 控制器将被复位
+        pstBus->enSpeed   = I2C_SPEED_STANDARD;
+        pstBus->boRecover = false;
+
+        if (NULL != pstBus->pstCur)
+        {
+            I2cXfer_vFinish(pstBus, I2cXfer_Error);
+        }
+        else
+        {}
+
+        while (pstBus->u8Count > 0u)
+        {
+            I2cXfer_stDesc *pstDesc = pstBus->apstQueue[pstBus->u8Head];
+
+            pstBus->u8Head = (uint8_t)((pstBus->u8Head + 1u) % I2CXFER_QUEUE_SIZE);
+            pstBus->u8Count--;
+
+            I2cXfer_vComplete(pstDesc, I2cXfer_Error);
+        }
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+bool I2cXfer_boSubmit(I2cXfer_stDesc *pstDesc) // 非阻塞提交，按器件路由到对应总线的队列，队列满或描述符未完成时返回false
+{
+    uint32_t       u32PriMask;
+    bool           boRet = false;
+    I2cXfer_stBus *pstBus;
+
+    if ((NULL == pstDesc) || I2cXfer_boBusy(pstDesc))
+    {
+        return false;
+    }
+    else if ((NULL != pstDesc->pu16Cmd) ? (0u == pstDesc->u16CmdLen) : ((0u == pstDesc->u8TxLen) && (0u == pstDesc->u8RxLen)))
+    {
+        return false;
+    }
+    else
+    {}
+
+    pstBus = &I2cXfer_astBus[I2cXfer_enDevBus(pstDesc->u8DevAddr)];
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    if (pstBus->u8Count < I2CXFER_QUEUE_SIZE)
+    {
+        pstDesc->enSts     = I2cXfer_Queued;
+        pstDesc->u32ErrSrc = 0u;
+        pstDesc->u8Try     = 0u;
+
+        pstBus->apstQueue[(pstBus->u8Head + pstBus->u8Count) % I2CXFER_QUEUE_SIZE] = pstDesc;
+        pstBus->u8Count++;
+
+        I2cXfer_vStartNext(pstBus);
+        boRet = true;
+    }
+    else
+    {}
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    return boRet;
+}
+
+bool I2cXfer_boBusy(const I2cXfer_stDesc *pstDesc)
+{
+    return (I2cXfer_Queued == pstDesc->enSts) || (I2cXfer_Active == pstDesc->enSts);
+}
+
+static void I2cXfer_vStartNext(I2cXfer_stBus *pstBus) // 关中断或在I2C中断中调用
+{
+    I2cXfer_stDesc *pstDesc;
+
+    if ((NULL != pstBus->pstCur) || (0u == pstBus->u8Count) || pstBus->boRecover)
+    {
+        return;
+    }
+    else
+    {}
+
+    // 旧的阻塞接口还有数据在发送，等它的STOP中断再启动
+    if ((SET == I2C_GetStatus(pstBus->enId, I2C_MST_ACTIVITY)) || (RESET == I2C_GetStatus(pstBus->enId, I2C_STATUS_TFE)))
+    {
+        return;
+    }
+    else
+    {}
+
+    pstDesc        = pstBus->apstQueue[pstBus->u8Head];
+    pstBus->u8Head = (uint8_t)((pstBus->u8Head + 1u) % I2CXFER_QUEUE_SIZE);
+    pstBus->u8Count--;
+
+    pstBus->pstCur      = pstDesc;
+    pstBus->u8CmdIdx    = 0u;
+    pstBus->u8RxIdx     = 0u;
+    pstBus->boAbort     = false;
+    pstBus->u8StallTick = 0u;
+    pstDesc->enSts      = I2cXfer_Active;
+
+    if (I2C0_ID == pstBus->enId)
+    {
+        boI2c0IsIdle = false;
+    }
+    else
+    {}
+
+    if (pstDesc->u8DevAddr != pstBus->u8Target) // 目标地址只能在控制器禁止时修改，地址不变时省去
+    {
+        I2cXfer_vRetarget(pstBus, pstDesc->u8DevAddr);
+    }
+    else
+    {}
+
+    pstBus->u32BusyUs += I2cXfer_u32DescUs(pstDesc, pstBus->enSpeed);
+
+    if (NULL != pstDesc->pu16Cmd)
+    {
+        I2cXfer_vDmaStart(pstBus, pstDesc);
+    }
+    else
+    {
+        // TX FIFO为空，打开后立即进入中断开始填充
+        I2C_IntCmd(pstBus->enId, I2C_INT_TX_EMPTY, ENABLE);
+    }
+}
+
+static void I2cXfer_vFinish(I2cXfer_stBus *pstBus, I2cXfer_enSts enSts)
+{
+    I2cXfer_stDesc *pstDesc = pstBus->pstCur;
+
+    if (NULL != pstDesc->pu16Cmd)
+    {
+        I2cXfer_vDmaStop(pstBus);
+    }
+    else
+    {}
+
+    pstBus->pstCur      = NULL;
+    pstBus->u8StallTick = 0u;
+
+    I2cXfer_vComplete(pstDesc, enSts);
+}
+
+static void I2cXfer_vComplete(I2cXfer_stDesc *pstDesc, I2cXfer_enSts enSts) // 描述符已脱离总线：置结果、通知影子寄存器并回调
+{
+    pstDesc->enSts = enSts;
+
+    if (0u == pstDesc->u8RxLen)
+    {
+        RegCache_vDone(pstDesc->u8DevAddr, (I2cXfer_Done == enSts)); // 写事务结束，确认或丢弃影子寄存器
+    }
+    else
+    {}
+
+    if (NULL != pstDesc->pfDone)
+    {
+        pstDesc->pfDone(pstDesc);
+    }
+    else
+    {}
+}
+
+static bool I2cXfer_boCanRetry(const I2cXfer_stBus *pstBus, const I2cXfer_stDesc *pstDesc)
+{
+    return (pstDesc->u8Try < I2CXFER_RETRY_MAX) && (pstBus->u8Count < I2CXFER_QUEUE_SIZE);
+}
+
+static void I2cXfer_vRequeue(I2cXfer_stBus *pstBus, I2cXfer_stDesc *pstDesc) // 放回队首，下一个执行
+{
+    pstDesc->u8Try++;
+    pstDesc->enSts = I2cXfer_Queued;
+
+    pstBus->u8Head                    = (uint8_t)((pstBus->u8Head + I2CXFER_QUEUE_SIZE - 1u) % I2CXFER_QUEUE_SIZE);
+    pstBus->apstQueue[pstBus->u8Head] = pstDesc;
+    pstBus->u8Count++;
+}
+
+static void I2cXfer_vRetryOrFail(I2cXfer_stBus *pstBus) // 当前事务失败：重试次数未用尽时放回队首，否则以错误结束
+{
+    I2cXfer_stDesc *pstDesc = pstBus->pstCur;
+
+    if (I2cXfer_boCanRetry(pstBus, pstDesc))
+    {
+        if (NULL != pstDesc->pu16Cmd)
+        {
+            I2cXfer_vDmaStop(pstBus);
+        }
+        else
+        {}
+
+        pstBus->pstCur      = NULL;
+        pstBus->u8StallTick = 0u;
+        I2cXfer_vRequeue(pstBus, pstDesc);
+    }
+    else
+    {
+        I2cXfer_astErrCnt[I2cXfer_u8DevIdx(pstDesc->u8DevAddr)].u16Fail++;
+        I2cXfer_vFinish(pstBus, I2cXfer_Error);
+    }
+}
+
+void I2cXfer_vForgetTarget(void)
+{
+    uint32_t u32PriMask;
+    uint8_t  u8Bus;
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    for (u8Bus = 0u; u8Bus < I2CXFER_BUS_NUM; u8Bus++)
+    {
+        I2cXfer_astBus[u8Bus].u8Target = I2CXFER_TARGET_NONE; // 表中地址未变，实际从机地址已变
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+void I2cXfer_vTick(void)
+{
+    uint32_t        u32PriMask;
+    uint8_t         u8Bus;
+    I2cXfer_stBus  *pstBus;
+    I2cXfer_stDesc *apstHung[I2CXFER_BUS_NUM] = {NULL}; // 超时时在总线上的事务
+    bool            boWin;
+
+    /* 临界区内只判断超时并摘下当前事务，GPIO恢复总线和回调在开中断后执行 */
+    IRQLOCK_SAVE(u32PriMask);
+
+    I2cXfer_u16LoadTick++;
+    boWin = (I2cXfer_u16LoadTick >= MAIN_TIME_MS(I2CXFER_LOAD_WIN_MS));
+    if (boWin)
+    {
+        I2cXfer_u16LoadTick = 0u;
+    }
+    else
+    {}
+
+    for (u8Bus = 0u; u8Bus < I2CXFER_BUS_NUM; u8Bus++)
+    {
+        pstBus = &I2cXfer_astBus[u8Bus];
+
+        if ((NULL == pstBus->pstCur) && (0u == pstBus->u8Count))
+        {
+            pstBus->u8StallTick = 0u;
+        }
+        else if (pstBus->u8StallTick < MAIN_TIME_MS(I2CXFER_TIMEOUT_MS))
+        {
+            pstBus->u8StallTick++;
+        }
+        else
+        {
+            I2C_IntCmd(pstBus->enId, I2C_INT_TX_EMPTY, DISABLE);
+
+            if (NULL != pstBus->pstCur)
+            {
+                I2cXfer_astErrCnt[I2cXfer_u8DevIdx(pstBus->pstCur->u8DevAddr)].u16Timeout++;
+
+                if (NULL != pstBus->pstCur->pu16Cmd)
+                {
+                    I2cXfer_vDmaStop(pstBus); // 恢复后控制器重新使能前先停止搬运
+                }
+                else
+                {}
+            }
+            else
+            {}
+
+            apstHung[u8Bus]     = pstBus->pstCur;
+            pstBus->pstCur      = NULL;
+            pstBus->u8StallTick = 0u;
+            pstBus->boRecover   = true;
+        }
+
+        if (boWin)
+        {
+            /* 窗口内累计us换算为%，模型偏差导致超过窗口时按100%计 */
+            pstBus->u8Load    = (uint8_t)((pstBus->u32BusyUs >= (I2CXFER_LOAD_WIN_MS * 1000u)) ? 100u : (pstBus->u32BusyUs / (I2CXFER_LOAD_WIN_MS * 10u)));
+            pstBus->u32BusyUs = 0u;
+        }
+        else
+        {}
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    for (u8Bus = 0u; u8Bus < I2CXFER_BUS_NUM; u8Bus++)
+    {
+        if (I2cXfer_astBus[u8Bus].boRecover)
+        {
+            I2cXfer_vRecover(&I2cXfer_astBus[u8Bus], apstHung[u8Bus]);
+        }
+        else
+        {}
+    }
+}
+
+static void I2cXfer_vRecover(I2cXfer_stBus *pstBus, I2cXfer_stDesc *pstDesc) // 从机拉住SDA或STOP中断丢失：SCL翻转释放总线，超时的事务重试或按失败处理
+{
+    uint32_t u32PriMask;
+    bool     boFail = false;
+
+    (void)I2c_boBusRecover(pstBus->enId); // 控制器配置保留，目标地址缓存仍有效
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    I2cXfer_u16Recover++;
+    pstBus->boRecover = false;
+
+    if (I2C0_ID == pstBus->enId)
+    {
+        boI2c0IsIdle = true;
+    }
+    else
+    {}
+
+    if (NULL == pstDesc)
+    {}
+    else if (I2cXfer_boCanRetry(pstBus, pstDesc))
+    {
+        I2cXfer_vRequeue(pstBus, pstDesc);
+    }
+    else
+    {
+        I2cXfer_astErrCnt[I2cXfer_u8DevIdx(pstDesc->u8DevAddr)].u16Fail++;
+        boFail = true;
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    if (boFail)
+    {
+        I2cXfer_vComplete(pstDesc, I2cXfer_Error);
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+    I2cXfer_vStartNext(pstBus);
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+void I2cXfer_vTxEmptyIsr(I2C_Id_t enBus)
+{
+    I2cXfer_stBus    *pstBus  = &I2cXfer_astBus[enBus];
+    I2cXfer_stDesc   *pstDesc = pstBus->pstCur;
+    uint8_t           u8Total;
+    bool              boHold = false;
+    I2C_RestartStop_t enStop;
+
+    if ((NULL == pstDesc) || (NULL != pstDesc->pu16Cmd) || pstBus->boAbort)
+    {
+        I2C_IntCmd(enBus, I2C_INT_TX_EMPTY, DISABLE);
+        return;
+    }
+    else
+    {}
+
+    u8Total = pstDesc->u8TxLen + pstDesc->u8RxLen;
+
+    while ((pstBus->u8CmdIdx < u8Total) && (SET == I2C_GetStatus(enBus, I2C_STATUS_TFNF)))
+    {
+        enStop = ((pstBus->u8CmdIdx + 1u) == u8Total) ? I2C_STOP_EN : I2C_RESTART_AND_STOP_DISABLE;
+
+        if (pstBus->u8CmdIdx < pstDesc->u8TxLen)
+        {
+            I2C_MasterSendByte(enBus, enStop, pstDesc->pu8Tx[pstBus->u8CmdIdx]);
+        }
+        else
+        {
+            if ((uint8_t)(pstBus->u8CmdIdx - pstDesc->u8TxLen - pstBus->u8RxIdx) >= I2CXFER_RX_INFLIGHT_MAX)
+            {
+                boHold = true; // 等RX中断取走数据后再继续
+                break;
+            }
+            else
+            {}
+
+            // 写后读由控制器自动插入RESTART
+            I2C_MasterReadCmd(enBus, enStop);
+        }
+
+        pstBus->u8CmdIdx++;
+    }
+
+    if (boHold || (pstBus->u8CmdIdx >= u8Total))
+    {
+        I2C_IntCmd(enBus, I2C_INT_TX_EMPTY, DISABLE);
+    }
+    else
+    {}
+}
+
+void I2cXfer_vRxFullIsr(I2C_Id_t enBus)
+{
+    I2cXfer_stBus  *pstBus  = &I2cXfer_astBus[enBus];
+    I2cXfer_stDesc *pstDesc = pstBus->pstCur;
+    uint8_t         u8Data;
+
+    if ((NULL != pstDesc) && (NULL != pstDesc->pu16Cmd))
+    {
+        return; // DMA模式下由DMA取数据
+    }
+    else
+    {}
+
+    while (SET == I2C_GetStatus(enBus, I2C_STATUS_RFNE))
+    {
+        u8Data = I2C_ReceiveByte(enBus);
+
+        if ((NULL != pstDesc) && (pstBus->u8RxIdx < pstDesc->u8RxLen))
+        {
+            pstDesc->pu8Rx[pstBus->u8RxIdx] = u8Data;
+            pstBus->u8RxIdx++;
+        }
+        else
+        {}
+    }
+
+    if ((NULL != pstDesc) && !pstBus->boAbort && (pstBus->u8CmdIdx < (pstDesc->u8TxLen + pstDesc->u8RxLen)))
+    {
+        I2C_IntCmd(enBus, I2C_INT_TX_EMPTY, ENABLE);
+    }
+    else
+    {}
+}
+
+void I2cXfer_vStopIsr(I2C_Id_t enBus)
+{
+    I2cXfer_stBus  *pstBus  = &I2cXfer_astBus[enBus];
+    I2cXfer_stDesc *pstDesc = pstBus->pstCur;
+
+    if ((NULL != pstDesc) && (NULL != pstDesc->pu16Cmd))
+    {
+        // 命令流中每段写事务都会产生STOP，命令全部发出且数据收齐才算结束
+        if (pstBus->boAbort)
+        {
+            I2cXfer_vRetryOrFail(pstBus);
+        }
+        else if (I2cXfer_boDmaEnd(pstBus))
+        {
+            I2cXfer_vFinish(pstBus, I2cXfer_Done);
+        }
+        else
+        {}
+    }
+    else if (NULL != pstDesc)
+    {
+        I2cXfer_vRxFullIsr(enBus); // 取走STOP前最后到达的数据
+
+        I2C_IntCmd(enBus, I2C_INT_TX_EMPTY, DISABLE);
+
+        if (pstBus->boAbort || (pstBus->u8RxIdx < pstDesc->u8RxLen) || (pstBus->u8CmdIdx < (pstDesc->u8TxLen + pstDesc->u8RxLen)))
+        {
+            I2cXfer_vRetryOrFail(pstBus);
+        }
+        else
+        {
+            I2cXfer_vFinish(pstBus, I2cXfer_Done);
+        }
+    }
+    else
+    {}
+
+    I2cXfer_vStartNext(pstBus);
+}
+
+void I2cXfer_vAbortIsr(I2C_Id_t enBus) // 控制器中止传输后会清空TX FIFO并发出STOP，由STOP中断结束事务
+{
+    I2cXfer_stBus    *pstBus    = &I2cXfer_astBus[enBus];
+    uint32_t          u32ErrSrc = 0u;
+    I2C_ErrorStatus_t enErr;
+
+    for (enErr = ERR_GEN_CALL_NO_ACK; enErr < ERR_STATUS_ALL; enErr++)
+    {
+        if (SET == I2C_GetErrorStatus(enBus, enErr))
+        {
+            u32ErrSrc |= (1uL << (uint32_t)enErr);
+        }
+        else
+        {}
+    }
+
+    I2C_ClearErrorStatusAll(enBus);
+
+    if (NULL != pstBus->pstCur)
+    {
+        if (0u != (u32ErrSrc & I2CXFER_NACK_MASK))
+        {
+            I2cXfer_astErrCnt[I2cXfer_u8DevIdx(pstBus->pstCur->u8DevAddr)].u16Nack++;
+        }
+        else
+        {
+            I2cXfer_astErrCnt[I2cXfer_u8DevIdx(pstBus->pstCur->u8DevAddr)].u16Abort++;
+        }
+
+        pstBus->pstCur->u32ErrSrc = u32ErrSrc;
+        pstBus->boAbort           = true;
+        I2C_IntCmd(enBus, I2C_INT_TX_EMPTY, DISABLE);
+
+        if (NULL != pstBus->pstCur->pu16Cmd)
+        {
+            I2cXfer_vDmaStop(pstBus); // 停止继续向已清空的FIFO搬运命令
+        }
+        else
+        {}
+    }
+    else
+    {}
+}
+uint16_t I2cXfer_u16EncodeWrite(uint16_t *pu16Cmd, const uint8_t *pu8Data, uint8_t u8Len)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < u8Len; u8Idx++)
+    {
+        pu16Cmd[u8Idx] = I2CXFER_CMD_WR(pu8Data[u8Idx]);
+    }
+
+    if (u8Len > 0u)
+    {
+        pu16Cmd[u8Len - 1u] |= I2CXFER_CMD_STOP;
+    }
+    else
+    {}
+
+    return u8Len;
+}
+
+static uint8_t I2cXfer_u8DevIdx(uint8_t u8DevAddr) // 表外器件返回I2CXFER_DEV_NUM
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < I2CXFER_DEV_NUM; u8Idx++)
+    {
+        if (u8DevAddr == I2cXfer_astDevCfg[u8Idx].u8DevAddr)
+        {
+            break;
+        }
+        else
+        {}
+    }
+
+    return u8Idx;
+}
+
+I2C_Speed_t I2cXfer_enDevSpeed(uint8_t u8DevAddr)
+{
+    uint8_t u8Idx = I2cXfer_u8DevIdx(u8DevAddr);
+
+    return (u8Idx < I2CXFER_DEV_NUM) ? I2cXfer_astDevCfg[u8Idx].enSpeed : I2C_SPEED_STANDARD;
+}
+
+I2C_Id_t I2cXfer_enDevBus(uint8_t u8DevAddr)
+{
+    uint8_t u8Idx = I2cXfer_u8DevIdx(u8DevAddr);
+
+    return (u8Idx < I2CXFER_DEV_NUM) ? I2cXfer_astDevCfg[u8Idx].enBus : I2C0_ID;
+}
+
+uint8_t I2cXfer_u8BusLoad(I2C_Id_t enBus)
+{
+    return I2cXfer_astBus[enBus].u8Load;
+}
+
+bool I2cXfer_boGetErrCnt(uint8_t u8Idx, uint8_t *pu8DevAddr, I2cXfer_stErrCnt *pstCnt)
+{
+    uint32_t u32PriMask;
+
+    if (u8Idx > I2CXFER_DEV_NUM)
+    {
+        return false;
+    }
+    else
+    {}
+
+    *pu8DevAddr = (u8Idx < I2CXFER_DEV_NUM) ? I2cXfer_astDevCfg[u8Idx].u8DevAddr : I2CXFER_TARGET_NONE;
+
+    IRQLOCK_SAVE(u32PriMask);
+    *pstCnt = I2cXfer_astErrCnt[u8Idx];
+    IRQLOCK_RESTORE(u32PriMask);
+
+    return true;
+}
+
+uint16_t I2cXfer_u16RecoverCnt(void)
+{
+    return I2cXfer_u16Recover;
+}
+
+static const I2cXfer_stSclCnt *I2cXfer_pstSclCnt(I2C_Speed_t enSpeed)
+{
+    if (I2C_SPEED_FAST == enSpeed)
+    {
+        return &I2cXfer_astSclCnt[1];
+    }
+    else if (I2C_SPEED_FAST_PLUS == enSpeed)
+    {
+        return &I2cXfer_astSclCnt[2];
+    }
+    else
+    {
+        return &I2cXfer_astSclCnt[0];
+    }
+}
+
+uint32_t I2cXfer_u32BitNs(I2C_Speed_t enSpeed)
+{
+    const I2cXfer_stSclCnt *pstCnt = I2cXfer_pstSclCnt(enSpeed);
+
+    return (((uint32_t)pstCnt->u16HCnt + pstCnt->u8SpkLen + 7u + pstCnt->u16LCnt + 1u) * 1000000u) / I2CXFER_CLK_KHZ;
+}
+
+uint32_t I2cXfer_u32BusNs(I2C_Speed_t enSpeed, uint16_t u16Byte)
+{
+    /* 每字节8位数据+1位ACK，START/STOP各约1个SCL周期 */
+    return ((uint32_t)u16Byte * 9u + 2u) * I2cXfer_u32BitNs(enSpeed);
+}
+
+static uint32_t I2cXfer_u32DescUs(const I2cXfer_stDesc *pstDesc, I2C_Speed_t enSpeed) // 按时间模型估算一次事务占用总线的时间
+{
+    uint16_t u16Byte;
+    uint16_t u16Idx;
+
+    if (NULL != pstDesc->pu16Cmd)
+    {
+        u16Byte = pstDesc->u16CmdLen;
+
+        for (u16Idx = 0u; u16Idx < pstDesc->u16CmdLen; u16Idx++)
+        {
+            if (0u != (pstDesc->pu16Cmd[u16Idx] & (I2CXFER_CMD_STOP | I2CXFER_CMD_RESTART)))
+            {
+                u16Byte++; // 每段事务另有一个从机地址字节
+            }
+            else
+            {}
+        }
+    }
+    else
+    {
+        u16Byte = 1u + pstDesc->u8TxLen + ((0u != pstDesc->u8RxLen) ? (1u + pstDesc->u8RxLen) : 0u);
+    }
+
+    return I2cXfer_u32BusNs(enSpeed, u16Byte) / 1000u;
+}
+
+static void I2cXfer_vRetarget(I2cXfer_stBus *pstBus, uint8_t u8DevAddr) // 目标地址和SCL计数只能在控制器禁止时修改
+{
+    I2C_Speed_t             enSpeed = I2cXfer_enDevSpeed(u8DevAddr);
+    const I2cXfer_stSclCnt *pstCnt  = I2cXfer_pstSclCnt(enSpeed);
+
+    I2C_Disable(pstBus->enId);
+    I2C_SetTargetAddr(pstBus->enId, Board_u8BusAddr(u8DevAddr)); // u8Target及器件配置仍按表中地址
+
+    if (enSpeed != pstBus->enSpeed)
+    {
+        I2c_vSetScl(pstBus->enId, enSpeed, pstCnt->u16HCnt, pstCnt->u16LCnt); // 与时间模型使用同一组计数
+        pstBus->enSpeed = enSpeed;
+    }
+    else
+    {}
+
+    I2C_Enable(pstBus->enId);
+    pstBus->u8Target = u8DevAddr;
+}
+
+static void I2cXfer_vDmaInit(void) // 每个控制器的TX/RX各占一个DMA通道，只初始化一次
+{
+    const DMA_Config_t stDmaCfg = {
+        .dmaDebugBehavior       = DMA_DEBUG_CONTINUE,
+        .dmaPriorityArbitration = DMA_FIXED_PRIORITY_ARBITRATION,
+        .dmaErrorBehavior       = DMA_ERROR_HALT,
+    };
+
+    if (I2cXfer_boDmaInit)
+    {
+        return;
+    }
+    else
+    {}
+
+    SYSCTRL_EnableModule(SYSCTRL_DMA);
+    SYSCTRL_EnableModule(SYSCTRL_DMAMUX);
+
+    DMA_Init(&stDmaCfg);
+    DMA_InstallCallBackFunc(I2cXfer_astDmaCfg[I2C0_ID].enTxCh, DMA_INT_DONE, I2cXfer_vDma0TxDone);
+    DMA_InstallCallBackFunc(I2cXfer_astDmaCfg[I2C0_ID].enRxCh, DMA_INT_DONE, I2cXfer_vDma0RxDone);
+    DMA_InstallCallBackFunc(I2cXfer_astDmaCfg[I2C1_ID].enTxCh, DMA_INT_DONE, I2cXfer_vDma1TxDone);
+    DMA_InstallCallBackFunc(I2cXfer_astDmaCfg[I2C1_ID].enRxCh, DMA_INT_DONE, I2cXfer_vDma1RxDone);
+
+    NVIC_SetPriority(DMA0TO3_IRQn, 0u);
+    NVIC_EnableIRQ(DMA0TO3_IRQn);
+
+    I2cXfer_boDmaInit = true;
+}
+
+static void I2cXfer_vDmaStart(I2cXfer_stBus *pstBus, const I2cXfer_stDesc *pstDesc)
+{
+    const I2cXfer_stDmaCfg *pstDma = pstBus->pstDma;
+
+    const I2C_DmaConfig_t stI2cDmaCfg = {
+        .I2C_DMA_TransmitReqLevel = I2CXFER_DMA_TX_LVL,
+        .I2C_DMA_RecvReqLevel     = I2CXFER_DMA_RX_LVL,
+    };
+    DMA_TransferConfig_t stCfg = {
+        .channel                    = pstDma->enTxCh,
+        .channelPriority            = DMA_CHN_PRIORITY1,
+        .channelPreempt             = DMA_NOSUSPEND_NOPREEMPT,
+        .source                     = pstDma->enTxReq,
+        .doneIntMask                = UNMASK,
+        .errorIntMask               = MASK,
+        .minorLoopNum               = pstDesc->u16CmdLen,
+        .srcAddr                    = (uint32_t)pstDesc->pu16Cmd,
+        .destAddr                   = pstDma->u32DataReg,
+        .minorLoopSrcOffset         = 2,
+        .minorLoopDestOffset        = 0,
+        .majorLoopSrcOffset         = 0,
+        .majorLoopDestOffset        = 0,
+        .transferByteNum            = 2u, // 每次请求搬运一条命令
+        .srcTransferSize            = DMA_TRANSFER_SIZE_2B,
+        .destTransferSize           = DMA_TRANSFER_SIZE_2B,
+        .disableRequestAfterDoneCmd = ENABLE,
+    };
+
+    pstBus->boDmaTxEnd = false;
+    pstBus->boDmaRxEnd = (0u == pstDesc->u8RxLen);
+
+    I2C_DmaConfig(pstBus->enId, &stI2cDmaCfg);
+
+    if (!pstBus->boDmaRxEnd)
+    {
+        DMA_TransferConfig_t stRxCfg = stCfg;
+
+        stRxCfg.channel             = pstDma->enRxCh;
+        stRxCfg.channelPriority     = DMA_CHN_PRIORITY2; // 读数据优先，防止RX FIFO溢出
+        stRxCfg.source              = pstDma->enRxReq;
+        stRxCfg.minorLoopNum        = pstDesc->u8RxLen;
+        stRxCfg.srcAddr             = pstDma->u32DataReg;
+        stRxCfg.destAddr            = (uint32_t)pstDesc->pu8Rx;
+        stRxCfg.minorLoopSrcOffset  = 0;
+        stRxCfg.minorLoopDestOffset = 1;
+        stRxCfg.transferByteNum     = 1u;
+        stRxCfg.srcTransferSize     = DMA_TRANSFER_SIZE_1B;
+        stRxCfg.destTransferSize    = DMA_TRANSFER_SIZE_1B;
+
+        I2C_IntCmd(pstBus->enId, I2C_INT_RX_FULL, DISABLE);
+        (void)DMA_ConfigTransfer(&stRxCfg);
+        DMA_ChannelRequestEnable(pstDma->enRxCh);
+    }
+    else
+    {}
+
+    (void)DMA_ConfigTransfer(&stCfg);
+    DMA_ChannelRequestEnable(pstDma->enTxCh);
+
+    I2C_DmaCmd(pstBus->enId, ENABLE, pstBus->boDmaRxEnd ? DISABLE : ENABLE);
+}
+
+static void I2cXfer_vDmaStop(const I2cXfer_stBus *pstBus)
+{
+    I2C_DmaCmd(pstBus->enId, DISABLE, DISABLE);
+
+    DMA_ChannelRequestDisable(pstBus->pstDma->enTxCh);
+    DMA_ChannelRequestDisable(pstBus->pstDma->enRxCh);
+    DMA_ClearDoneStatus(pstBus->pstDma->enTxCh);
+    DMA_ClearDoneStatus(pstBus->pstDma->enRxCh);
+
+    I2C_IntCmd(pstBus->enId, I2C_INT_RX_FULL, ENABLE);
+}
+
+static bool I2cXfer_boDmaEnd(const I2cXfer_stBus *pstBus)
+{
+    return pstBus->boDmaTxEnd && pstBus->boDmaRxEnd && (SET == I2C_GetStatus(pstBus->enId, I2C_STATUS_TFE)) && (RESET == I2C_GetStatus(pstBus->enId, I2C_MST_ACTIVITY));
+}
+
+static void I2cXfer_vDmaRxDone(I2cXfer_stBus *pstBus) // 最后一个字节可能晚于STOP中断被搬走
+{
+    pstBus->boDmaRxEnd = true;
+
+    if ((NULL != pstBus->pstCur) && (NULL != pstBus->pstCur->pu16Cmd) && I2cXfer_boDmaEnd(pstBus))
+    {
+        I2cXfer_vFinish(pstBus, I2cXfer_Done);
+        I2cXfer_vStartNext(pstBus);
+    }
+    else
+    {}
+}
+
+static void I2cXfer_vDma0TxDone(void) // 命令已全部进入TX FIFO，总线上还未发完
+{
+    I2cXfer_astBus[I2C0_ID].boDmaTxEnd = true;
+}
+
+static void I2cXfer_vDma0RxDone(void)
+{
+    I2cXfer_vDmaRxDone(&I2cXfer_astBus[I2C0_ID]);
+}
+
+static void I2cXfer_vDma1TxDone(void)
+{
+    I2cXfer_astBus[I2C1_ID].boDmaTxEnd = true;
+}
+
+static void I2cXfer_vDma1RxDone(void)
+{
+    I2cXfer_vDmaRxDone(&I2cXfer_astBus[I2C1_ID]);
+}
+/*****************************************************************************
+ * End file I2cXfer.c
+ *****************************************************************************/
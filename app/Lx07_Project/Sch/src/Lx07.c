@@ -30,6 +30,11 @@
 #include "Touch.h"
 #include "VedioDisp.h"
 #include "Adc.h"
+#include "can.h"
+#include "Scheduler.h"
+#include "I2cXfer.h"
+#include "RegSeq.h"
+#include "RegCache.h"
 /*****************************************************************************
  * Local macros
  *****************************************************************************/
@@ -42,12 +47,11 @@
 
 #define LX07_ABS(a, b) ((a > b) ? (a - b) : (b - a))
 
-enum
-{
-    STEP1 = 2,          // TP_EXT_RSTN up, RESX up  //5ms
-    STEP2 = STEP1 + 9,  // PON up   //45ms
-    STEP3 = STEP2 + 24, // BKL_EN up    //120ms
-};
+#define LX07_SEQ_BUDGET_US  (4000u) // 每个5ms周期给寄存器表的总线时间，留1ms给其他I2C事务
+#define LX07_LINK_SETTLE_MS (10u)   // 串行器/解串器切换工作模式后的等待时间
+#define LX07_FPS_DELTA_MAX  (16u)   // 在线切换帧率时最多写入的寄存器数，超出则复位重新上电配置
+
+
 /*****************************************************************************
  * Local data types
  *****************************************************************************/
@@ -147,6 +151,7 @@ static const I2cSendData Lx07_au8SerVpgFps60HZ[] = {
 
     {DEV_SER, 0x01C9, 0x19}, // 设置数据传输时的时钟的触发方式
     {DEV_SER, 0x0001, 0xd8}, // 启用HDMI 启用两个I2C的透传
+    REGSEQ_DELAY(LX07_LINK_SETTLE_MS),
 
     /* GPIO08: TP_INT*/
     {DEV_SER, 0x0218, 0x04}, //  RX NO OUT
@@ -246,6 +251,7 @@ static const I2cSendData Lx07_au8SerVpgFps45HZ[] = {
 
     {DEV_SER, 0x01C9, 0x19}, // 设置数据传输时的时钟的触发方式
     {DEV_SER, 0x0001, 0xd8}, // 启用HDMI 启用两个I2C的透传
+    REGSEQ_DELAY(LX07_LINK_SETTLE_MS),
 
     /* GPIO08: TP_INT*/
     {DEV_SER, 0x0218, 0x04}, //  RX NO OUT
@@ -253,6 +259,7 @@ static const I2cSendData Lx07_au8SerVpgFps45HZ[] = {
     {DEV_SER, 0x021A, 0x48}, //  接收配置的GPIO8
 };
 
+#ifdef ENABLE_HDMI
 static const I2cSendData Lx07_au8SerHdmi60HZ[] = {
     {DEV_SER, 0x20F5, 0x00},
 
@@ -519,6 +526,7 @@ static const I2cSendData Lx07_au8SerHdmi60HZ[] = {
     {DEV_SER, 0x20F5, 0x01},
     // {DEV_SER,0x0001,0xF8},
     {DEV_SER, 0x0001, 0xD8},
+    REGSEQ_DELAY(LX07_LINK_SETTLE_MS),
 
     /* GPIO08: TP_INT*/  /*串行器的GPIO08配置成输入引脚  接收的ID是0x08*/
     {DEV_SER, 0x0218, 0x04}, //  RX NO OUT
@@ -792,16 +800,19 @@ static const I2cSendData Lx07_au8SerHdmi45HZ[] = {
     {DEV_SER, 0x20F5, 0x01},
     // {DEV_SER,0x0001,0xF8},
     {DEV_SER, 0x0001, 0xD8},
+    REGSEQ_DELAY(LX07_LINK_SETTLE_MS),
 
     /* GPIO08: TP_INT*/  /*串行器的GPIO08配置成输入引脚  接收的ID是0x08*/
     {DEV_SER, 0x0218, 0x04}, //  RX NO OUT
     {DEV_SER, 0x0219, 0xA8}, //  发送配置的GPIO8
     {DEV_SER, 0x021A, 0x48}, //  接收配置的GPIO8
 };
+#endif
 
 static const I2cSendData Lx07_au8DesSeq[] =
     {
         {DEV_DES, 0x0001, 0x12},
+        REGSEQ_DELAY(LX07_LINK_SETTLE_MS), // 链路速率改变后重新锁定
         {DEV_DES, 0x0050, 0x00},
         {DEV_DES, 0x01CE, 0x47},
         {DEV_DES, 0x0D03, 0x8B}, //  展频 0x89:0.25%    0x8A:0.5%   0x8B:1%     0x8C:2%   0x8D:4%
@@ -822,7 +833,7 @@ static const I2cSendData Lx07_au8DesSeq[] =
         {DEV_DES, 0x0203, 0x00}, //  0x00:Low, Enable EEp Write     0x10:High, Disable EEp Write
 };
 
-static const Lx07_stI2cWrite Lx07_au8BklCfg[] =
+static const I2cSendData Lx07_au8BklCfg[] =
     {
         {DEV_BKL, 0x00, 0x87}, //  0xAF是PWM调光        0x87是三路LED   0x83是两路LED
         {DEV_BKL, 0x05, 0x26}, //  IN_I2CDIM_H    0x1FFF/0x3FFF = 50%     0x2666/0x3FFF = 60%
@@ -834,18 +845,118 @@ static const Lx07_stI2cWrite Lx07_au8BklCfg[] =
 };
 
 static bool Lx07_InitAllEndFlg = false;
+static bool Lx07_boDispCfgEnd  = false; // 显示配置序列已执行到END，出图后的回读校验也已结束
+
+static RegSeq_stCtx Lx07_stRegSeq; // 上电时序、显示配置依次使用
+
+static uint32_t Lx07_u32PwrOnTick = 0u; // 上电后的任务周期数，用于统计上电到出图时间
+static uint32_t Lx07_u32LockTick  = 0u; // 检测到LOCK的时刻
+
+static uint8_t     Lx07_u8LinkFps = 0u;                  // 链路当前实际运行的帧率
+static bool        Lx07_boRetime  = false;               // 正在在线切换帧率
+static I2cSendData Lx07_astFpsDelta[LX07_FPS_DELTA_MAX]; // 两套时序表的差异寄存器
+static RegSeq_stOp Lx07_astRetimeOp[2];                  // 差异表对应的操作流
 /*****************************************************************************
  * Local function prototypes
  *****************************************************************************/
-static bool Lx07_boInitLcd(void);
-static bool Lx07_boVpgCfg(void);
-static bool Lx07_boSerHdmiCfg(void);
-static bool Lx07_boDesSetSequence(void); // 由于硬件PCB-v2.0.0的TxCLK_OUTA-连接的是LVDS_D2_N，TxOUT_A2-连接的是LVDS_CLK_N，因此需要重新配置连接顺序
-static bool Lx07_vBklCfg(void);
+static bool Lx07_boPowerSeq(void);
+static bool Lx07_boDispCfg(void);
+static bool Lx07_boLockHigh(void);
+static bool Lx07_boOnLock(void);
+static bool Lx07_boOnPicture(void);
+static bool Lx07_boOnRegChk(void);
+static uint8_t Lx07_u8ChkMask(uint8_t u8Dev, uint16_t u16Reg);
+static void Lx07_vRetime(void);
+static const I2cSendData *Lx07_pstSerTbl(uint8_t u8Fps, uint16_t *pu16Num);
+
+/* 面板上电时序：LOCK稳定后拉低全部控制脚，再按 RESX -> PON -> BKL_EN 顺序拉高 */
+static const RegSeq_stOp Lx07_astPowerSeq[] = {
+    REGSEQ_OP_WAIT(Lx07_boLockHigh, 200u), // LOCK持续为高200ms
+    REGSEQ_OP_CALL(Lx07_boOnLock),
+    REGSEQ_OP_CALL(Adc_boIdentifyHw), // 解串器/背光芯片的实际地址随硬件版本变化，识别后才能访问
+    REGSEQ_OP_DELAY(10u),
+
+    REGSEQ_OP_TARGET(DEV_DES, REGSEQ_ADDR16),
+    REGSEQ_OP_WR(0x0140, 0x20),
+    REGSEQ_OP_WR(0x0002, 0x43),
+    REGSEQ_OP_DELAY(30u),
+
+    DES_GPIO_LOW(12), // LCD_PR_EN down
+    DES_GPIO_LOW(8),  // RESX  down
+    DES_GPIO_LOW(6),  // PON  down
+    DES_GPIO_LOW(13), // BKL_EN down
+    DES_GPIO_LOW(7),  // TP_EXT_RSTN down
+    REGSEQ_OP_DELAY(10u),
+
+    DES_GPIO_HIGH(7), // TP_EXT_RSTN up
+    DES_GPIO_HIGH(8), // RESX up
+    REGSEQ_OP_DELAY(45u),
+
+    DES_GPIO_HIGH(6), // PON up
+    REGSEQ_OP_DELAY(120u),
+
+    DES_GPIO_HIGH(13),    // BKL_EN up
+    REGSEQ_OP_DELAY(10u), // 当对手件上电大概20分钟后接上总成，无背光，所以增加拉背光后的等待时间
+    REGSEQ_OP_END(),
+};
+
+/* 显示配置：串行器 -> 解串器(由于硬件PCB-v2.0.0的TxCLK_OUTA-连接的是LVDS_D2_N，TxOUT_A2-连接的是LVDS_CLK_N，因此需要重新配置连接顺序) -> 背光 */
+static const RegSeq_stOp Lx07_astDispCfg60HZ[] = {
+#ifdef ENABLE_HDMI
+    REGSEQ_OP_TBL(Lx07_au8SerHdmi60HZ, REGSEQ_ADDR16),
+#else
+    REGSEQ_OP_TBL(Lx07_au8SerVpgFps60HZ, REGSEQ_ADDR16),
+#endif
+    REGSEQ_OP_TBL(Lx07_au8DesSeq, REGSEQ_ADDR16),
+    REGSEQ_OP_TBL(Lx07_au8BklCfg, REGSEQ_ADDR8),
+    REGSEQ_OP_TARGET(DEV_BKL, REGSEQ_ADDR8),
+    REGSEQ_OP_VERIFY(0x00, 0x87), // MODE_CTRL
+    REGSEQ_OP_CALL(Lx07_boOnPicture),
+#ifdef ENABLE_REG_CHECK // 出图后再回读，不影响出图时间
+#ifdef ENABLE_HDMI
+    REGSEQ_OP_CHECK(Lx07_au8SerHdmi60HZ, REGSEQ_ADDR16),
+#else
+    REGSEQ_OP_CHECK(Lx07_au8SerVpgFps60HZ, REGSEQ_ADDR16),
+#endif
+    REGSEQ_OP_CHECK(Lx07_au8DesSeq, REGSEQ_ADDR16),
+    REGSEQ_OP_CHECK(Lx07_au8BklCfg, REGSEQ_ADDR8),
+    REGSEQ_OP_CALL(Lx07_boOnRegChk),
+#endif
+    REGSEQ_OP_END(),
+};
+
+static const RegSeq_stOp Lx07_astDispCfg45HZ[] = {
+#ifdef ENABLE_HDMI
+    REGSEQ_OP_TBL(Lx07_au8SerHdmi45HZ, REGSEQ_ADDR16),
+#else
+    REGSEQ_OP_TBL(Lx07_au8SerVpgFps45HZ, REGSEQ_ADDR16),
+#endif
+    REGSEQ_OP_TBL(Lx07_au8DesSeq, REGSEQ_ADDR16),
+    REGSEQ_OP_TBL(Lx07_au8BklCfg, REGSEQ_ADDR8),
+    REGSEQ_OP_TARGET(DEV_BKL, REGSEQ_ADDR8),
+    REGSEQ_OP_VERIFY(0x00, 0x87), // MODE_CTRL
+    REGSEQ_OP_CALL(Lx07_boOnPicture),
+#ifdef ENABLE_REG_CHECK // 出图后再回读，不影响出图时间
+#ifdef ENABLE_HDMI
+    REGSEQ_OP_CHECK(Lx07_au8SerHdmi45HZ, REGSEQ_ADDR16),
+#else
+    REGSEQ_OP_CHECK(Lx07_au8SerVpgFps45HZ, REGSEQ_ADDR16),
+#endif
+    REGSEQ_OP_CHECK(Lx07_au8DesSeq, REGSEQ_ADDR16),
+    REGSEQ_OP_CHECK(Lx07_au8BklCfg, REGSEQ_ADDR8),
+    REGSEQ_OP_CALL(Lx07_boOnRegChk),
+#endif
+    REGSEQ_OP_END(),
+};
 
 static bool Lx07_boWriteEepFlg = true;
 
 static bool Lx07_boInitProFlg = false; // 初始化后，已经开始读写寄存器
+
+static volatile bool Lx07_boCpuLoadReq = false; // CAN请求回复CPU负载
+static volatile bool Lx07_boI2cErrReq  = false; // CAN请求回复I2C错误计数
+static volatile bool Lx07_boRegChkReq  = false; // 回读校验结束或CAN请求时上报
+static volatile bool Lx07_boJobStatReq = false; // CAN请求回复产线任务统计
 /*****************************************************************************
  * function definitions
  *****************************************************************************/
@@ -878,6 +989,196 @@ void Lx07_vWatchDog(void)
     {}
 }
 
+void Lx07_vReqCpuLoad(void) // CAN中断调用
+{
+    Lx07_boCpuLoadReq = true;
+}
+
+static void Lx07_vCpuLoadReport(void)
+{
+    static uint16_t u16LogCnt  = 0u;
+    static uint8_t  u8AlarmOld = 0u;
+
+    Sch_Load_Info_T stLoad;
+    uint8_t         au8CanTx[8] = {0};
+
+    Sch_GetCpuLoad(&stLoad);
+
+    u16LogCnt++;
+    if (u16LogCnt >= MAIN_TIME_MS(1000))
+    {
+        u16LogCnt = 0u;
+        UART_PRINTF("CPU load %d%%, peak %d%%, I2C0 %d%%, I2C1 %d%%\r\n", stLoad.u8CurLoad, stLoad.u8PeakLoad, I2cXfer_u8BusLoad(I2C0_ID), I2cXfer_u8BusLoad(I2C1_ID));
+    }
+    else
+    {}
+
+    if (stLoad.u8Alarm != u8AlarmOld)
+    {
+        u8AlarmOld = stLoad.u8Alarm;
+        UART_PRINTF("CPU load alarm = %d\r\n", stLoad.u8Alarm);
+    }
+    else
+    {}
+
+    if (Lx07_boCpuLoadReq)
+    {
+        Lx07_boCpuLoadReq = false;
+
+        /*Tx 0x501*/
+        au8CanTx[0] = DEVICE_ID;
+        au8CanTx[1] = stLoad.u8CurLoad;
+        au8CanTx[2] = stLoad.u8PeakLoad;
+        au8CanTx[3] = stLoad.u8Alarm;
+        CAN_Send_Msg(LX07_CAN_ID_SCH_STS, au8CanTx);
+    }
+    else
+    {}
+}
+
+void Lx07_vReqI2cErr(void) // CAN中断调用
+{
+    Lx07_boI2cErrReq = true;
+}
+
+void Lx07_vReqRegChk(void) // CAN中断调用
+{
+    Lx07_boRegChkReq = true;
+}
+
+void Lx07_vReqJobStat(void) // CAN中断调用
+{
+    Lx07_boJobStatReq = true;
+}
+
+static uint8_t Lx07_u8Sat(uint16_t u16Val)
+{
+    return (u16Val > 0xFFu) ? 0xFFu : (uint8_t)u16Val;
+}
+
+static void Lx07_vI2cErrReport(void) // 每5ms发送一个器件，避免占满发送邮箱
+{
+    static uint8_t u8Idx = 0u;
+
+    I2cXfer_stErrCnt stCnt;
+    uint8_t          u8DevAddr   = 0u;
+    uint8_t          au8CanTx[8] = {0};
+
+    if (Lx07_boI2cErrReq)
+    {
+        Lx07_boI2cErrReq = false;
+        u8Idx            = 0u;
+    }
+    else if (0u == u8Idx)
+    {
+        return;
+    }
+    else
+    {}
+
+    if (I2cXfer_boGetErrCnt(u8Idx, &u8DevAddr, &stCnt))
+    {
+        /*Tx 0x502*/
+        au8CanTx[0] = DEVICE_ID;
+        au8CanTx[1] = u8DevAddr;
+        au8CanTx[2] = Lx07_u8Sat(stCnt.u16Nack);
+        au8CanTx[3] = Lx07_u8Sat(stCnt.u16Abort);
+        au8CanTx[4] = Lx07_u8Sat(stCnt.u16Timeout);
+        au8CanTx[5] = Lx07_u8Sat(stCnt.u16Fail);
+        au8CanTx[6] = Lx07_u8Sat(I2cXfer_u16RecoverCnt());
+        CAN_Send_Msg(LX07_CAN_ID_I2C_STS, au8CanTx);
+
+        u8Idx++;
+    }
+    else
+    {
+        u8Idx = 0u; // 全部器件已发送
+    }
+}
+
+/* 0x503：首帧 [ID, 0, 比较数H, 比较数L, 不一致数, 回读失败数, VERIFY错误数, 记录项数]，
+ * 其后每个记录项一帧 [ID, 序号(1起), 从机地址, 寄存器H, 寄存器L, 期望值, 实际值, 0] */
+static void Lx07_vRegChkReport(void) // 每5ms发送一帧
+{
+    static uint8_t u8Idx = 0xFFu;
+
+    const RegSeq_stChkLog *pstLog      = NULL;
+    uint8_t                au8CanTx[8] = {0};
+
+    if (Lx07_boRegChkReq)
+    {
+        Lx07_boRegChkReq = false;
+        u8Idx            = 0u;
+    }
+    else if (u8Idx > Lx07_stRegSeq.u8ChkLogNum)
+    {
+        return;
+    }
+    else
+    {}
+
+    au8CanTx[0] = DEVICE_ID;
+    au8CanTx[1] = u8Idx;
+
+    if (0u == u8Idx)
+    {
+        au8CanTx[2] = (uint8_t)(Lx07_stRegSeq.u16ChkNum >> 8u);
+        au8CanTx[3] = (uint8_t)Lx07_stRegSeq.u16ChkNum;
+        au8CanTx[4] = Lx07_u8Sat(Lx07_stRegSeq.u16ChkErr);
+        au8CanTx[5] = Lx07_u8Sat(Lx07_stRegSeq.u16ChkFail);
+        au8CanTx[6] = Lx07_u8Sat(Lx07_stRegSeq.u16VerifyErr);
+        au8CanTx[7] = Lx07_stRegSeq.u8ChkLogNum;
+    }
+    else
+    {
+        pstLog      = &Lx07_stRegSeq.astChkLog[u8Idx - 1u];
+        au8CanTx[2] = pstLog->u8Dev;
+        au8CanTx[3] = (uint8_t)(pstLog->u16Reg >> 8u);
+        au8CanTx[4] = (uint8_t)pstLog->u16Reg;
+        au8CanTx[5] = pstLog->u8Exp;
+        au8CanTx[6] = pstLog->u8Act;
+    }
+
+    /*Tx 0x503*/
+    CAN_Send_Msg(LX07_CAN_ID_REG_CHK, au8CanTx);
+    u8Idx++;
+}
+
+/* 0x504：每类任务一帧 [ID, 任务号, 完成数H, 完成数L, 最大延迟msH, 最大延迟msL, 超时数, 丢弃数] */
+static void Lx07_vJobStatReport(void) // 每5ms发送一类任务
+{
+    static uint8_t u8Job = ProDWork_Num;
+
+    ProductLine_stJobStat stStat;
+    uint8_t               au8CanTx[8] = {0};
+
+    if (Lx07_boJobStatReq)
+    {
+        Lx07_boJobStatReq = false;
+        u8Job             = 0u;
+    }
+    else
+    {}
+
+    if (ProductLine_boGetJobStat(u8Job, &stStat))
+    {
+        /*Tx 0x504*/
+        au8CanTx[0] = DEVICE_ID;
+        au8CanTx[1] = u8Job;
+        au8CanTx[2] = (uint8_t)(stStat.u16Done >> 8u);
+        au8CanTx[3] = (uint8_t)stStat.u16Done;
+        au8CanTx[4] = (uint8_t)(stStat.u16MaxLatMs >> 8u);
+        au8CanTx[5] = (uint8_t)stStat.u16MaxLatMs;
+        au8CanTx[6] = Lx07_u8Sat(stStat.u16Late);
+        au8CanTx[7] = Lx07_u8Sat(stStat.u16Drop);
+        CAN_Send_Msg(LX07_CAN_ID_JOB_STS, au8CanTx);
+
+        u8Job++;
+    }
+    else
+    {}
+}
+
 void Lx07_vTask5ms(void)
 {
     if ((GPIO_ReadPinLevel(PORT_C, GPIO_5) == GPIO_LOW) && (Lx07_boInitProFlg)) // 总成断电会复位一次
@@ -887,8 +1188,20 @@ void Lx07_vTask5ms(void)
     }
 
     Lx07_vWatchDog();
+    Lx07_vCpuLoadReport();
+    Lx07_vI2cErrReport();
+    Lx07_vRegChkReport();
+    Lx07_vJobStatReport();
+    I2cXfer_vTick();
 
-    if (Lx07_boInitLcd())
+    if (!Lx07_InitAllEndFlg)
+    {
+        Lx07_u32PwrOnTick++;
+    }
+    else
+    {}
+
+    if (Lx07_boPowerSeq())
     {
         if (!Lx07_InitAllEndFlg)
         {
@@ -896,199 +1209,149 @@ void Lx07_vTask5ms(void)
 
             if (VedioDisp_boReadFpsEnd())
             {
-#ifdef ENABLE_HDMI
-                if (Lx07_boSerHdmiCfg())
-                {
-                    if (Lx07_boDesSetSequence())
-                    {
-                        Lx07_vBklCfg();
-                    }
-                }
-#else
-                if (Lx07_boVpgCfg())
-                {
-                    if (Lx07_boDesSetSequence())
-                    {
-                        Lx07_vBklCfg();
-                    }
-                }
-#endif
+                Lx07_boDispCfg();
             }
         }
+        else if (!Lx07_boDispCfgEnd)
+        {
+            Lx07_boDispCfgEnd = Lx07_boDispCfg(); // 出图后继续执行回读校验，直到序列结束
+        }
+        else
+        {}
     }
 
     if (Lx07_InitAllEndFlg)
     {
         Lx07_vInit();
+        Lx07_vRetime();
         ProductLine_vHandle();
     }
 }
 
-static bool Lx07_boInitLcd(void)
+bool Lx07_boReqRetime(uint8_t u8Fps) // 返回false时由调用者复位重新上电配置
 {
-    static uint16_t u16Index       = 0;
-    static uint8_t  u8TimeCnt      = 0;
-    static uint16_t u16TimeWait5S  = MAIN_TIME_MS(200);
-    static uint16_t u16LockLowTime = 0;
+    const I2cSendData *pstFrom    = NULL;
+    const I2cSendData *pstTo      = NULL;
+    uint16_t           u16FromNum = 0u;
+    uint16_t           u16ToNum   = 0u;
+    uint16_t           u16Cnt     = 0u;
 
-    uint16_t u16Addr = 0;
-    uint8_t  u8Data  = 0;
-
-    if (u8TimeCnt == 0)
+    if ((!Lx07_boDispCfgEnd) || Lx07_boRetime) // 显示配置或回读校验还在使用Lx07_stRegSeq
     {
-        if (GPIO_ReadPinLevel(PORT_C, GPIO_5) == GPIO_HIGH && u16TimeWait5S)
-        {
-            if (u16LockLowTime >= MAIN_TIME_MS(1000)) // 确保换件时，对手件还会复位一次
-            {
-                UART_PRINTF("Poweron Reset\r\n");
-                NVIC_SystemReset();
-            }
-
-            u16TimeWait5S--;
-            if (!u16TimeWait5S)
-            {
-                u8TimeCnt++;
-                Lx07_boInitProFlg = true;
-                I2C_Disable(I2C0_ID);
-                I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                I2C_Enable(I2C0_ID);
-            }
-        }
-
-        if (GPIO_ReadPinLevel(PORT_C, GPIO_5) == GPIO_LOW)
-        {
-            u16TimeWait5S  = MAIN_TIME_MS(200);
-            u16LockLowTime = (++u16LockLowTime >= MAIN_TIME_MS(1000)) ? MAIN_TIME_MS(1000) : u16LockLowTime;
-            // UART_PRINTF("u16LockLowTime = %d\r\n", u16LockLowTime);
-        }
+        return false;
     }
-    else if (u8TimeCnt < 3)
+    else if (u8Fps == Lx07_u8LinkFps)
     {
-        u8TimeCnt++;
+        return true;
     }
-    else if (u8TimeCnt == 3)
+    else
+    {}
+
+    pstFrom = Lx07_pstSerTbl(Lx07_u8LinkFps, &u16FromNum);
+    pstTo   = Lx07_pstSerTbl(u8Fps, &u16ToNum);
+
+    if ((NULL == pstFrom) || (NULL == pstTo))
     {
-        u16Addr = 0x140;
-        u8Data  = 0x20;
-        Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&u16Addr, (uint8_t *)&u8Data);
-        u16Addr = 0x2;
-        u8Data  = 0x43;
-        Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&u16Addr, (uint8_t *)&u8Data);
-        u8TimeCnt++;
+        return false;
     }
-    else if (u8TimeCnt < 6)
+    else
+    {}
+
+    u16Cnt = RegSeq_u16Delta(pstFrom, u16FromNum, pstTo, u16ToNum, Lx07_astFpsDelta, LX07_FPS_DELTA_MAX);
+
+    if (u16Cnt > LX07_FPS_DELTA_MAX)
     {
-        u8TimeCnt++;
+        return false;
     }
-    else if (u8TimeCnt == 6)
+    else
+    {}
+
+    Lx07_astRetimeOp[0] = (RegSeq_stOp){RegSeq_OpTbl, REGSEQ_ADDR16, u16Cnt, {Lx07_astFpsDelta}};
+    Lx07_astRetimeOp[1] = (RegSeq_stOp)REGSEQ_OP_END();
+
+    RegSeq_vStart(&Lx07_stRegSeq, Lx07_astRetimeOp);
+    Lx07_boRetime  = true;
+    Lx07_u8LinkFps = u8Fps;
+
+    UART_PRINTF("Fps retime to %x, %d registers\r\n", u8Fps, u16Cnt);
+
+    return true;
+}
+
+static void Lx07_vRetime(void)
+{
+    static uint16_t u16RetimeTick = 0u;
+
+    if (Lx07_boRetime)
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-        I2C_Enable(I2C0_ID);
-        u8TimeCnt++;
+        u16RetimeTick++;
+
+        if (RegSeq_boRun(&Lx07_stRegSeq, LX07_SEQ_BUDGET_US))
+        {
+            Lx07_boRetime = false;
+
+            UART_PRINTF("Fps retime done %d ms\r\n", (int)(u16RetimeTick * MAIN_TASK_MS));
+            u16RetimeTick = 0u;
+
+#ifndef ENABLE_HDMI
+            RegCache_vDrop(DEV_SER);                           // 图案寄存器值未变也必须真正写入
+            ProductLine_boPost(ProDWork_Write_VPGColor, NULL); // 重新写入当前图案，VPG按新时序重新输出
+#endif
+        }
+        else
+        {}
     }
-    else if (u8TimeCnt < 9)
+    else
+    {}
+}
+
+static const I2cSendData *Lx07_pstSerTbl(uint8_t u8Fps, uint16_t *pu16Num) // 当前配置下串行器的时序表
+{
+    const I2cSendData *pstTbl = NULL;
+
+    if (CAN_Write_Fps60HZ == u8Fps)
     {
-        u8TimeCnt++;
+#ifdef ENABLE_HDMI
+        pstTbl   = Lx07_au8SerHdmi60HZ;
+        *pu16Num = sizeof(Lx07_au8SerHdmi60HZ) / sizeof(Lx07_au8SerHdmi60HZ[0]);
+#else
+        pstTbl   = Lx07_au8SerVpgFps60HZ;
+        *pu16Num = sizeof(Lx07_au8SerVpgFps60HZ) / sizeof(Lx07_au8SerVpgFps60HZ[0]);
+#endif
     }
-    else if (u8TimeCnt == 9)
+    else if (CAN_Write_Fps45HZ == u8Fps)
     {
-        switch (u16Index)
-        {
-            case 0:
-                DES_GPIO_LOW(12); // LCD_PR_EN down
-
-                DES_GPIO_LOW(8);  // RESX  down
-                DES_GPIO_LOW(6);  // PON  down
-                DES_GPIO_LOW(13); // BKL_EN down
-                DES_GPIO_LOW(7);  // TP_EXT_RSTN down
-                break;
-            case STEP1:
-                DES_GPIO_HIGH(7); // TP_EXT_RSTN up
-                DES_GPIO_HIGH(8); // RESX up
-                break;
-            case STEP2:
-                DES_GPIO_HIGH(6); // PON up
-                break;
-            case STEP3:
-                DES_GPIO_HIGH(13); // BKL_EN up
-                break;
-        }
-        u16Index > (STEP3 + 1) ? u16Index = u16Index : u16Index++; // 改成STEP3 + 1的原因：当对手件上电大概20分钟后接上总成，无背光，所以增加拉背光后的等待时间
+#ifdef ENABLE_HDMI
+        pstTbl   = Lx07_au8SerHdmi45HZ;
+        *pu16Num = sizeof(Lx07_au8SerHdmi45HZ) / sizeof(Lx07_au8SerHdmi45HZ[0]);
+#else
+        pstTbl   = Lx07_au8SerVpgFps45HZ;
+        *pu16Num = sizeof(Lx07_au8SerVpgFps45HZ) / sizeof(Lx07_au8SerVpgFps45HZ[0]);
+#endif
     }
+    else
+    {}
 
-    return u16Index > (STEP3 + 1) ? true : false;
+    return pstTbl;
 }
 
-static bool Lx07_boVpgCfg(void)
+static bool Lx07_boPowerSeq(void)
 {
-    static uint8_t u8VpgTimeCnt = 0;
-    static uint8_t u8VpgCfgCnt  = 0;
-
-    static bool boRte = false;
+    static bool boStart = false;
+    static bool boRte   = false;
 
     if (!boRte)
     {
-        if (u8VpgTimeCnt < 2)
-        {
-            u8VpgTimeCnt++;
-        }
-        else if (u8VpgTimeCnt == 2)
+        if (!boStart)
         {
-            u8VpgTimeCnt = 3;
-            I2C_Disable(I2C0_ID);
-            I2C_SetTargetAddr(I2C0_ID, DEV_SER);
-            I2C_Enable(I2C0_ID);
-        }
-        else if (u8VpgTimeCnt < 4)
-        {
-            u8VpgTimeCnt++;
-        }
-        else if (u8VpgTimeCnt == 4)
-        {
-            u8VpgTimeCnt = 4;
-
-            if (CAN_Write_Fps60HZ == VedioDisp_u8FpsHz)
-            {
-                if (u8VpgCfgCnt < (sizeof(Lx07_au8SerVpgFps60HZ) / sizeof(Lx07_au8SerVpgFps60HZ[0])))
-                {
-                    Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&Lx07_au8SerVpgFps60HZ[u8VpgCfgCnt].u16DstRegAddr, (uint8_t *)&Lx07_au8SerVpgFps60HZ[u8VpgCfgCnt].u8RegData);
-                    u8VpgCfgCnt++;
-                }
-                else if (u8VpgCfgCnt == (sizeof(Lx07_au8SerVpgFps60HZ) / sizeof(Lx07_au8SerVpgFps60HZ[0])))
-                {
-                    u8VpgCfgCnt = (sizeof(Lx07_au8SerVpgFps60HZ) / sizeof(Lx07_au8SerVpgFps60HZ[0])) + 1;
-                    I2C_Disable(I2C0_ID);
-                    I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                    I2C_Enable(I2C0_ID);
-                    boRte = true;
-                }
-                else
-                {}
-            }
-            else if (CAN_Write_Fps45HZ == VedioDisp_u8FpsHz)
-            {
-                if (u8VpgCfgCnt < (sizeof(Lx07_au8SerVpgFps45HZ) / sizeof(Lx07_au8SerVpgFps45HZ[0])))
-                {
-                    Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&Lx07_au8SerVpgFps45HZ[u8VpgCfgCnt].u16DstRegAddr, (uint8_t *)&Lx07_au8SerVpgFps45HZ[u8VpgCfgCnt].u8RegData);
-                    u8VpgCfgCnt++;
-                }
-                else if (u8VpgCfgCnt == (sizeof(Lx07_au8SerVpgFps45HZ) / sizeof(Lx07_au8SerVpgFps45HZ[0])))
-                {
-                    u8VpgCfgCnt = (sizeof(Lx07_au8SerVpgFps45HZ) / sizeof(Lx07_au8SerVpgFps45HZ[0])) + 1;
-                    I2C_Disable(I2C0_ID);
-                    I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                    I2C_Enable(I2C0_ID);
-                    boRte = true;
-                }
-                else
-                {}
-            }
-            else
-            {}
+            boStart                 = true;
+            Lx07_stRegSeq.pfChkMask = Lx07_u8ChkMask;
+            RegSeq_vStart(&Lx07_stRegSeq, Lx07_astPowerSeq);
         }
         else
         {}
+
+        boRte = RegSeq_boRun(&Lx07_stRegSeq, LX07_SEQ_BUDGET_US);
     }
     else
     {}
@@ -1096,72 +1359,33 @@ static bool Lx07_boVpgCfg(void)
     return boRte;
 }
 
-static bool Lx07_boSerHdmiCfg(void)
+static bool Lx07_boDispCfg(void)
 {
-    static uint8_t u8HdmiTimeCnt = 0;
-    static uint8_t u8HdmiCfgCnt  = 0;
-
-    static bool boRte = false;
+    static bool boStart = false;
+    static bool boRte   = false;
 
     if (!boRte)
     {
-        if (u8HdmiTimeCnt < 2)
-        {
-            u8HdmiTimeCnt++;
-        }
-        else if (u8HdmiTimeCnt == 2)
+        if (boStart)
+        {}
+        else if (CAN_Write_Fps60HZ == VedioDisp_u8FpsHz)
         {
-            u8HdmiTimeCnt = 3;
-            I2C_Disable(I2C0_ID);
-            I2C_SetTargetAddr(I2C0_ID, DEV_SER);
-            I2C_Enable(I2C0_ID);
+            boStart        = true;
+            Lx07_u8LinkFps = CAN_Write_Fps60HZ;
+            RegSeq_vStart(&Lx07_stRegSeq, Lx07_astDispCfg60HZ);
         }
-        else if (u8HdmiTimeCnt < 4)
+        else if (CAN_Write_Fps45HZ == VedioDisp_u8FpsHz)
         {
-            u8HdmiTimeCnt++;
+            boStart        = true;
+            Lx07_u8LinkFps = CAN_Write_Fps45HZ;
+            RegSeq_vStart(&Lx07_stRegSeq, Lx07_astDispCfg45HZ);
         }
-        else if (u8HdmiTimeCnt == 4)
-        {
-            u8HdmiTimeCnt = 4;
+        else
+        {}
 
-            if (CAN_Write_Fps60HZ == VedioDisp_u8FpsHz)
-            {
-                if (u8HdmiCfgCnt < (sizeof(Lx07_au8SerHdmi60HZ) / sizeof(Lx07_au8SerHdmi60HZ[0])))
-                {
-                    Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&Lx07_au8SerHdmi60HZ[u8HdmiCfgCnt].u16DstRegAddr, (uint8_t *)&Lx07_au8SerHdmi60HZ[u8HdmiCfgCnt].u8RegData);
-                    u8HdmiCfgCnt++;
-                }
-                else if (u8HdmiCfgCnt == (sizeof(Lx07_au8SerHdmi60HZ) / sizeof(Lx07_au8SerHdmi60HZ[0])))
-                {
-                    u8HdmiCfgCnt = (sizeof(Lx07_au8SerHdmi60HZ) / sizeof(Lx07_au8SerHdmi60HZ[0])) + 1;
-                    I2C_Disable(I2C0_ID);
-                    I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                    I2C_Enable(I2C0_ID);
-                    boRte = true;
-                }
-                else
-                {}
-            }
-            else if (CAN_Write_Fps45HZ == VedioDisp_u8FpsHz)
-            {
-                if (u8HdmiCfgCnt < (sizeof(Lx07_au8SerHdmi45HZ) / sizeof(Lx07_au8SerHdmi45HZ[0])))
-                {
-                    Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&Lx07_au8SerHdmi45HZ[u8HdmiCfgCnt].u16DstRegAddr, (uint8_t *)&Lx07_au8SerHdmi45HZ[u8HdmiCfgCnt].u8RegData);
-                    u8HdmiCfgCnt++;
-                }
-                else if (u8HdmiCfgCnt == (sizeof(Lx07_au8SerHdmi45HZ) / sizeof(Lx07_au8SerHdmi45HZ[0])))
-                {
-                    u8HdmiCfgCnt = (sizeof(Lx07_au8SerHdmi45HZ) / sizeof(Lx07_au8SerHdmi45HZ[0])) + 1;
-                    I2C_Disable(I2C0_ID);
-                    I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                    I2C_Enable(I2C0_ID);
-                    boRte = true;
-                }
-                else
-                {}
-            }
-            else
-            {}
+        if (boStart)
+        {
+            boRte = RegSeq_boRun(&Lx07_stRegSeq, LX07_SEQ_BUDGET_US);
         }
         else
         {}
@@ -1172,62 +1396,43 @@ static bool Lx07_boSerHdmiCfg(void)
     return boRte;
 }
 
-static bool Lx07_boDesSetSequence(void)
+static bool Lx07_boLockHigh(void)
 {
-    static uint8_t u8DesSeqTimeCnt = 0;
-    static uint8_t u8DesSeqCfgCnt  = 0;
+    static uint16_t u16LockLowTime = 0;
 
-    static bool boRte = false;
+    bool boRte = false;
 
-    if (!boRte)
+    if (GPIO_ReadPinLevel(PORT_C, GPIO_5) == GPIO_LOW)
     {
-        if (u8DesSeqTimeCnt < 2)
-        {
-            u8DesSeqTimeCnt++;
-        }
-        else if (u8DesSeqTimeCnt == 2)
-        {
-            u8DesSeqTimeCnt = 3;
-            I2C_Disable(I2C0_ID);
-            I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-            I2C_Enable(I2C0_ID);
-        }
-        else if (u8DesSeqTimeCnt < 4)
-        {
-            u8DesSeqTimeCnt++;
-        }
-        else if (u8DesSeqTimeCnt == 4)
-        {
-            u8DesSeqTimeCnt = 4;
-
-            if (u8DesSeqCfgCnt < (sizeof(Lx07_au8DesSeq) / sizeof(Lx07_au8DesSeq[0])))
-            {
-                Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&Lx07_au8DesSeq[u8DesSeqCfgCnt].u16DstRegAddr, (uint8_t *)&Lx07_au8DesSeq[u8DesSeqCfgCnt].u8RegData);
-                u8DesSeqCfgCnt++;
-            }
-            else if (u8DesSeqCfgCnt == (sizeof(Lx07_au8DesSeq) / sizeof(Lx07_au8DesSeq[0])))
-            {
-                u8DesSeqCfgCnt = (sizeof(Lx07_au8DesSeq) / sizeof(Lx07_au8DesSeq[0])) + 1;
-                I2C_Disable(I2C0_ID);
-                I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                I2C_Enable(I2C0_ID);
-                boRte = true;
-            }
-            else
-            {}
-        }
-        else
-        {}
+        u16LockLowTime = (u16LockLowTime + 1u >= MAIN_TIME_MS(1000)) ? MAIN_TIME_MS(1000) : (u16LockLowTime + 1u);
+    }
+    else if (u16LockLowTime >= MAIN_TIME_MS(1000)) // 确保换件时，对手件还会复位一次
+    {
+        UART_PRINTF("Poweron Reset\r\n");
+        NVIC_SystemReset();
     }
     else
-    {}
+    {
+        boRte = true;
+    }
 
     return boRte;
 }
 
-static bool Lx07_vBklCfg(void)
+static bool Lx07_boOnLock(void)
+{
+    Lx07_boInitProFlg = true;
+    Lx07_u32LockTick  = Lx07_u32PwrOnTick;
+
+    RegCache_vDrop(DEV_DES); // 链路重新锁定前远端可能已掉电复位，影子寄存器作废
+    RegCache_vDrop(DEV_BKL);
+
+    return true;
+}
+
+static bool Lx07_boOnPicture(void)
 {
-    /*通道mix调光 + 100%亮度*/
+    /*背光：通道mix调光 + 100%亮度*/
     // 1.BKL_EN DES_GPIO_LOW(13);
 
     // 2.配置 MODE_CTRL 寄存器（地址 00h，default:0x0F）：0x8F(Mix调光)      0xAF是PWM调光
@@ -1238,63 +1443,52 @@ static bool Lx07_vBklCfg(void)
 
     // 5.FUN_SET_1 寄存器（地址 02h，default:0x14）—— Mix 模式转换点与开关频率  0x14  默认展屏
 
-    static uint8_t u8BklTimeCnt = 0;
-    static uint8_t u8BklCfgCnt  = 0;
+    Lx07_InitAllEndFlg = true;
 
-    static bool boRte = false;
+    UART_PRINTF("Power on to picture %d ms, lock to picture %d ms\r\n", (int)(Lx07_u32PwrOnTick * MAIN_TASK_MS), (int)((Lx07_u32PwrOnTick - Lx07_u32LockTick) * MAIN_TASK_MS));
 
-    if (!boRte)
+    if (0u != Lx07_stRegSeq.u16VerifyErr)
     {
-        if (u8BklTimeCnt < 2)
-        {
-            u8BklTimeCnt++;
-        }
-        else if (u8BklTimeCnt == 2)
-        {
-            u8BklTimeCnt = 3;
-            I2C_Disable(I2C0_ID);
-            I2C_SetTargetAddr(I2C0_ID, DEV_BKL);
-            I2C_Enable(I2C0_ID);
-        }
-        else if (u8BklTimeCnt < 4)
-        {
-            u8BklTimeCnt++;
-        }
-        else if (u8BklTimeCnt == 4)
-        {
-            u8BklTimeCnt = 4;
+        UART_PRINTF("Bring-up verify error = %d\r\n", Lx07_stRegSeq.u16VerifyErr);
+    }
+    else
+    {}
 
-            if (u8BklCfgCnt < (sizeof(Lx07_au8BklCfg) / sizeof(Lx07_au8BklCfg[0])))
-            {
-                Lx07_MstWriteByte(I2C0_ID, (uint8_t *)&Lx07_au8BklCfg[u8BklCfgCnt].u8DstRegAddr, (uint8_t *)&Lx07_au8BklCfg[u8BklCfgCnt].u8RegData);
-                u8BklCfgCnt++;
-            }
-            else if (u8BklCfgCnt == (sizeof(Lx07_au8BklCfg) / sizeof(Lx07_au8BklCfg[0])))
-            {
-                u8BklCfgCnt = (sizeof(Lx07_au8BklCfg) / sizeof(Lx07_au8BklCfg[0])) + 1;
-                I2C_Disable(I2C0_ID);
-                I2C_SetTargetAddr(I2C0_ID, DEV_DES);
-                I2C_Enable(I2C0_ID);
-                boRte = true;
+    uint8_t au8BklLel[13] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x31, 0x30, 0x30, 0xFF, 0xFF, 0xFF};
+    Uart_Transmit(au8BklLel, sizeof(au8BklLel));
 
-                Lx07_InitAllEndFlg = true;
+    // uint8_t au8UartTxData[] = {0x74, 0x31, 0x34, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x45, 0x65, 0x70, 0x72, 0x6f, 0x6d, 0x20, 0x22, 0xff, 0xff, 0xff}; // Eeprom
+    // Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
 
-                uint8_t au8BklLel[13] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x31, 0x30, 0x30, 0xFF, 0xFF, 0xFF};
-                Uart_Transmit(au8BklLel, sizeof(au8BklLel));
+    return true;
+}
 
-                // uint8_t au8UartTxData[] = {0x74, 0x31, 0x34, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x45, 0x65, 0x70, 0x72, 0x6f, 0x6d, 0x20, 0x22, 0xff, 0xff, 0xff}; // Eeprom
-                // Uart_Transmit(au8UartTxData, sizeof(au8UartTxData));
-            }
-            else
-            {}
-        }
-        else
-        {}
+static bool Lx07_boOnRegChk(void)
+{
+    if (0u != Lx07_stRegSeq.u16ChkErr + Lx07_stRegSeq.u16ChkFail)
+    {
+        UART_PRINTF("Reg check %d, mismatch %d, read fail %d\r\n", Lx07_stRegSeq.u16ChkNum, Lx07_stRegSeq.u16ChkErr, Lx07_stRegSeq.u16ChkFail);
     }
     else
     {}
 
-    return boRte;
+    Lx07_boRegChkReq = true; // 产线不用轮询即可收到结果
+
+    return true;
+}
+
+static uint8_t Lx07_u8ChkMask(uint8_t u8Dev, uint16_t u16Reg)
+{
+    uint8_t u8Mask = 0xFFu;
+
+    if (((DEV_SER == u8Dev) || (DEV_DES == u8Dev)) && (u16Reg >= 0x0200u) && (u16Reg < 0x0300u) && (0u == ((u16Reg - 0x0200u) % 0x3u)))
+    {
+        u8Mask = 0xF7u; // GPIO_A寄存器bit3为引脚输入电平，只读
+    }
+    else
+    {}
+
+    return u8Mask;
 }
 /*****************************************************************************
  * End file Lx07.c
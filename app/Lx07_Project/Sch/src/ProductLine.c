@@ -16,9 +16,16 @@
 #include "ProductLine.h"
 #include "Eeprom.h"
 #include "i2c.h"
+#include "I2cXfer.h"
+#include "RegCache.h"
+#include "RegSeq.h"
+#include "Scheduler.h"
+#include "Scheduler_Cfg.h"
+#include "IrqLock.h"
 
 #include "Adc.h"
 #include "BackL.h"
+#include "Thermal.h"
 #include "Touch.h"
 #include "VedioDisp.h"
 #include "uart.h"
@@ -26,33 +33,100 @@
 /*****************************************************************************
  * Local macros
  *****************************************************************************/
-#define PRODLINE_READ_TP_SIZE (6) // 读取触摸信息长度
+#define PRODLINE_WR_SLOT_NUM  (4)  // 同一步骤内最多排队的写事务数
+#define PRODLINE_WR_DATA_SIZE (13) // 单个写事务的最大字节数（含寄存器地址，VPG颜色2+11字节）
+
+#define PRODLINE_JOB_NUM (8) // 排队中的任务上限，同类任务只占一项
+#define PRODLINE_RUN_NUM (3) // 同时执行的任务上限，同一器件同一时刻只执行一个任务
 /*****************************************************************************
  * Local data types
  *****************************************************************************/
+typedef struct
+{
+    I2cXfer_stDesc       stDesc; // 必须为第一个成员，完成回调由描述符找到槽位
+    uint8_t              au8Data[PRODLINE_WR_DATA_SIZE];
+    ProductLine_pfWrDone pfDone;
+} ProductLine_stWrSlot;
+
+typedef enum
+{
+    ProductLine_JobMerge,   // 读取：合并到已排队的请求，保留其截止时间
+    ProductLine_JobReplace, // 写入当前状态：用新请求替换已排队的请求
+} ProductLine_enJobPolicy;
+
+typedef struct
+{
+    uint8_t  u8Prio;   // 数值大的先执行，同优先级按截止时间
+    uint8_t  u8Policy; // ProductLine_enJobPolicy
+    uint16_t u16DeadlineMs;
+    uint8_t  u8Dev; // 任务访问的器件，同一器件的任务互斥
+} ProductLine_stJobCfg;
+
+typedef struct
+{
+    bool                  boUsed;
+    bool                  boEnd; // 执行中的任务已调用ProductLine_vJobDone
+    uint8_t               u8Job; // ProductLine_enWorkSts
+    uint8_t               u8Prio;
+    uint32_t              u32PostMs;
+    uint32_t              u32DeadlineMs;
+    ProductLine_pfJobDone pfDone;
+} ProductLine_stJob;
 
 /*****************************************************************************
  * Variant declarations
  *****************************************************************************/
-ProductLine_enWorkSts ProductLine_enCurWorkSts = ProDWork_Idle;
-
 ProductLine_stI2cRW ProductLine_stI2cRWMsgs = {0};
 
+static bool ProductLine_boOnline = false; // 初始化完成后才允许事件直接启动任务
+
+static ProductLine_stWrSlot ProductLine_astWrSlot[PRODLINE_WR_SLOT_NUM];
+static uint8_t              ProductLine_u8WrSlotIdx = 0;
+
+static I2cXfer_stDesc ProductLine_astRdDesc[ProD_I2c_Read_Max]; // 每个读取类型一个描述符
+static uint8_t        ProductLine_au8RdReg[ProD_I2c_Read_Max];
+
+static const ProductLine_stJobCfg ProductLine_astJobCfg[ProDWork_Num] = {
+    {2, ProductLine_JobMerge, 100, DEV_BKL},    // ProDWork_Read_Bkl, CAN请求
+    {2, ProductLine_JobMerge, 100, DEV_ADC},    // ProDWork_Read_LcdTemp
+    {2, ProductLine_JobMerge, 100, DEV_ADC},    // ProDWork_Read_PcbTemp
+    {1, ProductLine_JobMerge, 500, DEV_ADC},    // ProDWork_Read_Batt
+    {1, ProductLine_JobMerge, 500, DEV_ADC},    // ProDWork_Read_AdHw
+    {3, ProductLine_JobMerge, 20, DEV_TP},      // ProDWork_Read_TpCoord, 触摸跟手，读取缓存在Touch模块
+    {0, ProductLine_JobMerge, 1000, DEV_EEP},   // ProDWork_Read_TpCount
+    {1, ProductLine_JobMerge, 200, DEV_EEP},    // ProDWork_Read_Fps, 上电时决定显示配置
+    {0, ProductLine_JobReplace, 1000, DEV_EEP}, // ProDWork_Write_TpCount
+    {2, ProductLine_JobReplace, 50, DEV_BKL},   // ProDWork_Write_Bkl, 按键/CAN调光
+    {2, ProductLine_JobReplace, 100, DEV_SER},  // ProDWork_Write_VPGColor
+    {1, ProductLine_JobReplace, 200, DEV_EEP},  // ProDWork_Write_Fps
+};
+
+static ProductLine_stJob     ProductLine_astJob[PRODLINE_JOB_NUM];
+static ProductLine_stJob     ProductLine_astRunJob[PRODLINE_RUN_NUM]; // 正在执行的任务
+static ProductLine_stJobStat ProductLine_astJobStat[ProDWork_Num];
+static volatile uint32_t     ProductLine_u32Ms = 0; // 任务时间基准，5ms步进
+
 static uint8_t au8ProDReadDataSize[ProD_I2c_Read_Max] = {
 
-    1,                     // ProD_I2c_Read_Bkl,
-    2,                     // ProD_I2c_Read_LcdTemp,
-    2,                     // ProD_I2c_Read_PcbTemp,
-    2,                     // ProD_I2c_Read_Batt,
-    2,                     // ProD_I2c_Read_AdHw,
-    PRODLINE_READ_TP_SIZE, // ProD_I2c_Read_TpCoord
-    4,                     // ProD_I2c_Read_TpCount
-    1,                     // ProD_I2c_Read_Fps
+    2, // ProD_I2c_Read_LcdTemp,
+    2, // ProD_I2c_Read_PcbTemp,
+    2, // ProD_I2c_Read_Batt,
+    2, // ProD_I2c_Read_AdHw,
+    4, // ProD_I2c_Read_TpCount
+    1, // ProD_I2c_Read_Fps
 };
 /*****************************************************************************
  * Local function prototypes
  *****************************************************************************/
 static void ProductLine_vWorkSts(void);
+static void ProductLine_vJobStart(void);
+static bool ProductLine_boDevBusy(uint8_t u8Dev);
+static void ProductLine_vJobRun(ProductLine_enWorkSts enJob);
+static void ProductLine_vJobEnd(ProductLine_stJob *pstRun);
+static void ProductLine_vI2cReadDone(I2cXfer_stDesc *pstDesc);
+static void ProductLine_vI2cWriteDone(I2cXfer_stDesc *pstDesc);
+static bool     ProductLine_boWrCached(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len);
+static uint16_t ProductLine_u16RegAddr(const uint8_t *pu8Data, uint8_t u8AddrLen);
 /*****************************************************************************
  * function definitions
  *****************************************************************************/
@@ -61,63 +135,102 @@ void ProductLine_vInit(void)
     Touch_vInit();
     Adc_vInit();
     BackL_vInit();
+    Thermal_vInit();
 
+    ProductLine_boOnline = true;
     // ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_EEP] = true;
 }
 
 void ProductLine_vHandle(void)
 {
+    ProductLine_u32Ms += MAIN_TASK_MS;
+
     VedioDisp_vHandle();
     Touch_vHandle();
     Adc_vHandle();
     BackL_vHandle();
+
+    if (ProductLine_boOnline) // 温度换算表在Adc_vInit中生成，初始化前不采样
+    {
+        Thermal_vHandle();
+    }
+    else
+    {}
+
     ProductLine_vWorkSts();
 }
 
+void ProductLine_vKick(void) // 由中断事件调用，不等下一个5ms周期即启动空闲任务或推进执行中的任务
+{
+    if (ProductLine_boOnline)
+    {
+        ProductLine_vWorkSts();
+    }
+    else
+    {}
+}
+
+void ProductLine_vJobDone(ProductLine_enWorkSts enJob)
+{
+    uint8_t u8Run;
+
+    for (u8Run = 0; u8Run < PRODLINE_RUN_NUM; u8Run++)
+    {
+        if (ProductLine_astRunJob[u8Run].boUsed && (ProductLine_astRunJob[u8Run].u8Job == enJob))
+        {
+            ProductLine_astRunJob[u8Run].boEnd = true;
+        }
+        else
+        {}
+    }
+}
+
+uint32_t ProductLine_u32NowMs(void)
+{
+    return ProductLine_u32Ms;
+}
+
 static void ProductLine_vWorkSts(void)
 {
-    ProductLine_enI2cReadTyp  enReadTpy  = 0;
-    ProductLine_enI2cWriteTyp enWriteTpy = 0;
+    uint8_t u8Run;
+    bool    boEnd = false;
+
+    ProductLine_vJobStart();
 
-    if (ProDWork_Idle == ProductLine_enCurWorkSts && boI2c0IsIdle)
+    // 执行i2c读取或者写入任务，各任务的事务在I2cXfer中按总线排队，不同器件的任务交替进行
+
+    for (u8Run = 0; u8Run < PRODLINE_RUN_NUM; u8Run++)
     {
-        for (enReadTpy = 0; enReadTpy < ProD_I2c_Read_Max; enReadTpy++) // 查询是否有产线读取指令
+        if (ProductLine_astRunJob[u8Run].boUsed && !ProductLine_astRunJob[u8Run].boEnd)
         {
-            if (ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[enReadTpy])
-            {
-                ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[enReadTpy] = false;
-                ProductLine_stI2cRWMsgs.Read_t.enTyp                 = enReadTpy;
-                ProductLine_enCurWorkSts                             = (ProductLine_enWorkSts)enReadTpy;
-                break;
-            }
-            else
-            {}
+            ProductLine_vJobRun((ProductLine_enWorkSts)ProductLine_astRunJob[u8Run].u8Job);
         }
+        else
+        {}
+    }
 
-        if (ProD_I2c_Read_Max == enReadTpy) // 没有产线读取指令
+    for (u8Run = 0; u8Run < PRODLINE_RUN_NUM; u8Run++)
+    {
+        if (ProductLine_astRunJob[u8Run].boUsed && ProductLine_astRunJob[u8Run].boEnd)
         {
-            for (enWriteTpy = 0; enWriteTpy < ProD_I2c_Write_Max; enWriteTpy++) // 查询是否有产线写入指令
-            {
-                if (ProductLine_stI2cRWMsgs.Write_t.aboWFlg[enWriteTpy])
-                {
-                    ProductLine_stI2cRWMsgs.Write_t.aboWFlg[enWriteTpy] = false;
-                    ProductLine_stI2cRWMsgs.Write_t.enTyp               = enWriteTpy;
-                    ProductLine_enCurWorkSts                            = (ProductLine_enWorkSts)(ProD_I2c_Read_Max + enWriteTpy);
-                    break;
-                }
-                else
-                {}
-            }
+            ProductLine_vJobEnd(&ProductLine_astRunJob[u8Run]);
+            boEnd = true;
         }
         else
         {}
     }
+
+    if (boEnd)
+    {
+        Sch_PostEvent(SCH_EVENT_I2C_DONE); // 空出的执行位在下一轮主循环接着启动排队的任务
+    }
     else
     {}
+}
 
-    // 执行i2c读取或者写入任务
-
-    switch (ProductLine_enCurWorkSts)
+static void ProductLine_vJobRun(ProductLine_enWorkSts enJob)
+{
+    switch (enJob)
     {
         /*I2C Read*/
         case ProDWork_Read_Bkl:
@@ -163,31 +276,363 @@ static void ProductLine_vWorkSts(void)
     }
 }
 
-void ProductLine_vI2cRecvHandle(void) // 在i2c中断接收数据
+bool ProductLine_boPost(ProductLine_enWorkSts enJob, ProductLine_pfJobDone pfDone)
+{
+    ProductLine_stJob *pstJob  = NULL;
+    ProductLine_stJob *pstFree = NULL;
+    uint32_t           u32PriMask;
+    uint8_t            u8Idx;
+    bool               boRte = true;
+
+    if (enJob >= ProDWork_Num)
+    {
+        return false;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    for (u8Idx = 0; u8Idx < PRODLINE_JOB_NUM; u8Idx++)
+    {
+        if (ProductLine_astJob[u8Idx].boUsed && (ProductLine_astJob[u8Idx].u8Job == enJob))
+        {
+            pstJob = &ProductLine_astJob[u8Idx];
+        }
+        else if ((!ProductLine_astJob[u8Idx].boUsed) && (NULL == pstFree))
+        {
+            pstFree = &ProductLine_astJob[u8Idx];
+        }
+        else
+        {}
+    }
+
+    if (NULL != pstJob)
+    {
+        ProductLine_astJobStat[enJob].u16Merge++;
+
+        if (ProductLine_JobReplace == ProductLine_astJobCfg[enJob].u8Policy)
+        {
+            pstJob->u32PostMs     = ProductLine_u32Ms;
+            pstJob->u32DeadlineMs = ProductLine_u32Ms + ProductLine_astJobCfg[enJob].u16DeadlineMs;
+        }
+        else
+        {}
+    }
+    else if (NULL != pstFree)
+    {
+        ProductLine_astJobStat[enJob].u16Post++;
+
+        pstJob                = pstFree;
+        pstJob->boUsed        = true;
+        pstJob->u8Job         = enJob;
+        pstJob->u8Prio        = ProductLine_astJobCfg[enJob].u8Prio;
+        pstJob->u32PostMs     = ProductLine_u32Ms;
+        pstJob->u32DeadlineMs = ProductLine_u32Ms + ProductLine_astJobCfg[enJob].u16DeadlineMs;
+        pstJob->pfDone        = NULL;
+    }
+    else
+    {
+        ProductLine_astJobStat[enJob].u16Drop++;
+        boRte = false;
+    }
+
+    if ((NULL != pstJob) && (NULL != pfDone))
+    {
+        pstJob->pfDone = pfDone; // 合并时只保留最后一个回调
+    }
+    else
+    {}
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    return boRte;
+}
+
+bool ProductLine_boGetJobStat(uint8_t u8Job, ProductLine_stJobStat *pstStat)
+{
+    uint32_t u32PriMask;
+
+    if (u8Job >= ProDWork_Num)
+    {
+        return false;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+    *pstStat = ProductLine_astJobStat[u8Job];
+    IRQLOCK_RESTORE(u32PriMask);
+
+    return true;
+}
+
+static void ProductLine_vJobStart(void) // 每个空闲执行位取出优先级最高、截止时间最早且器件空闲的任务
 {
-    if (ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProductLine_stI2cRWMsgs.Read_t.enTyp])
+    ProductLine_stJob *pstBest;
+    ProductLine_stJob *pstJob;
+    uint32_t           u32PriMask;
+    uint8_t            u8Run;
+    uint8_t            u8Idx;
+
+    for (u8Run = 0; u8Run < PRODLINE_RUN_NUM; u8Run++)
     {
-        ProductLine_stI2cRWMsgs.Read_t.au8Data[ProductLine_stI2cRWMsgs.Read_t.u8Count] = I2C_ReceiveByte(I2C0_ID);
-        ProductLine_stI2cRWMsgs.Read_t.u8Count++;
+        if (ProductLine_astRunJob[u8Run].boUsed)
+        {}
+        else
+        {
+            pstBest = NULL;
+
+            IRQLOCK_SAVE(u32PriMask);
+
+            for (u8Idx = 0; u8Idx < PRODLINE_JOB_NUM; u8Idx++)
+            {
+                pstJob = &ProductLine_astJob[u8Idx];
+
+                if ((!pstJob->boUsed) || ProductLine_boDevBusy(ProductLine_astJobCfg[pstJob->u8Job].u8Dev))
+                {}
+                else if ((NULL == pstBest) || (pstJob->u8Prio > pstBest->u8Prio) ||
+                         ((pstJob->u8Prio == pstBest->u8Prio) && ((int32_t)(pstJob->u32DeadlineMs - pstBest->u32DeadlineMs) < 0)))
+                {
+                    pstBest = pstJob;
+                }
+                else
+                {}
+            }
+
+            if (NULL != pstBest)
+            {
+                ProductLine_astRunJob[u8Run]       = *pstBest;
+                ProductLine_astRunJob[u8Run].boEnd = false;
+                pstBest->boUsed                    = false;
+            }
+            else
+            {}
+
+            IRQLOCK_RESTORE(u32PriMask);
+        }
+    }
+}
 
-        if (ProductLine_stI2cRWMsgs.Read_t.u8Count < au8ProDReadDataSize[ProductLine_stI2cRWMsgs.Read_t.enTyp])
+static bool ProductLine_boDevBusy(uint8_t u8Dev) // 该器件已有任务在执行
+{
+    uint8_t u8Run;
+
+    for (u8Run = 0; u8Run < PRODLINE_RUN_NUM; u8Run++)
+    {
+        if (ProductLine_astRunJob[u8Run].boUsed && (ProductLine_astJobCfg[ProductLine_astRunJob[u8Run].u8Job].u8Dev == u8Dev))
         {
-            MstRecvByType(I2C0_ID, 1, I2C_RESTART_AND_STOP_DISABLE);
+            return true;
         }
         else
+        {}
+    }
+
+    return false;
+}
+
+static void ProductLine_vJobEnd(ProductLine_stJob *pstRun) // 任务处理函数调用ProductLine_vJobDone后结束
+{
+    ProductLine_stJobStat *pstStat  = &ProductLine_astJobStat[pstRun->u8Job];
+    uint32_t               u32LatMs = ProductLine_u32Ms - pstRun->u32PostMs;
+    bool                   boLate   = ((int32_t)(ProductLine_u32Ms - pstRun->u32DeadlineMs) > 0);
+    uint32_t               u32PriMask;
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    pstStat->u16Done++;
+
+    if (boLate)
+    {
+        pstStat->u16Late++;
+    }
+    else
+    {}
+
+    if (u32LatMs > pstStat->u16MaxLatMs)
+    {
+        pstStat->u16MaxLatMs = (u32LatMs > 0xFFFFu) ? 0xFFFFu : (uint16_t)u32LatMs;
+    }
+    else
+    {}
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    pstRun->boUsed = false;
+
+    if (NULL != pstRun->pfDone)
+    {
+        pstRun->pfDone((ProductLine_enWorkSts)pstRun->u8Job, boLate);
+    }
+    else
+    {}
+}
+
+bool ProductLine_boI2cWrite(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len)
+{
+    return ProductLine_boI2cWriteCb(u8Dev, pu8Data, u8Len, NULL);
+}
+
+bool ProductLine_boI2cWriteCb(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len, ProductLine_pfWrDone pfDone) // 提交写事务，数据已拷贝，调用后可立即释放
+{
+    ProductLine_stWrSlot *pstSlot   = &ProductLine_astWrSlot[ProductLine_u8WrSlotIdx];
+    uint8_t               u8AddrLen = RegCache_u8AddrLen(u8Dev);
+    uint16_t              u16Reg    = 0;
+    uint8_t               u8Idx     = 0;
+
+    if ((u8Len > PRODLINE_WR_DATA_SIZE) || I2cXfer_boBusy(&pstSlot->stDesc))
+    {
+        return false; // 槽位用尽，下个周期重试
+    }
+    else
+    {}
+
+    if (ProductLine_boWrCached(u8Dev, pu8Data, u8Len))
+    {
+        return true; // 器件中已是这些值，不占用总线
+    }
+    else
+    {}
+
+    memcpy(pstSlot->au8Data, pu8Data, u8Len);
+    u16Reg = ProductLine_u16RegAddr(pu8Data, u8AddrLen);
+
+    pstSlot->stDesc.u8DevAddr = u8Dev;
+    pstSlot->stDesc.pu8Tx     = pstSlot->au8Data;
+    pstSlot->stDesc.u8TxLen   = u8Len;
+    pstSlot->stDesc.pu8Rx     = NULL;
+    pstSlot->stDesc.u8RxLen   = 0;
+    pstSlot->stDesc.pfDone    = (NULL != pfDone) ? ProductLine_vI2cWriteDone : NULL;
+    pstSlot->stDesc.pu16Cmd   = NULL;
+    pstSlot->pfDone           = pfDone;
+
+    RegCache_vBegin(u8Dev);
+
+    for (u8Idx = u8AddrLen; (0u != u8AddrLen) && (u8Idx < u8Len); u8Idx++)
+    {
+        RegCache_vPut(u8Dev, (uint16_t)(u16Reg + u8Idx - u8AddrLen), pu8Data[u8Idx], true);
+    }
+
+    if (I2cXfer_boSubmit(&pstSlot->stDesc))
+    {
+        ProductLine_u8WrSlotIdx = (ProductLine_u8WrSlotIdx + 1) % PRODLINE_WR_SLOT_NUM;
+        return true;
+    }
+    else
+    {
+        RegCache_vCancel(u8Dev);
+        return false;
+    }
+}
+
+bool ProductLine_boI2cRead(ProductLine_enI2cReadTyp enTyp, uint8_t u8Dev, uint8_t u8Reg) // 提交读事务，完成后在中断中清除aboEndFlg
+{
+    I2cXfer_stDesc *pstDesc = &ProductLine_astRdDesc[enTyp];
+    uint8_t         au8Shadow[PRODLINE_READ_DATA_SIZE];
+    uint8_t         u8Idx = 0;
+
+    if (I2cXfer_boBusy(pstDesc))
+    {
+        return false;
+    }
+    else
+    {}
+
+    while ((u8Idx < au8ProDReadDataSize[enTyp]) && RegCache_boGet(u8Dev, (uint16_t)(u8Reg + u8Idx), &au8Shadow[u8Idx]))
+    {
+        u8Idx++;
+    }
+
+    if (u8Idx == au8ProDReadDataSize[enTyp]) // 本机写入过的寄存器直接从影子寄存器返回
+    {
+        memcpy(ProductLine_stI2cRWMsgs.Read_t.au8Data[enTyp], au8Shadow, u8Idx);
+
+        ProductLine_stI2cRWMsgs.Read_t.au8Count[enTyp]  = u8Idx;
+        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp] = false;
+        return true;
+    }
+    else
+    {}
+
+    ProductLine_au8RdReg[enTyp] = u8Reg;
+
+    pstDesc->u8DevAddr = u8Dev;
+    pstDesc->pu8Tx     = &ProductLine_au8RdReg[enTyp];
+    pstDesc->u8TxLen   = 1;
+    pstDesc->pu8Rx     = ProductLine_stI2cRWMsgs.Read_t.au8Data[enTyp];
+    pstDesc->u8RxLen   = au8ProDReadDataSize[enTyp];
+    pstDesc->pfDone    = ProductLine_vI2cReadDone;
+    pstDesc->pu16Cmd   = NULL;
+
+    ProductLine_stI2cRWMsgs.Read_t.au8Count[enTyp]  = 0;
+    ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp] = true;
+
+    if (I2cXfer_boSubmit(pstDesc))
+    {
+        return true;
+    }
+    else
+    {
+        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp] = false;
+        return false;
+    }
+}
+
+static void ProductLine_vI2cReadDone(I2cXfer_stDesc *pstDesc) // 在i2c中断中结束读取，由主循环立即推进等待该数据的任务
+{
+    uint8_t u8Typ = (uint8_t)(pstDesc - ProductLine_astRdDesc);
+    uint8_t u8Idx;
+
+    if (I2cXfer_Done == pstDesc->enSts)
+    {
+        ProductLine_stI2cRWMsgs.Read_t.au8Count[u8Typ] = pstDesc->u8RxLen;
+
+        for (u8Idx = 0; u8Idx < pstDesc->u8RxLen; u8Idx++)
         {
-            MstRecvByType(I2C0_ID, 1, I2C_STOP_EN);
+            RegCache_vPut(pstDesc->u8DevAddr, (uint16_t)(ProductLine_au8RdReg[u8Typ] + u8Idx), pstDesc->pu8Rx[u8Idx], false);
         }
     }
+    else
+    {}
+
+    ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[u8Typ] = false;
+
+    Sch_PostEvent(SCH_EVENT_I2C_DONE);
+}
+
+static void ProductLine_vI2cWriteDone(I2cXfer_stDesc *pstDesc) // 在i2c中断中通知提交者写入是否成功
+{
+    ProductLine_stWrSlot *pstSlot = (ProductLine_stWrSlot *)pstDesc;
+
+    pstSlot->pfDone(I2cXfer_Done == pstDesc->enSts);
 }
 
-void ProductLine_vI2cStopHandle(void) // 在i2c读取停止中断清除标志位
+static bool ProductLine_boWrCached(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len) // 写入的每个寄存器都已是目标值
 {
-    if ((ProductLine_stI2cRWMsgs.Read_t.u8Count >= au8ProDReadDataSize[ProductLine_stI2cRWMsgs.Read_t.enTyp]) && ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProductLine_stI2cRWMsgs.Read_t.enTyp])
+    uint8_t  u8AddrLen = RegCache_u8AddrLen(u8Dev);
+    uint16_t u16Reg    = 0;
+    uint8_t  u8Idx     = 0;
+    bool     boSame    = false;
+
+    if ((0u != u8AddrLen) && (u8Len > u8AddrLen))
     {
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProductLine_stI2cRWMsgs.Read_t.enTyp] = false;
-        ProductLine_stI2cRWMsgs.Read_t.u8Count                                         = 0;
+        u16Reg = ProductLine_u16RegAddr(pu8Data, u8AddrLen);
+        boSame = true;
+
+        for (u8Idx = u8AddrLen; (u8Idx < u8Len) && boSame; u8Idx++)
+        {
+            boSame = RegCache_boSame(u8Dev, (uint16_t)(u16Reg + u8Idx - u8AddrLen), pu8Data[u8Idx]);
+        }
     }
+    else
+    {}
+
+    return boSame;
+}
+
+static uint16_t ProductLine_u16RegAddr(const uint8_t *pu8Data, uint8_t u8AddrLen) // 写数据开头的寄存器地址，高字节在前
+{
+    return (REGSEQ_ADDR16 == u8AddrLen) ? (uint16_t)((pu8Data[0] << 8u) | pu8Data[1]) : pu8Data[0];
 }
 /*****************************************************************************
  * End file ProductLine.c
@@ -0,0 +1,381 @@
+/*****************************************************************************
+ * @file RegCache.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "RegCache.h"
+#include "Config.h"
+#include "RegSeq.h"
+#include "IrqLock.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define REGCACHE_FLG_VALID (0x01u)
+#define REGCACHE_FLG_DIRTY (0x02u) // 已提交写入，总线尚未确认
+
+#define REGCACHE_NONE    (0xFFu)
+#define REGCACHE_DEV_NUM (sizeof(RegCache_astDevCfg) / sizeof(RegCache_astDevCfg[0]))
+#define REGCACHE_VOL_NUM(Tbl) ((uint8_t)(sizeof(Tbl) / sizeof((Tbl)[0])))
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+typedef struct
+{
+    uint16_t u16From;
+    uint16_t u16To;
+} RegCache_stRange;
+
+typedef struct
+{
+    uint8_t                 u8DevAddr;
+    uint8_t                 u8AddrLen;
+    const RegCache_stRange *pstVol; // 易变寄存器（状态、中断标志、计数、自清零控制），不缓存
+    uint8_t                 u8VolNum;
+} RegCache_stDevCfg;
+
+typedef struct
+{
+    uint16_t u16Reg;
+    uint8_t  u8Dev;
+    uint8_t  u8Val;
+    uint8_t  u8Flg;
+} RegCache_stEntry;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+static const RegCache_stRange RegCache_astSerDesVol[] = {
+    {0x0010u, 0x002Fu}, // 复位控制、LOCK状态、中断标志及链路错误计数
+};
+
+static const RegCache_stRange RegCache_astBklVol[] = {
+    {0x0Au, 0x0Fu}, // 故障及状态寄存器
+};
+
+/* 只缓存本机写入后不会自行改变的器件，触摸、ADC、EEPROM的数据每次都要从总线读取 */
+static const RegCache_stDevCfg RegCache_astDevCfg[] = {
+    {DEV_SER, REGSEQ_ADDR16, RegCache_astSerDesVol, REGCACHE_VOL_NUM(RegCache_astSerDesVol)},
+    {DEV_DES, REGSEQ_ADDR16, RegCache_astSerDesVol, REGCACHE_VOL_NUM(RegCache_astSerDesVol)},
+    {DEV_BKL, REGSEQ_ADDR8, RegCache_astBklVol, REGCACHE_VOL_NUM(RegCache_astBklVol)},
+};
+
+static RegCache_stEntry RegCache_astEntry[REGCACHE_SIZE];
+static uint8_t          RegCache_au8Pending[REGCACHE_DEV_NUM]; // 各器件已提交未结束的写事务数
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static uint8_t RegCache_u8DevIdx(uint8_t u8Dev);
+static bool    RegCache_boCachable(uint8_t u8Dev, uint16_t u16Reg);
+static uint8_t RegCache_u8Hash(uint8_t u8Dev, uint16_t u16Reg);
+static uint8_t RegCache_u8Find(uint8_t u8Dev, uint16_t u16Reg);
+static void    RegCache_vClear(uint8_t u8Dev, uint8_t u8Mask);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+uint8_t RegCache_u8AddrLen(uint8_t u8Dev)
+{
+    uint8_t u8Idx = RegCache_u8DevIdx(u8Dev);
+
+    return (REGCACHE_NONE != u8Idx) ? RegCache_astDevCfg[u8Idx].u8AddrLen : 0u;
+}
+
+bool RegCache_boGet(uint8_t u8Dev, uint16_t u16Reg, uint8_t *pu8Val)
+{
+    uint32_t u32PriMask;
+    uint8_t  u8Slot;
+    bool     boHit = false;
+
+    if (!RegCache_boCachable(u8Dev, u16Reg))
+    {
+        return false;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    u8Slot = RegCache_u8Find(u8Dev, u16Reg);
+
+    if ((REGCACHE_NONE != u8Slot) && (REGCACHE_FLG_VALID == RegCache_astEntry[u8Slot].u8Flg))
+    {
+        *pu8Val = RegCache_astEntry[u8Slot].u8Val;
+        boHit   = true;
+    }
+    else
+    {}
+
+    IRQLOCK_RESTORE(u32PriMask);
+
+    return boHit;
+}
+
+bool RegCache_boSame(uint8_t u8Dev, uint16_t u16Reg, uint8_t u8Val)
+{
+    uint8_t u8Cur = 0u;
+
+    return (RegCache_boGet(u8Dev, u16Reg, &u8Cur) && (u8Cur == u8Val));
+}
+
+void RegCache_vPut(uint8_t u8Dev, uint16_t u16Reg, uint8_t u8Val, bool boDirty)
+{
+    uint32_t          u32PriMask;
+    uint8_t           u8Slot;
+    uint8_t           u8Probe;
+    RegCache_stEntry *pstEntry = NULL;
+
+    if (!RegCache_boCachable(u8Dev, u16Reg))
+    {
+        return;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    u8Slot = RegCache_u8Find(u8Dev, u16Reg);
+
+    if (REGCACHE_NONE != u8Slot)
+    {
+        pstEntry = &RegCache_astEntry[u8Slot];
+    }
+    else
+    {
+        u8Slot = RegCache_u8Hash(u8Dev, u16Reg);
+
+        for (u8Probe = 0u; (u8Probe < REGCACHE_PROBE_MAX) && (NULL == pstEntry); u8Probe++)
+        {
+            if (0u == RegCache_astEntry[u8Slot].u8Flg)
+            {
+                pstEntry         = &RegCache_astEntry[u8Slot];
+                pstEntry->u8Dev  = u8Dev;
+                pstEntry->u16Reg = u16Reg;
+            }
+            else
+            {
+                u8Slot = (uint8_t)((u8Slot + 1u) & (REGCACHE_SIZE - 1u));
+            }
+        }
+    }
+
+    if (NULL == pstEntry)
+    {
+        // 冲突槽位已满，该寄存器不缓存
+    }
+    else if ((!boDirty) && (0u != (pstEntry->u8Flg & REGCACHE_FLG_DIRTY)))
+    {
+        // 读取期间有写入待确认，以写入值为准
+    }
+    else if ((REGCACHE_FLG_VALID == pstEntry->u8Flg) && (pstEntry->u8Val == u8Val))
+    {
+        // 值未变化，保持有效
+    }
+    else
+    {
+        pstEntry->u8Val = u8Val;
+        pstEntry->u8Flg = boDirty ? (REGCACHE_FLG_VALID | REGCACHE_FLG_DIRTY) : REGCACHE_FLG_VALID;
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+void RegCache_vBegin(uint8_t u8Dev)
+{
+    uint32_t u32PriMask;
+    uint8_t  u8Idx = RegCache_u8DevIdx(u8Dev);
+
+    if (REGCACHE_NONE != u8Idx)
+    {
+        IRQLOCK_SAVE(u32PriMask);
+        RegCache_au8Pending[u8Idx]++;
+        IRQLOCK_RESTORE(u32PriMask);
+    }
+    else
+    {}
+}
+
+/* 同一器件有多个写事务排队时不区分脏项属于哪一个，全部结束后才统一确认 */
+void RegCache_vDone(uint8_t u8Dev, bool boOk)
+{
+    uint32_t u32PriMask;
+    uint8_t  u8Idx = RegCache_u8DevIdx(u8Dev);
+    uint8_t  u8Slot;
+
+    if (REGCACHE_NONE == u8Idx)
+    {
+        return;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    if (RegCache_au8Pending[u8Idx] > 0u)
+    {
+        RegCache_au8Pending[u8Idx]--;
+    }
+    else
+    {}
+
+    if (!boOk)
+    {
+        RegCache_vClear(u8Dev, REGCACHE_FLG_VALID); // NACK后器件状态未知（可能已复位）
+    }
+    else if (0u == RegCache_au8Pending[u8Idx])
+    {
+        for (u8Slot = 0u; u8Slot < REGCACHE_SIZE; u8Slot++)
+        {
+            if (RegCache_astEntry[u8Slot].u8Dev == u8Dev)
+            {
+                RegCache_astEntry[u8Slot].u8Flg &= (uint8_t)(~REGCACHE_FLG_DIRTY);
+            }
+            else
+            {}
+        }
+    }
+    else
+    {}
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+void RegCache_vCancel(uint8_t u8Dev) // 其他排队事务的脏项一并丢弃，只会少命中
+{
+    uint32_t u32PriMask;
+    uint8_t  u8Idx = RegCache_u8DevIdx(u8Dev);
+
+    if (REGCACHE_NONE == u8Idx)
+    {
+        return;
+    }
+    else
+    {}
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    if (RegCache_au8Pending[u8Idx] > 0u)
+    {
+        RegCache_au8Pending[u8Idx]--;
+    }
+    else
+    {}
+
+    RegCache_vClear(u8Dev, REGCACHE_FLG_DIRTY);
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+void RegCache_vDrop(uint8_t u8Dev)
+{
+    uint32_t u32PriMask;
+
+    IRQLOCK_SAVE(u32PriMask);
+
+    if (REGCACHE_DEV_ALL == u8Dev)
+    {
+        memset(RegCache_astEntry, 0, sizeof(RegCache_astEntry));
+    }
+    else
+    {
+        RegCache_vClear(u8Dev, REGCACHE_FLG_VALID);
+    }
+
+    IRQLOCK_RESTORE(u32PriMask);
+}
+
+static uint8_t RegCache_u8DevIdx(uint8_t u8Dev)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < REGCACHE_DEV_NUM; u8Idx++)
+    {
+        if (RegCache_astDevCfg[u8Idx].u8DevAddr == u8Dev)
+        {
+            return u8Idx;
+        }
+        else
+        {}
+    }
+
+    return REGCACHE_NONE;
+}
+
+static bool RegCache_boCachable(uint8_t u8Dev, uint16_t u16Reg)
+{
+    const RegCache_stDevCfg *pstCfg = NULL;
+    uint8_t                  u8Idx  = RegCache_u8DevIdx(u8Dev);
+
+    if (REGCACHE_NONE == u8Idx)
+    {
+        return false;
+    }
+    else
+    {
+        pstCfg = &RegCache_astDevCfg[u8Idx];
+    }
+
+    for (u8Idx = 0u; u8Idx < pstCfg->u8VolNum; u8Idx++)
+    {
+        if ((u16Reg >= pstCfg->pstVol[u8Idx].u16From) && (u16Reg <= pstCfg->pstVol[u8Idx].u16To))
+        {
+            return false;
+        }
+        else
+        {}
+    }
+
+    return true;
+}
+
+static uint8_t RegCache_u8Hash(uint8_t u8Dev, uint16_t u16Reg) // 乘法散列取高位，连续地址分散到不同槽位
+{
+    uint16_t u16Key = (uint16_t)(u16Reg ^ ((uint16_t)u8Dev << 9u));
+
+    return (uint8_t)((uint16_t)(u16Key * 0x9E37u) >> 9u) & (REGCACHE_SIZE - 1u);
+}
+
+static uint8_t RegCache_u8Find(uint8_t u8Dev, uint16_t u16Reg) // 删除后不留空洞标记，因此查找整个冲突窗口
+{
+    uint8_t u8Slot = RegCache_u8Hash(u8Dev, u16Reg);
+    uint8_t u8Probe;
+
+    for (u8Probe = 0u; u8Probe < REGCACHE_PROBE_MAX; u8Probe++)
+    {
+        if ((0u != RegCache_astEntry[u8Slot].u8Flg) && (RegCache_astEntry[u8Slot].u8Dev == u8Dev) && (RegCache_astEntry[u8Slot].u16Reg == u16Reg))
+        {
+            return u8Slot;
+        }
+        else
+        {}
+
+        u8Slot = (uint8_t)((u8Slot + 1u) & (REGCACHE_SIZE - 1u));
+    }
+
+    return REGCACHE_NONE;
+}
+
+static void RegCache_vClear(uint8_t u8Dev, uint8_t u8Mask) // 释放该器件带u8Mask标志的项，调用前已关中断
+{
+    uint8_t u8Slot;
+
+    for (u8Slot = 0u; u8Slot < REGCACHE_SIZE; u8Slot++)
+    {
+        if ((RegCache_astEntry[u8Slot].u8Dev == u8Dev) && (0u != (RegCache_astEntry[u8Slot].u8Flg & u8Mask)))
+        {
+            RegCache_astEntry[u8Slot].u8Flg = 0u;
+        }
+        else
+        {}
+    }
+}
+/*****************************************************************************
+ * End file RegCache.c
+ *****************************************************************************/
@@ -0,0 +1,744 @@
+/*****************************************************************************
+ * @file RegSeq.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "RegSeq.h"
+#include "RegCache.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static bool     RegSeq_boStep(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boTblStep(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boDelay(RegSeq_stCtx *pstCtx, uint16_t u16Ms);
+static bool     RegSeq_boVerify(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp);
+static bool     RegSeq_boFillTbl(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boFillOps(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boChkStep(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boFillChk(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs);
+static bool     RegSeq_boChkDone(RegSeq_stCtx *pstCtx);
+static void     RegSeq_vChkLog(RegSeq_stCtx *pstCtx, const I2cSendData *pstEnt, uint8_t u8Exp, uint8_t u8Act);
+static bool     RegSeq_boSubmit(RegSeq_stCtx *pstCtx, uint8_t u8Dev, uint16_t u16Len, uint8_t *pu8Rx, uint8_t u8RxLen);
+static uint16_t RegSeq_u16WrLen(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16Idx);
+static bool     RegSeq_boOpCached(const RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp);
+static bool     RegSeq_boAnyBusy(const RegSeq_stCtx *pstCtx);
+static uint16_t RegSeq_u16EncodeAddr(uint16_t *pu16Cmd, uint16_t u16Reg, uint8_t u8AddrLen);
+static bool     RegSeq_boFindLast(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16From, const I2cSendData *pstKey, uint8_t *pu8Data);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void RegSeq_vStart(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp)
+{
+    pstCtx->pstOp        = pstOp;
+    pstCtx->u16Pc        = 0u;
+    pstCtx->u8Dev        = 0u;
+    pstCtx->u8AddrLen    = REGSEQ_ADDR16;
+    pstCtx->boTbl        = false;
+    pstCtx->boDelay      = false;
+    pstCtx->u16DelayTick = 0u;
+    pstCtx->u16HoldTick  = 0u;
+    pstCtx->boVerify     = false;
+    pstCtx->boChk        = false;
+}
+
+bool RegSeq_boRun(RegSeq_stCtx *pstCtx, uint16_t u16BudgetUs)
+{
+    uint32_t u32SpentUs = 0u;
+
+    if (NULL == pstCtx->pstOp)
+    {
+        return true;
+    }
+    else
+    {}
+
+    while (RegSeq_boStep(pstCtx, &pstCtx->pstOp[pstCtx->u16Pc], u16BudgetUs, &u32SpentUs))
+    {}
+
+    return ((RegSeq_OpEnd == pstCtx->pstOp[pstCtx->u16Pc].u8Op) && (!RegSeq_boAnyBusy(pstCtx)));
+}
+
+uint16_t RegSeq_u16RunLen(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16Idx)
+{
+    uint16_t u16Len = 1u;
+
+    while (((u16Idx + u16Len) < u16Num) && (u16Len < REGSEQ_RUN_MAX) &&
+           (pstTbl[u16Idx + u16Len].u8DstAddr == pstTbl[u16Idx].u8DstAddr) &&
+           (pstTbl[u16Idx + u16Len].u16DstRegAddr == (uint16_t)(pstTbl[u16Idx].u16DstRegAddr + u16Len)))
+    {
+        u16Len++;
+    }
+
+    return u16Len;
+}
+
+uint32_t RegSeq_u32BusUs(uint8_t u8Dev, uint8_t u8AddrLen, uint16_t u16DataLen)
+{
+    return I2cXfer_u32BusNs(I2cXfer_enDevSpeed(u8Dev), (uint16_t)(1u + u8AddrLen + u16DataLen)) / 1000u;
+}
+
+/* 从pstFrom切换到pstTo时需要写入的寄存器：按pstTo的顺序输出最终值与pstFrom不同的表项，
+ * 跳过延时项和pstTo中被后续表项覆盖的项，返回差异总数（可能大于u16OutMax，此时只输出前u16OutMax项） */
+uint16_t RegSeq_u16Delta(const I2cSendData *pstFrom, uint16_t u16FromNum, const I2cSendData *pstTo, uint16_t u16ToNum, I2cSendData *pstOut, uint16_t u16OutMax)
+{
+    uint16_t u16Idx;
+    uint16_t u16Cnt  = 0u;
+    uint8_t  u8Data  = 0u;
+    uint8_t  u8Dummy = 0u;
+
+    for (u16Idx = 0u; u16Idx < u16ToNum; u16Idx++)
+    {
+        if (REGSEQ_DEV_DELAY == pstTo[u16Idx].u8DstAddr)
+        {}
+        else if (RegSeq_boFindLast(pstTo, u16ToNum, u16Idx + 1u, &pstTo[u16Idx], &u8Dummy))
+        {} // 后面还会写同一寄存器，以最后一次为准
+        else if (RegSeq_boFindLast(pstFrom, u16FromNum, 0u, &pstTo[u16Idx], &u8Data) && (u8Data == pstTo[u16Idx].u8RegData))
+        {}
+        else
+        {
+            if (u16Cnt < u16OutMax)
+            {
+                pstOut[u16Cnt] = pstTo[u16Idx];
+            }
+            else
+            {}
+
+            u16Cnt++;
+        }
+    }
+
+    return u16Cnt;
+}
+
+static bool RegSeq_boStep(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp, uint32_t u32BudgetUs, uint32_t *pu32SpentUs) // 执行当前操作，返回false表示本周期停止
+{
+    bool boGoOn = false;
+
+    switch (pstOp->u8Op)
+    {
+        case RegSeq_OpTarget:
+            pstCtx->u8Dev     = pstOp->u8Arg;
+            pstCtx->u8AddrLen = (uint8_t)pstOp->u16Arg;
+            pstCtx->u16Pc++;
+            boGoOn = true;
+            break;
+
+        case RegSeq_OpWr:
+        case RegSeq_OpRun:
+            if ((*pu32SpentUs < u32BudgetUs) && (!I2cXfer_boBusy(&pstCtx->astDesc[pstCtx->u8Buf])))
+            {
+                boGoOn = RegSeq_boFillOps(pstCtx, u32BudgetUs - *pu32SpentUs, pu32SpentUs);
+            }
+            else
+            {}
+            break;
+
+        case RegSeq_OpTbl:
+        case RegSeq_OpCheck:
+            if (!pstCtx->boTbl)
+            {
+                pstCtx->pstTbl    = (const I2cSendData *)pstOp->unPtr.pvArg;
+                pstCtx->u16Num    = pstOp->u16Arg;
+                pstCtx->u16Idx    = 0u;
+                pstCtx->u8AddrLen = pstOp->u8Arg;
+                pstCtx->boTbl     = true;
+                boGoOn            = true;
+            }
+            else if (pstCtx->boChk)
+            {
+                boGoOn = RegSeq_boChkDone(pstCtx);
+            }
+            else if (pstCtx->u16Idx >= pstCtx->u16Num)
+            {
+                pstCtx->boTbl = false;
+                pstCtx->u16Pc++;
+                boGoOn = true;
+            }
+            else if (RegSeq_OpTbl == pstOp->u8Op)
+            {
+                boGoOn = RegSeq_boTblStep(pstCtx, u32BudgetUs, pu32SpentUs);
+            }
+            else
+            {
+                boGoOn = RegSeq_boChkStep(pstCtx, u32BudgetUs, pu32SpentUs);
+            }
+            break;
+
+        case RegSeq_OpDelay:
+            if (RegSeq_boDelay(pstCtx, pstOp->u16Arg))
+            {
+                pstCtx->u16Pc++;
+                boGoOn = true;
+            }
+            else
+            {}
+            break;
+
+        case RegSeq_OpWait:
+            if (RegSeq_boAnyBusy(pstCtx))
+            {}
+            else if (!pstOp->unPtr.pfCond())
+            {
+                pstCtx->u16HoldTick = 0u; // 条件中断后重新计时
+            }
+            else if ((pstCtx->u16HoldTick * MAIN_TASK_MS) >= pstOp->u16Arg)
+            {
+                pstCtx->u16HoldTick = 0u;
+                pstCtx->u16Pc++;
+                boGoOn = true;
+            }
+            else
+            {
+                pstCtx->u16HoldTick++;
+            }
+            break;
+
+        case RegSeq_OpVerify:
+            if (RegSeq_boVerify(pstCtx, pstOp))
+            {
+                pstCtx->u16Pc++;
+                boGoOn = true;
+            }
+            else
+            {}
+            break;
+
+        case RegSeq_OpEnd:
+        default:
+            break;
+    }
+
+    return boGoOn;
+}
+
+static bool RegSeq_boTblStep(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs)
+{
+    bool boGoOn = false;
+
+    if (REGSEQ_DEV_DELAY == pstCtx->pstTbl[pstCtx->u16Idx].u8DstAddr)
+    {
+        if (RegSeq_boDelay(pstCtx, pstCtx->pstTbl[pstCtx->u16Idx].u16DstRegAddr))
+        {
+            pstCtx->u16Idx++;
+            boGoOn = true;
+        }
+        else
+        {}
+    }
+    else if ((*pu32SpentUs >= u32BudgetUs) || I2cXfer_boBusy(&pstCtx->astDesc[pstCtx->u8Buf]))
+    {
+        // 本周期预算用完，或两个缓存都在总线上
+    }
+    else
+    {
+        boGoOn = RegSeq_boFillTbl(pstCtx, u32BudgetUs - *pu32SpentUs, pu32SpentUs); // 传输队列满时下个周期再提交
+    }
+
+    return boGoOn;
+}
+
+static bool RegSeq_boDelay(RegSeq_stCtx *pstCtx, uint16_t u16Ms) // 延时结束返回true
+{
+    bool boEnd = false;
+
+    if (RegSeq_boAnyBusy(pstCtx))
+    {
+        // 等前面的写入真正结束再计时
+    }
+    else if (!pstCtx->boDelay)
+    {
+        if (0u == u16Ms)
+        {
+            boEnd = true;
+        }
+        else
+        {
+            pstCtx->boDelay      = true;
+            pstCtx->u16DelayTick = ((u16Ms + MAIN_TASK_MS - 1u) / MAIN_TASK_MS) - 1u; // 本周期算作第一个周期
+        }
+    }
+    else if (pstCtx->u16DelayTick > 0u)
+    {
+        pstCtx->u16DelayTick--;
+    }
+    else
+    {
+        pstCtx->boDelay = false;
+        boEnd           = true;
+    }
+
+    return boEnd;
+}
+
+static bool RegSeq_boVerify(RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp) // 回读结束返回true
+{
+    I2cXfer_stDesc *pstDesc = &pstCtx->astDesc[pstCtx->u8Buf];
+    bool            boEnd   = false;
+
+    if (!pstCtx->boVerify)
+    {
+        if (!RegSeq_boAnyBusy(pstCtx))
+        {
+            pstCtx->au8VerifyAddr[0] = (uint8_t)(pstOp->u16Arg >> 8u);
+            pstCtx->au8VerifyAddr[1] = (uint8_t)pstOp->u16Arg;
+
+            pstDesc->u8DevAddr = pstCtx->u8Dev;
+            pstDesc->pu8Tx     = &pstCtx->au8VerifyAddr[REGSEQ_ADDR16 - pstCtx->u8AddrLen];
+            pstDesc->u8TxLen   = pstCtx->u8AddrLen;
+            pstDesc->pu8Rx     = &pstCtx->u8VerifyData;
+            pstDesc->u8RxLen   = 1u;
+            pstDesc->pfDone    = NULL;
+            pstDesc->pu16Cmd   = NULL;
+            pstDesc->u16CmdLen = 0u;
+
+            pstCtx->boVerify = I2cXfer_boSubmit(pstDesc);
+        }
+        else
+        {}
+    }
+    else if (!I2cXfer_boBusy(pstDesc))
+    {
+        if (I2cXfer_Done == pstDesc->enSts)
+        {
+            RegCache_vPut(pstCtx->u8Dev, pstOp->u16Arg, pstCtx->u8VerifyData, false); // 以器件实际值为准
+        }
+        else
+        {}
+
+        if ((I2cXfer_Done != pstDesc->enSts) || (pstCtx->u8VerifyData != pstOp->u8Arg))
+        {
+            pstCtx->u16VerifyErr++;
+        }
+        else
+        {}
+
+        pstCtx->boVerify = false;
+        boEnd            = true;
+    }
+    else
+    {}
+
+    return boEnd;
+}
+
+static bool RegSeq_boFillTbl(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs)
+{
+    const I2cSendData *pstTbl  = pstCtx->pstTbl;
+    uint16_t          *pu16Cmd = pstCtx->au16Cmd[pstCtx->u8Buf];
+
+    uint16_t u16Idx   = pstCtx->u16Idx;
+    uint16_t u16Len   = 0u;
+    uint16_t u16Run   = 0u;
+    uint16_t u16Cnt   = 0u;
+    uint32_t u32RunUs = 0u;
+    uint32_t u32BusUs = 0u;
+    bool     boFull   = false;
+
+    /* 一个描述符只能对应一个从机地址，器件切换或遇到延时项时留到下一个缓存；
+     * 首段总是放入，保证预算再小也能前进；器件中已是目标值的表项直接跳过 */
+    while ((!boFull) && (u16Idx < pstCtx->u16Num) && (pstTbl[u16Idx].u8DstAddr == pstTbl[pstCtx->u16Idx].u8DstAddr))
+    {
+        u16Run   = RegSeq_u16WrLen(pstTbl, pstCtx->u16Num, u16Idx);
+        u32RunUs = RegSeq_u32BusUs(pstTbl[u16Idx].u8DstAddr, pstCtx->u8AddrLen, u16Run);
+
+        if (0u == u16Run)
+        {
+            u16Idx++;
+        }
+        else if ((((uint32_t)u16Len + pstCtx->u8AddrLen + u16Run) <= REGSEQ_CMD_SIZE) && ((0u == u16Len) || ((u32BusUs + u32RunUs) <= u32BudgetUs)))
+        {
+            u16Len += RegSeq_u16EncodeAddr(&pu16Cmd[u16Len], pstTbl[u16Idx].u16DstRegAddr, pstCtx->u8AddrLen);
+
+            for (u16Cnt = 0u; u16Cnt < u16Run; u16Cnt++)
+            {
+                pu16Cmd[u16Len++] = I2CXFER_CMD_WR(pstTbl[u16Idx + u16Cnt].u8RegData);
+            }
+
+            pu16Cmd[u16Len - 1u] |= I2CXFER_CMD_STOP; // 器件寄存器地址自增，STOP结束本段
+
+            u32BusUs += u32RunUs;
+            u16Idx += u16Run;
+        }
+        else
+        {
+            boFull = true;
+        }
+    }
+
+    if (0u == u16Len)
+    {
+        pstCtx->u16Idx = u16Idx; // 全部命中影子寄存器，无需传输
+        return true;
+    }
+    else
+    {}
+
+    RegCache_vBegin(pstTbl[pstCtx->u16Idx].u8DstAddr);
+
+    for (u16Cnt = pstCtx->u16Idx; u16Cnt < u16Idx; u16Cnt++)
+    {
+        RegCache_vPut(pstTbl[u16Cnt].u8DstAddr, pstTbl[u16Cnt].u16DstRegAddr, pstTbl[u16Cnt].u8RegData, true);
+    }
+
+    if (RegSeq_boSubmit(pstCtx, pstTbl[pstCtx->u16Idx].u8DstAddr, u16Len, NULL, 0u))
+    {
+        pstCtx->u16Idx = u16Idx;
+        *pu32SpentUs += u32BusUs;
+        return true;
+    }
+    else
+    {
+        RegCache_vCancel(pstTbl[pstCtx->u16Idx].u8DstAddr);
+        return false;
+    }
+}
+
+static bool RegSeq_boFillOps(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs) // 连续的WR/RUN操作拼成一个命令流
+{
+    const RegSeq_stOp *pstOp   = NULL;
+    const uint8_t     *pu8Data = NULL;
+    uint16_t          *pu16Cmd = pstCtx->au16Cmd[pstCtx->u8Buf];
+
+    uint16_t u16Pc    = pstCtx->u16Pc;
+    uint16_t u16Len   = 0u;
+    uint16_t u16Cnt   = 0u;
+    uint8_t  u8DatLen = 0u;
+    uint32_t u32RunUs = 0u;
+    uint32_t u32BusUs = 0u;
+    bool     boFull   = false;
+
+    while (!boFull)
+    {
+        pstOp    = &pstCtx->pstOp[u16Pc];
+        u8DatLen = (RegSeq_OpRun == pstOp->u8Op) ? pstOp->u8Arg : 1u;
+        u32RunUs = RegSeq_u32BusUs(pstCtx->u8Dev, pstCtx->u8AddrLen, u8DatLen);
+
+        if ((RegSeq_OpWr != pstOp->u8Op) && (RegSeq_OpRun != pstOp->u8Op))
+        {
+            boFull = true;
+        }
+        else if (RegSeq_boOpCached(pstCtx, pstOp))
+        {
+            u16Pc++;
+        }
+        else if ((((uint32_t)u16Len + pstCtx->u8AddrLen + u8DatLen) <= REGSEQ_CMD_SIZE) && ((0u == u16Len) || ((u32BusUs + u32RunUs) <= u32BudgetUs)))
+        {
+            pu8Data = (RegSeq_OpRun == pstOp->u8Op) ? (const uint8_t *)pstOp->unPtr.pvArg : &pstOp->u8Arg;
+
+            u16Len += RegSeq_u16EncodeAddr(&pu16Cmd[u16Len], pstOp->u16Arg, pstCtx->u8AddrLen);
+
+            for (u16Cnt = 0u; u16Cnt < u8DatLen; u16Cnt++)
+            {
+                pu16Cmd[u16Len++] = I2CXFER_CMD_WR(pu8Data[u16Cnt]);
+            }
+
+            pu16Cmd[u16Len - 1u] |= I2CXFER_CMD_STOP;
+
+            u32BusUs += u32RunUs;
+            u16Pc++;
+        }
+        else
+        {
+            boFull = true;
+        }
+    }
+
+    if (0u == u16Len)
+    {
+        pstCtx->u16Pc = u16Pc;
+        return true;
+    }
+    else
+    {}
+
+    RegCache_vBegin(pstCtx->u8Dev);
+
+    for (pstOp = &pstCtx->pstOp[pstCtx->u16Pc]; pstOp < &pstCtx->pstOp[u16Pc]; pstOp++)
+    {
+        u8DatLen = (RegSeq_OpRun == pstOp->u8Op) ? pstOp->u8Arg : 1u;
+        pu8Data  = (RegSeq_OpRun == pstOp->u8Op) ? (const uint8_t *)pstOp->unPtr.pvArg : &pstOp->u8Arg;
+
+        for (u16Cnt = 0u; u16Cnt < u8DatLen; u16Cnt++)
+        {
+            RegCache_vPut(pstCtx->u8Dev, (uint16_t)(pstOp->u16Arg + u16Cnt), pu8Data[u16Cnt], true);
+        }
+    }
+
+    if (RegSeq_boSubmit(pstCtx, pstCtx->u8Dev, u16Len, NULL, 0u))
+    {
+        pstCtx->u16Pc = u16Pc;
+        *pu32SpentUs += u32BusUs;
+        return true;
+    }
+    else
+    {
+        RegCache_vCancel(pstCtx->u8Dev);
+        return false;
+    }
+}
+
+static bool RegSeq_boChkStep(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs)
+{
+    bool boGoOn = false;
+
+    if (REGSEQ_DEV_DELAY == pstCtx->pstTbl[pstCtx->u16Idx].u8DstAddr)
+    {
+        pstCtx->u16Idx++; // 回读时不需要延时
+        boGoOn = true;
+    }
+    else if ((*pu32SpentUs >= u32BudgetUs) || RegSeq_boAnyBusy(pstCtx))
+    {
+        // 前面的写入全部结束后再回读
+    }
+    else
+    {
+        boGoOn = RegSeq_boFillChk(pstCtx, u32BudgetUs - *pu32SpentUs, pu32SpentUs);
+    }
+
+    return boGoOn;
+}
+
+static bool RegSeq_boFillChk(RegSeq_stCtx *pstCtx, uint32_t u32BudgetUs, uint32_t *pu32SpentUs) // 每段 {START, 地址, RESTART, 读D0..Dn, STOP}，多段拼成一个命令流
+{
+    const I2cSendData *pstTbl  = pstCtx->pstTbl;
+    uint16_t          *pu16Cmd = pstCtx->au16Cmd[pstCtx->u8Buf];
+
+    uint16_t u16Idx   = pstCtx->u16Idx;
+    uint16_t u16Len   = 0u;
+    uint16_t u16Run   = 0u;
+    uint16_t u16Cnt   = 0u;
+    uint8_t  u8RxLen  = 0u;
+    uint8_t  u8Buf    = pstCtx->u8Buf;
+    uint32_t u32RunUs = 0u;
+    uint32_t u32BusUs = 0u;
+    bool     boFull   = false;
+
+    while ((!boFull) && (u16Idx < pstCtx->u16Num) && (pstTbl[u16Idx].u8DstAddr == pstTbl[pstCtx->u16Idx].u8DstAddr))
+    {
+        u16Run   = RegSeq_u16RunLen(pstTbl, pstCtx->u16Num, u16Idx);
+        u32RunUs = RegSeq_u32BusUs(pstTbl[u16Idx].u8DstAddr, pstCtx->u8AddrLen + 1u, u16Run); // 另加重复起始后的从机地址
+
+        if ((((uint32_t)u16Len + pstCtx->u8AddrLen + u16Run) <= REGSEQ_CMD_SIZE) && ((0u == u16Len) || ((u32BusUs + u32RunUs) <= u32BudgetUs)))
+        {
+            u16Len += RegSeq_u16EncodeAddr(&pu16Cmd[u16Len], pstTbl[u16Idx].u16DstRegAddr, pstCtx->u8AddrLen);
+
+            pu16Cmd[u16Len] = I2CXFER_CMD_RD | I2CXFER_CMD_RESTART;
+
+            for (u16Cnt = 1u; u16Cnt < u16Run; u16Cnt++)
+            {
+                pu16Cmd[u16Len + u16Cnt] = I2CXFER_CMD_RD;
+            }
+
+            u16Len += u16Run;
+            pu16Cmd[u16Len - 1u] |= I2CXFER_CMD_STOP;
+
+            u8RxLen += (uint8_t)u16Run;
+            u32BusUs += u32RunUs;
+            u16Idx += u16Run;
+        }
+        else
+        {
+            boFull = true;
+        }
+    }
+
+    if (RegSeq_boSubmit(pstCtx, pstTbl[pstCtx->u16Idx].u8DstAddr, u16Len, pstCtx->au8ChkRx, u8RxLen))
+    {
+        pstCtx->u8ChkBuf  = u8Buf;
+        pstCtx->u16ChkEnd = u16Idx;
+        pstCtx->boChk     = true;
+        *pu32SpentUs += u32BusUs;
+    }
+    else
+    {}
+
+    return false; // 等回读结束后再比较
+}
+
+static bool RegSeq_boChkDone(RegSeq_stCtx *pstCtx) // 回读结束后逐项比较，返回true继续
+{
+    const I2cXfer_stDesc *pstDesc = &pstCtx->astDesc[pstCtx->u8ChkBuf];
+    const I2cSendData    *pstEnt  = NULL;
+
+    uint8_t u8Rx   = 0u;
+    uint8_t u8Exp  = 0u;
+    uint8_t u8Mask = 0xFFu;
+
+    if (I2cXfer_boBusy(pstDesc))
+    {
+        return false;
+    }
+    else if (I2cXfer_Done != pstDesc->enSts)
+    {
+        pstCtx->u16ChkFail++;
+    }
+    else
+    {
+        for (; pstCtx->u16Idx < pstCtx->u16ChkEnd; pstCtx->u16Idx++)
+        {
+            pstEnt = &pstCtx->pstTbl[pstCtx->u16Idx];
+            u8Mask = (NULL != pstCtx->pfChkMask) ? pstCtx->pfChkMask(pstEnt->u8DstAddr, pstEnt->u16DstRegAddr) : 0xFFu;
+
+            (void)RegSeq_boFindLast(pstCtx->pstTbl, pstCtx->u16Num, pstCtx->u16Idx, pstEnt, &u8Exp); // 同一寄存器写过多次时以最后一次为准
+
+            if (0u != ((pstCtx->au8ChkRx[u8Rx] ^ u8Exp) & u8Mask))
+            {
+                RegSeq_vChkLog(pstCtx, pstEnt, u8Exp, pstCtx->au8ChkRx[u8Rx]);
+            }
+            else
+            {}
+
+            RegCache_vPut(pstEnt->u8DstAddr, pstEnt->u16DstRegAddr, pstCtx->au8ChkRx[u8Rx], false);
+            pstCtx->u16ChkNum++;
+            u8Rx++;
+        }
+    }
+
+    pstCtx->u16Idx = pstCtx->u16ChkEnd;
+    pstCtx->boChk  = false;
+
+    return true;
+}
+
+static void RegSeq_vChkLog(RegSeq_stCtx *pstCtx, const I2cSendData *pstEnt, uint8_t u8Exp, uint8_t u8Act)
+{
+    RegSeq_stChkLog *pstLog = NULL;
+
+    if (pstCtx->u8ChkLogNum < REGSEQ_CHK_LOG) // 只记录最先出现的几项
+    {
+        pstLog         = &pstCtx->astChkLog[pstCtx->u8ChkLogNum];
+        pstLog->u8Dev  = pstEnt->u8DstAddr;
+        pstLog->u16Reg = pstEnt->u16DstRegAddr;
+        pstLog->u8Exp  = u8Exp;
+        pstLog->u8Act  = u8Act;
+        pstCtx->u8ChkLogNum++;
+    }
+    else
+    {}
+
+    pstCtx->u16ChkErr++;
+}
+
+static bool RegSeq_boSubmit(RegSeq_stCtx *pstCtx, uint8_t u8Dev, uint16_t u16Len, uint8_t *pu8Rx, uint8_t u8RxLen)
+{
+    I2cXfer_stDesc *pstDesc = &pstCtx->astDesc[pstCtx->u8Buf];
+    bool            boRte   = false;
+
+    pstDesc->u8DevAddr = u8Dev;
+    pstDesc->pu8Tx     = NULL;
+    pstDesc->u8TxLen   = 0u;
+    pstDesc->pu8Rx     = pu8Rx;
+    pstDesc->u8RxLen   = u8RxLen;
+    pstDesc->pfDone    = NULL;
+    pstDesc->pu16Cmd   = pstCtx->au16Cmd[pstCtx->u8Buf];
+    pstDesc->u16CmdLen = u16Len;
+
+    if (I2cXfer_boSubmit(pstDesc))
+    {
+        pstCtx->u8Buf = (pstCtx->u8Buf + 1u) % REGSEQ_BUF_NUM;
+        boRte         = true;
+    }
+    else
+    {}
+
+    return boRte;
+}
+
+static uint16_t RegSeq_u16WrLen(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16Idx) // 可合并的表项中需要写入的前几项，遇到器件中已是目标值的项截断
+{
+    uint16_t u16Run = RegSeq_u16RunLen(pstTbl, u16Num, u16Idx);
+    uint16_t u16Len = 0u;
+
+    while ((u16Len < u16Run) && (!RegCache_boSame(pstTbl[u16Idx + u16Len].u8DstAddr, pstTbl[u16Idx + u16Len].u16DstRegAddr, pstTbl[u16Idx + u16Len].u8RegData)))
+    {
+        u16Len++;
+    }
+
+    return u16Len;
+}
+
+static bool RegSeq_boOpCached(const RegSeq_stCtx *pstCtx, const RegSeq_stOp *pstOp) // WR/RUN操作的全部数据均已在器件中
+{
+    const uint8_t *pu8Data  = (RegSeq_OpRun == pstOp->u8Op) ? (const uint8_t *)pstOp->unPtr.pvArg : &pstOp->u8Arg;
+    uint8_t        u8DatLen = (RegSeq_OpRun == pstOp->u8Op) ? pstOp->u8Arg : 1u;
+    uint8_t        u8Cnt;
+    bool           boSame = true;
+
+    for (u8Cnt = 0u; (u8Cnt < u8DatLen) && boSame; u8Cnt++)
+    {
+        boSame = RegCache_boSame(pstCtx->u8Dev, (uint16_t)(pstOp->u16Arg + u8Cnt), pu8Data[u8Cnt]);
+    }
+
+    return boSame;
+}
+
+static bool RegSeq_boAnyBusy(const RegSeq_stCtx *pstCtx)
+{
+    uint8_t u8Buf;
+    bool    boBusy = false;
+
+    for (u8Buf = 0u; u8Buf < REGSEQ_BUF_NUM; u8Buf++)
+    {
+        boBusy = boBusy || I2cXfer_boBusy(&pstCtx->astDesc[u8Buf]);
+    }
+
+    return boBusy;
+}
+
+static bool RegSeq_boFindLast(const I2cSendData *pstTbl, uint16_t u16Num, uint16_t u16From, const I2cSendData *pstKey, uint8_t *pu8Data) // 查找同一器件同一寄存器最后一次写入的值
+{
+    uint16_t u16Idx;
+    bool     boFind = false;
+
+    for (u16Idx = u16From; u16Idx < u16Num; u16Idx++)
+    {
+        if ((pstTbl[u16Idx].u8DstAddr == pstKey->u8DstAddr) && (pstTbl[u16Idx].u16DstRegAddr == pstKey->u16DstRegAddr))
+        {
+            *pu8Data = pstTbl[u16Idx].u8RegData;
+            boFind   = true;
+        }
+        else
+        {}
+    }
+
+    return boFind;
+}
+
+static uint16_t RegSeq_u16EncodeAddr(uint16_t *pu16Cmd, uint16_t u16Reg, uint8_t u8AddrLen)
+{
+    if (REGSEQ_ADDR16 == u8AddrLen)
+    {
+        pu16Cmd[0] = I2CXFER_CMD_WR(u16Reg >> 8u);
+    }
+    else
+    {}
+
+    pu16Cmd[u8AddrLen - 1u] = I2CXFER_CMD_WR(u16Reg);
+
+    return u8AddrLen;
+}
+/*****************************************************************************
+ * End file RegSeq.c
+ *****************************************************************************/
@@ -1,6 +1,7 @@
 #include "SysTick.h"
 #include "Scheduler.h"
 #include "Scheduler_Cfg.h"
+#include "IrqLock.h"
 
 Sch_Const_Task_Info_T Sch_TaskTable;
 static TaskTablePara  sch_TaskPara[SCH_PERIODIC_MAX_NUM] = {
@@ -8,10 +9,22 @@ static TaskTablePara  sch_TaskPara[SCH_PERIODIC_MAX_NUM] = {
 };
 /* Task's periodic */
 static uint8_t  u8PeriodicNum   = 0u;
-static uint32_t u32TickVal      = 0u;
-static uint32_t u32CurTimeStamp = 0x00FFFFFFu;
-static uint32_t u32PreTimeStamp = 0x00FFFFFFu;
+static uint32_t u32CurTimeStamp = SCH_SYSTICK_MASK;
+static uint32_t u32PreTimeStamp = SCH_SYSTICK_MASK;
 static uint32_t u32TimeDuration = 0u;
+/* Bit n set: Sch_EventTable[n] is pending */
+static volatile uint32_t u32PendingEvent = 0u;
+/* CPU load accounting */
+static uint32_t        u32BusyTicks   = 0u;
+static uint32_t        u32WindowTicks = 0u;
+static uint8_t         u8HighLoadCnt  = 0u;
+static Sch_Load_Info_T sch_LoadInfo   = {0u, 0u, 0u};
+#ifdef SCH_TIMING_MONITOR
+/* Free running tick count and per group period statistics */
+static uint32_t          u32SchNow = 0u;
+static uint32_t          u32GroupStart[SCH_PERIODIC_MAX_NUM];
+static Sch_Timing_Info_T sch_TimingInfo[SCH_PERIODIC_MAX_NUM];
+#endif
 
 void Sch_TableInit(Sch_Const_Task_Info_T TaskTable)
 {
@@ -42,69 +55,294 @@ void Sch_TableInit(Sch_Const_Task_Info_T TaskTable)
         u8Count += 1u;
     }
 }
-/* Systick clock is 64/1Mhz = 64Mhz */
-/* 1ms = (1/64Mhz)*n*1000 : n= 64000 */
-void Sch_Main(void)
+/* Called from ISR: mark the event, the bound handler runs on the next loop */
+void Sch_PostEvent(Sch_Event_T Event)
 {
-    uint8_t u8Count;
+    uint32_t u32PriMask;
 
-    Sch_TableInit(Sch_RunTaskTable);
+    if (Event < SCH_EVENT_MAX_NUM)
+    {
+        IRQLOCK_SAVE(u32PriMask);
+        u32PendingEvent |= (1uL << Event);
+        IRQLOCK_RESTORE(u32PriMask);
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
 
-    while (1)
+static uint8_t Sch_DispatchEvent(void)
+{
+    uint8_t  u8Count;
+    uint8_t  u8RunNum = 0u;
+    uint32_t u32Event;
+    uint32_t u32PriMask;
+
+    IRQLOCK_SAVE(u32PriMask);
+    u32Event        = u32PendingEvent;
+    u32PendingEvent = 0u;
+    IRQLOCK_RESTORE(u32PriMask);
+
+    for (u8Count = 0u; (u8Count < SCH_EVENT_MAX_NUM) && (u32Event != 0u); u8Count++)
     {
-        SysTick_GetCurCount(&u32CurTimeStamp);
-        if (u32CurTimeStamp >= 2u)
+        if ((u32Event & (1uL << u8Count)) != 0u)
         {
-            u32CurTimeStamp -= 2u;
+            u32Event &= ~(1uL << u8Count);
+            if (Sch_EventTable[u8Count] != SCH_EndOfList)
+            {
+                Sch_EventTable[u8Count]();
+                u8RunNum += 1u;
+            }
+            else
+            {
+                /* Do nothing */
+            }
         }
         else
         {
-            u32CurTimeStamp = 0x00FFFFFFu;
+            /* Do nothing */
+        }
+    }
+
+    return u8RunNum;
+}
+
+/* Close one load window: busy/window in percent, peak and high load alarm */
+static void Sch_LoadAccount(uint32_t u32Duration)
+{
+    uint8_t u8Load;
+
+    u32WindowTicks += u32Duration;
+    if (u32WindowTicks >= SCH_LOAD_WINDOW)
+    {
+        u8Load = (uint8_t)(u32BusyTicks / (u32WindowTicks / 100u));
+        if (u8Load > 100u)
+        {
+            u8Load = 100u;
         }
-        /* Overflow */
-        if (u32CurTimeStamp >= u32PreTimeStamp)
+        else
         {
-            u32TimeDuration = u32PreTimeStamp + 0x00FFFFFFu - u32CurTimeStamp;
+            /* Do nothing */
         }
-        else if (u32CurTimeStamp < u32PreTimeStamp)
+        sch_LoadInfo.u8CurLoad = u8Load;
+        if (u8Load > sch_LoadInfo.u8PeakLoad)
         {
-            u32TimeDuration = u32PreTimeStamp - u32CurTimeStamp;
+            sch_LoadInfo.u8PeakLoad = u8Load;
         }
         else
         {
             /* Do nothing */
         }
 
-        u32PreTimeStamp = u32CurTimeStamp;
+        if (u8Load >= SCH_LOAD_ALARM_PCT)
+        {
+            if (u8HighLoadCnt < SCH_LOAD_ALARM_WINDOWS)
+            {
+                u8HighLoadCnt += 1u;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+            if (u8HighLoadCnt >= SCH_LOAD_ALARM_WINDOWS)
+            {
+                sch_LoadInfo.u8Alarm = 1u;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
+        else
+        {
+            u8HighLoadCnt = 0u;
+            if (u8Load < (SCH_LOAD_ALARM_PCT - SCH_LOAD_ALARM_HYST))
+            {
+                sch_LoadInfo.u8Alarm = 0u;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+        }
 
-        for (u8Count = 0u; u8Count < u8PeriodicNum; u8Count++)
+        u32BusyTicks   = 0u;
+        u32WindowTicks = 0u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+void Sch_GetCpuLoad(Sch_Load_Info_T *pLoadInfo)
+{
+    *pLoadInfo = sch_LoadInfo;
+}
+
+void Sch_ClearCpuLoadPeak(void)
+{
+    sch_LoadInfo.u8PeakLoad = sch_LoadInfo.u8CurLoad;
+}
+
+#ifdef SCH_TIMING_MONITOR
+/* Lateness of a task against its slot in the group */
+static void Sch_TimingCall(uint8_t u8Group, uint8_t u8TaskIdx)
+{
+    uint32_t u32Late = sch_TaskPara[u8Group].u32TimeDuration - Sch_TaskTable[u8TaskIdx].u32TimeDuration;
+
+    if (u32Late > sch_TimingInfo[u8Group].u32MaxLate)
+    {
+        sch_TimingInfo[u8Group].u32MaxLate = u32Late;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+
+/* Group period end: actual period against Sch_TaskTable, drift is the sum of the errors */
+static void Sch_TimingWrap(uint8_t u8Group)
+{
+    Sch_Timing_Info_T *pInfo   = &sch_TimingInfo[u8Group];
+    uint32_t           u32Real = u32SchNow - u32GroupStart[u8Group];
+
+    pInfo->u32Nominal = Sch_TaskTable[sch_TaskPara[u8Group].u8TaskEndPosition].u32TimeDuration;
+    if (pInfo->u32Cycles != 0u)
+    {
+        if ((pInfo->u32MinPeriod == 0u) || (u32Real < pInfo->u32MinPeriod))
+        {
+            pInfo->u32MinPeriod = u32Real;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+        if (u32Real > pInfo->u32MaxPeriod)
+        {
+            pInfo->u32MaxPeriod = u32Real;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+        if (pInfo->s32Drift < (0x7FFFFFFF - (int32_t)u32Real))
+        {
+            pInfo->s32Drift += (int32_t)u32Real - (int32_t)pInfo->u32Nominal;
+        }
+        else
+        {
+            /* Saturated */
+        }
+    }
+    else
+    {
+        /* First wrap only marks the start */
+    }
+    pInfo->u32Cycles += 1u;
+    u32GroupStart[u8Group] = u32SchNow;
+}
+
+void Sch_GetTimingInfo(uint8_t u8Group, Sch_Timing_Info_T *pInfo)
+{
+    if (u8Group < u8PeriodicNum)
+    {
+        *pInfo = sch_TimingInfo[u8Group];
+    }
+    else
+    {
+        /* Do nothing */
+    }
+}
+#endif
+
+/* One scheduler pass: elapsed time, pending events, due periodic tasks */
+void Sch_RunOnce(void)
+{
+    uint8_t  u8Count;
+    uint8_t  u8TaskIdx;
+    uint8_t  u8RunNum;
+    uint32_t u32BusyEnd;
+
+    SysTick_GetCurCount(&u32CurTimeStamp);
+    /* SysTick counts down from SCH_SYSTICK_MASK, the masked difference covers the wraparound */
+    u32TimeDuration = (u32PreTimeStamp - u32CurTimeStamp) & SCH_SYSTICK_MASK;
+    u32PreTimeStamp = u32CurTimeStamp;
+#ifdef SCH_TIMING_MONITOR
+    u32SchNow += u32TimeDuration;
+#endif
+
+    u8RunNum = Sch_DispatchEvent();
+
+    for (u8Count = 0u; u8Count < u8PeriodicNum; u8Count++)
+    {
+        sch_TaskPara[u8Count].u32TimeDuration += u32TimeDuration;
+        u8TaskIdx = sch_TaskPara[u8Count].u8TaskStartPosition + sch_TaskPara[u8Count].u8CurExecuteIdx;
+        /* Time is coming */
+        if (sch_TaskPara[u8Count].u32TimeDuration >= Sch_TaskTable[u8TaskIdx].u32TimeDuration)
         {
-            sch_TaskPara[u8Count].u32TimeDuration += u32TimeDuration;
-            /* Time is coming */
-            if (sch_TaskPara[u8Count].u32TimeDuration >= (Sch_TaskTable[(sch_TaskPara[u8Count].u8TaskStartPosition + sch_TaskPara[u8Count].u8CurExecuteIdx)].u32TimeDuration))
+#ifdef SCH_TIMING_MONITOR
+            Sch_TimingCall(u8Count, u8TaskIdx);
+#endif
+            CALL_TASK(u8TaskIdx);
+            /* A zero period group runs on every pass and is polling, not load */
+            if (Sch_TaskTable[sch_TaskPara[u8Count].u8TaskEndPosition].u32TimeDuration != 0u)
+            {
+                u8RunNum += 1u;
+            }
+            else
+            {
+                /* Do nothing */
+            }
+            if ((u8TaskIdx + 1u) < sch_TaskPara[u8Count].u8TaskEndPosition)
             {
-                CALL_TASK(sch_TaskPara[u8Count].u8TaskStartPosition + sch_TaskPara[u8Count].u8CurExecuteIdx);
-                if ((sch_TaskPara[u8Count].u8CurExecuteIdx + sch_TaskPara[u8Count].u8TaskStartPosition + 1u) < sch_TaskPara[u8Count].u8TaskEndPosition)
-                {
-                    sch_TaskPara[u8Count].u8CurExecuteIdx += 1u;
-                }
-                else
-                {
-                    sch_TaskPara[u8Count].u8CurExecuteIdx = 0u;
-                }
-                if (sch_TaskPara[u8Count].u32TimeDuration >= Sch_TaskTable[sch_TaskPara[u8Count].u8TaskEndPosition].u32TimeDuration)
-                {
-                    sch_TaskPara[u8Count].u32TimeDuration = 0u;
-                }
-                else
-                {
-                    /* Do nothing */
-                }
+                sch_TaskPara[u8Count].u8CurExecuteIdx += 1u;
+            }
+            else
+            {
+                sch_TaskPara[u8Count].u8CurExecuteIdx = 0u;
+            }
+            if (sch_TaskPara[u8Count].u32TimeDuration >= Sch_TaskTable[sch_TaskPara[u8Count].u8TaskEndPosition].u32TimeDuration)
+            {
+                sch_TaskPara[u8Count].u32TimeDuration = 0u;
+#ifdef SCH_TIMING_MONITOR
+                Sch_TimingWrap(u8Count);
+#endif
             }
             else
             {
                 /* Do nothing */
             }
         }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+
+    /* Busy time: from this pass' time stamp until the last task returned */
+    if (u8RunNum != 0u)
+    {
+        SysTick_GetCurCount(&u32BusyEnd);
+        u32BusyTicks += (u32CurTimeStamp - u32BusyEnd) & SCH_SYSTICK_MASK;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+    Sch_LoadAccount(u32TimeDuration);
+}
+
+/* Systick clock is 64/1Mhz = 64Mhz */
+/* 1ms = (1/64Mhz)*n*1000 : n= 64000 */
+void Sch_Main(void)
+{
+    Sch_TableInit(Sch_RunTaskTable);
+    SysTick_GetCurCount(&u32PreTimeStamp);
+
+    while (1)
+    {
+        Sch_RunOnce();
     }
 }
@@ -6,6 +6,8 @@
 #include "can.h"
 #include "i2c.h"
 #include "Lx07.h"
+#include "Touch.h"
+#include "ProductLine.h"
 
 void Task1(void)
 {
@@ -87,3 +89,11 @@ const Sch_Task_Info_T Sch_RunTaskTable[] =
         {SCH_EndOfList,  SCH_MS(40u), SCH_TIMEDURATION(40u)},
         {SCH_EndOfList,  SCH_MS(0u),  SCH_TIMEDURATION(0u) }
 };
+
+/* Indexed by SCH_EVENT_xxx */
+const Sch_Task_T Sch_EventTable[SCH_EVENT_MAX_NUM] =
+    {
+        &Touch_vTpIntEvent,  /* SCH_EVENT_TOUCH_INT */
+        &ProductLine_vKick,  /* SCH_EVENT_CAN_RX */
+        &ProductLine_vKick,  /* SCH_EVENT_I2C_DONE */
+};
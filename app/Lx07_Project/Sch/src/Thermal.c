@@ -0,0 +1,308 @@
+/*****************************************************************************
+ * @file Thermal.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "Thermal.h"
+#include "Config.h"
+#include "ProductLine.h"
+#include "BackL.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define THERMAL_MEDIAN_NUM (3u) // 中值滤波窗口，去除单次尖峰
+#define THERMAL_IIR_SHIFT  (2u) // 一阶IIR：y += (x - y) / 4
+#define THERMAL_IIR_FRAC   (4u) // IIR状态保留4位小数，避免小步长被截断
+
+#define THERMAL_FAIL_MAX (3u) // 连续无效采样次数，达到后该传感器不参与降额
+
+#define THERMAL_HYST      (20)   // 恢复亮度的回差，0.1℃
+#define THERMAL_STEP_DOWN (100u) // 每个采样周期降额上限最多下降的千分比
+#define THERMAL_STEP_UP   (20u)  // 每个采样周期最多恢复的千分比，亮度缓慢回升
+
+#define THERMAL_CURVE_NUM(Tbl) ((uint8_t)(sizeof(Tbl) / sizeof((Tbl)[0])))
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+typedef struct
+{
+    int16_t  s16Temp; // 0.1℃，按温度升序排列
+    uint16_t u16Pm;   // 该温度下背光上限，千分比
+} Thermal_stCurvePt;
+
+typedef struct
+{
+    const Thermal_stCurvePt *pstCurve; // 为NULL时该传感器只监测，不参与降额
+    uint8_t                  u8CurveNum;
+    ProductLine_enWorkSts    enJob;
+} Thermal_stSensorCfg;
+
+typedef struct
+{
+    int16_t as16Raw[THERMAL_MEDIAN_NUM];
+    uint8_t u8RawNum;
+    uint8_t u8RawIdx;
+    int32_t s32Iir; // 0.1℃ << THERMAL_IIR_FRAC
+    bool    boValid;
+    uint8_t u8Fail;
+} Thermal_stSensor;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+/* LCD降额标定表：65℃以下不降额，65℃~85℃由100%线性降到10%（原392.5 - 4.5 * T），85℃以上保持10%
+ * 表两端以外取端点值，点数可按标定结果增加 */
+static const Thermal_stCurvePt Thermal_astLcdCurve[] = {
+    {650, 1000},
+    {850, 100 },
+};
+
+static const Thermal_stSensorCfg Thermal_astCfg[Thermal_Num] = {
+    {Thermal_astLcdCurve, THERMAL_CURVE_NUM(Thermal_astLcdCurve), ProDWork_Read_LcdTemp}, // Thermal_Lcd
+    {NULL, 0, ProDWork_Read_PcbTemp},                                                     // Thermal_Pcb
+};
+
+static Thermal_stSensor Thermal_astSensor[Thermal_Num];
+static uint16_t         Thermal_u16Pm = THERMAL_PERMILLE;
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static int16_t  Thermal_s16Median(const Thermal_stSensor *pstSen);
+static uint16_t Thermal_u16CurvePm(const Thermal_stSensorCfg *pstCfg, int16_t s16Temp);
+static void     Thermal_vDerate(void);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void Thermal_vInit(void)
+{
+    memset(Thermal_astSensor, 0, sizeof(Thermal_astSensor));
+
+    Thermal_u16Pm = THERMAL_PERMILLE;
+}
+
+void Thermal_vHandle(void) // 5ms
+{
+    static uint16_t u16Cnt = 0;
+
+    if (0 == u16Cnt)
+    {
+        Thermal_vDerate(); // 用上一周期的滤波结果更新降额
+        ProductLine_boPost(Thermal_astCfg[Thermal_Lcd].enJob, NULL);
+    }
+    else if (MAIN_TIME_MS(THERMAL_SAMPLE_MS / 2) == u16Cnt)
+    {
+        ProductLine_boPost(Thermal_astCfg[Thermal_Pcb].enJob, NULL);
+    }
+    else
+    {}
+
+    u16Cnt++;
+
+    if (u16Cnt >= MAIN_TIME_MS(THERMAL_SAMPLE_MS))
+    {
+        u16Cnt = 0;
+    }
+    else
+    {}
+}
+
+void Thermal_vPutSample(Thermal_enSensor enSensor, int16_t s16Temp, bool boValid)
+{
+    Thermal_stSensor *pstSen;
+    int32_t           s32In;
+
+    if (enSensor >= Thermal_Num)
+    {
+        return;
+    }
+    else
+    {}
+
+    pstSen = &Thermal_astSensor[enSensor];
+
+    if (!boValid)
+    {
+        if (pstSen->u8Fail < THERMAL_FAIL_MAX)
+        {
+            pstSen->u8Fail++;
+        }
+        else
+        {}
+
+        if (pstSen->u8Fail >= THERMAL_FAIL_MAX)
+        {
+            pstSen->boValid  = false; // 传感器开路/短路，重新恢复后从头滤波
+            pstSen->u8RawNum = 0;
+        }
+        else
+        {}
+        return;
+    }
+    else
+    {}
+
+    pstSen->u8Fail                    = 0;
+    pstSen->as16Raw[pstSen->u8RawIdx] = s16Temp;
+    pstSen->u8RawIdx                  = (pstSen->u8RawIdx + 1u) % THERMAL_MEDIAN_NUM;
+
+    if (pstSen->u8RawNum < THERMAL_MEDIAN_NUM)
+    {
+        pstSen->u8RawNum++;
+    }
+    else
+    {}
+
+    s32In = (int32_t)Thermal_s16Median(pstSen) * (1 << THERMAL_IIR_FRAC);
+
+    if (!pstSen->boValid)
+    {
+        pstSen->s32Iir  = s32In; // 第一个样本直接作为初值
+        pstSen->boValid = true;
+    }
+    else
+    {
+        pstSen->s32Iir += (s32In - pstSen->s32Iir) / (1 << THERMAL_IIR_SHIFT);
+    }
+}
+
+bool Thermal_boGetTemp(Thermal_enSensor enSensor, int16_t *ps16Temp)
+{
+    if ((enSensor >= Thermal_Num) || !Thermal_astSensor[enSensor].boValid)
+    {
+        return false;
+    }
+    else
+    {}
+
+    *ps16Temp = (int16_t)(Thermal_astSensor[enSensor].s32Iir / (1 << THERMAL_IIR_FRAC));
+
+    return true;
+}
+
+uint16_t Thermal_u16DeratePm(void)
+{
+    return Thermal_u16Pm;
+}
+
+static int16_t Thermal_s16Median(const Thermal_stSensor *pstSen) // 不足3个样本时取最新值
+{
+    int16_t s16A, s16B, s16C;
+
+    if (pstSen->u8RawNum < THERMAL_MEDIAN_NUM)
+    {
+        return pstSen->as16Raw[(pstSen->u8RawIdx + THERMAL_MEDIAN_NUM - 1u) % THERMAL_MEDIAN_NUM];
+    }
+    else
+    {}
+
+    s16A = pstSen->as16Raw[0];
+    s16B = pstSen->as16Raw[1];
+    s16C = pstSen->as16Raw[2];
+
+    if ((s16A > s16B) == (s16A < s16C))
+    {
+        return s16A;
+    }
+    else if ((s16B > s16A) == (s16B < s16C))
+    {
+        return s16B;
+    }
+    else
+    {
+        return s16C;
+    }
+}
+
+static uint16_t Thermal_u16CurvePm(const Thermal_stSensorCfg *pstCfg, int16_t s16Temp) // 标定表分段线性插值
+{
+    const Thermal_stCurvePt *pstLo;
+    const Thermal_stCurvePt *pstHi;
+    uint8_t                  u8Idx;
+    int32_t                  s32Pm;
+
+    if (s16Temp <= pstCfg->pstCurve[0].s16Temp)
+    {
+        return pstCfg->pstCurve[0].u16Pm;
+    }
+    else if (s16Temp >= pstCfg->pstCurve[pstCfg->u8CurveNum - 1u].s16Temp)
+    {
+        return pstCfg->pstCurve[pstCfg->u8CurveNum - 1u].u16Pm;
+    }
+    else
+    {}
+
+    for (u8Idx = 1; (u8Idx < pstCfg->u8CurveNum - 1u) && (s16Temp > pstCfg->pstCurve[u8Idx].s16Temp); u8Idx++)
+    {}
+
+    pstLo = &pstCfg->pstCurve[u8Idx - 1u];
+    pstHi = &pstCfg->pstCurve[u8Idx];
+    s32Pm = pstLo->u16Pm + ((int32_t)pstHi->u16Pm - pstLo->u16Pm) * (s16Temp - pstLo->s16Temp) / (pstHi->s16Temp - pstLo->s16Temp);
+
+    return (uint16_t)s32Pm;
+}
+
+static void Thermal_vDerate(void) // 各传感器取最严格的上限，下降立即跟随，恢复需降温超过回差，两个方向都限速
+{
+    const Thermal_stSensorCfg *pstCfg;
+    int16_t                    s16Temp;
+    uint16_t                   u16Down = THERMAL_PERMILLE; // 按当前温度的上限
+    uint16_t                   u16Up   = THERMAL_PERMILLE; // 按当前温度加回差的上限
+    uint16_t                   u16Target;
+    uint16_t                   u16Pm;
+    uint8_t                    u8Idx;
+    bool                       boAny = false;
+
+    for (u8Idx = 0; u8Idx < Thermal_Num; u8Idx++)
+    {
+        pstCfg = &Thermal_astCfg[u8Idx];
+
+        if ((NULL == pstCfg->pstCurve) || !Thermal_boGetTemp((Thermal_enSensor)u8Idx, &s16Temp))
+        {}
+        else
+        {
+            boAny = true;
+
+            u16Pm   = Thermal_u16CurvePm(pstCfg, s16Temp);
+            u16Down = (u16Pm < u16Down) ? u16Pm : u16Down;
+            u16Pm   = Thermal_u16CurvePm(pstCfg, s16Temp + THERMAL_HYST);
+            u16Up   = (u16Pm < u16Up) ? u16Pm : u16Up;
+        }
+    }
+
+    if (!boAny)
+    {
+        return; // 没有有效温度，保持当前上限
+    }
+    else if (u16Down < Thermal_u16Pm)
+    {
+        u16Target = ((uint16_t)(Thermal_u16Pm - u16Down) > THERMAL_STEP_DOWN) ? (Thermal_u16Pm - THERMAL_STEP_DOWN) : u16Down;
+    }
+    else if (u16Up > Thermal_u16Pm)
+    {
+        u16Target = ((uint16_t)(u16Up - Thermal_u16Pm) > THERMAL_STEP_UP) ? (Thermal_u16Pm + THERMAL_STEP_UP) : u16Up;
+    }
+    else
+    {
+        u16Target = Thermal_u16Pm; // 回差区内保持
+    }
+
+    if (u16Target != Thermal_u16Pm)
+    {
+        Thermal_u16Pm = u16Target;
+        BackL_vSetDerate(Thermal_u16Pm);
+    }
+    else
+    {}
+}
+/*****************************************************************************
+ * End file Thermal.c
+ *****************************************************************************/
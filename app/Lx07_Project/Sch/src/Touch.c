@@ -23,9 +23,20 @@
 #include "Config.h"
 #include "can.h"
 #include "VedioDisp.h"
+#include "TouchProc.h"
+#include "I2cXfer.h"
+#include "Scheduler.h"
+#include "Scheduler_Cfg.h"
 /*****************************************************************************
  * Local macros
  *****************************************************************************/
+#define TOUCH_REG_FRAME  (0x01u) // 手势ID，之后依次是触摸状态(点数)和各点数据
+#define TOUCH_HEAD_SIZE  (2u)
+#define TOUCH_PT_SIZE    (6u) // XH XL YH YL 压力 面积
+#define TOUCH_FRAME_SIZE (TOUCH_HEAD_SIZE + TOUCH_POINT_MAX * TOUCH_PT_SIZE)
+#define TOUCH_PT_OFS(n)  (TOUCH_HEAD_SIZE + (n) * TOUCH_PT_SIZE)
+
+#define TOUCH_EVT_MASK (TOUCH_EVT_NUM - 1u)
 
 /*****************************************************************************
  * Local data types
@@ -37,18 +48,33 @@
 static uint32_t Touch_u32TpCountOld = 0xFFFFFFFF;
 uint32_t        Touch_u32TpCount    = 0;
 bool            Touch_boMisTpIntFlg = false;
+
+static I2cXfer_stDesc Touch_stRdDesc;
+static uint8_t        Touch_u8RdReg;
+static uint8_t        Touch_au8Frame[TOUCH_FRAME_SIZE];
+static uint8_t        Touch_u8RdPts  = 1; // 下一帧一次读取的点数，取上一帧的有效点数，手指抬起的事件也在其中
+static uint8_t        Touch_u8FrmPts = 0; // 本帧已读取的点数
+
+static Touch_stEvent Touch_astEvt[TOUCH_EVT_NUM]; // 读取和上报都在主循环中，不需要关中断
+static uint8_t       Touch_u8EvtHead = 0;
+static uint8_t       Touch_u8EvtTail = 0;
 /*****************************************************************************
  * Local function prototypes
  *****************************************************************************/
-static void Touch_vRecordTpCount(void);
-static void Touch_vMisTpTest(void);
+static void    Touch_vRecordTpCount(void);
+static void    Touch_vMisTpTest(void);
+static bool    Touch_boRdSubmit(uint8_t u8Ofs, uint8_t u8Len);
+static void    Touch_vRdDone(I2cXfer_stDesc *pstDesc);
+static uint8_t Touch_u8Parse(uint8_t u8Num);
+static void    Touch_vPushEvent(const Touch_stEvent *pstEvt);
+static void    Touch_vReport(void);
 /*****************************************************************************
  * function definitions
  *****************************************************************************/
 void Touch_vInit(void)
 {
 #ifdef TOUCH_NEED_TPCOUNT
-    ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_TpCount] = true;
+    ProductLine_boPost(ProDWork_Read_TpCount, NULL);
 #endif
 
 #ifdef TOUCH_NEED_TPCOUNT
@@ -57,6 +83,8 @@ void Touch_vInit(void)
     Debounce_vInit(&Debounce_StTpTrigger, 0);
 #endif
     Debounce_vInit(&Debounce_StSw3, MAIN_TIME_MS(200)); // 清除触摸次数，3s内按两次
+
+    TouchProc_vInit();
 }
 
 void Touch_vHandle(void) // 5ms
@@ -65,20 +93,19 @@ void Touch_vHandle(void) // 5ms
     Debounce_vCheck(&Debounce_StSw3);
 
     Touch_vMisTpTest();
-
-    if (Debounce_boGetValidStu(&Debounce_StTpTrigger))
-    {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_TpCoord])
-            ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_TpCoord] = true;
-    }
-    else
-    {}
+    Touch_vReport();
 
 #ifdef TOUCH_NEED_TPCOUNT
     Touch_vRecordTpCount();
 #endif
 }
 
+void Touch_vTpIntEvent(void) // 触摸中断事件，在下一次主循环执行；每帧都读取，读取中又来中断时合并为一次
+{
+    ProductLine_boPost(ProDWork_Read_TpCoord, NULL);
+    ProductLine_vKick();
+}
+
 static void Touch_vRecordTpCount(void)
 {
     static uint8_t  u8TpClearCnt   = 0;
@@ -119,8 +146,7 @@ static void Touch_vRecordTpCount(void)
     {
         Touch_u32TpCountOld = Touch_u32TpCount;
 
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_TpCount])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_TpCount] = true;
+        ProductLine_boPost(ProDWork_Write_TpCount, NULL);
 
         au8Uart0TxTpCount[8]  = 0x30 + (Touch_u32TpCount / 100000);
         au8Uart0TxTpCount[9]  = 0x30 + (Touch_u32TpCount % 100000) / 10000;
@@ -135,94 +161,123 @@ static void Touch_vRecordTpCount(void)
     {}
 }
 
-void Touch_vReadTpCoord(void) // 读触摸坐标
+void Touch_vReadTpCoord(void) // 读触摸点：按上一帧点数一次读出，点数增加时再补读其余部分
 {
-    static uint8_t u8StepTpCoord = 2;
-
-    uint8_t u8Addr = 0x01;
+    static uint8_t u8StepTpCoord = 4;
 
-    uint8_t au8CoordX[] = {0x6E, 0x30, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
-    uint8_t au8CoordY[] = {0x6E, 0x31, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+    uint8_t u8Num = 0;
 
-    if (2 == u8StepTpCoord)
+    if (4 == u8StepTpCoord)
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x38);
-        I2C_Enable(I2C0_ID);
-        u8StepTpCoord = 1;
+        if (Touch_boRdSubmit(0, TOUCH_PT_OFS(Touch_u8RdPts)))
+        {
+            u8StepTpCoord = 3;
+        }
+        else
+        {}
     }
-    else if (1 == u8StepTpCoord)
-    {
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&u8Addr));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_TpCoord] = true;
 
-        u8StepTpCoord = 0;
-        // Touch_u32TpCount++;
-    }
-    else if (0 == u8StepTpCoord)
+    if (3 == u8StepTpCoord)
     {
-        if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_TpCoord])
+        if (I2cXfer_boBusy(&Touch_stRdDesc))
+        {}
+        else if (I2cXfer_Done != Touch_stRdDesc.enSts)
         {
-            u8StepTpCoord            = 2;
-            ProductLine_enCurWorkSts = ProDWork_Idle;
-
-            struct fts_ts_event events;
+            u8StepTpCoord = 4; // 本帧丢弃，等下一次中断
+            ProductLine_vJobDone(ProDWork_Read_TpCoord);
+        }
+        else if ((Touch_au8Frame[1] & 0x0Fu) > TOUCH_POINT_MAX)
+        {
+            u8StepTpCoord = 4; // 点数无效
+            ProductLine_vJobDone(ProDWork_Read_TpCoord);
+        }
+        else if ((Touch_au8Frame[1] & 0x0Fu) > Touch_u8RdPts)
+        {
+            Touch_u8FrmPts = Touch_au8Frame[1] & 0x0Fu;
+            u8StepTpCoord  = 2;
+        }
+        else
+        {
+            Touch_u8FrmPts = Touch_u8RdPts;
+            u8StepTpCoord  = 0;
+        }
+    }
 
-            events.x = ((ProductLine_stI2cRWMsgs.Read_t.au8Data[2] & 0x0F) << 8) + ProductLine_stI2cRWMsgs.Read_t.au8Data[2 + 1];
-            events.y = ((ProductLine_stI2cRWMsgs.Read_t.au8Data[2 + 2] & 0x0F) << 8) + ProductLine_stI2cRWMsgs.Read_t.au8Data[2 + 3];
+    if (2 == u8StepTpCoord)
+    {
+        if (Touch_boRdSubmit(TOUCH_PT_OFS(Touch_u8RdPts), (Touch_u8FrmPts - Touch_u8RdPts) * TOUCH_PT_SIZE))
+        {
+            u8StepTpCoord = 1;
+        }
+        else
+        {}
+    }
 
-            // UART_PRINTF("x = %d, y = %d\r\n", events.x, events.y);
+    if (1 == u8StepTpCoord)
+    {
+        if (I2cXfer_boBusy(&Touch_stRdDesc))
+        {}
+        else if (I2cXfer_Done != Touch_stRdDesc.enSts)
+        {
+            u8StepTpCoord = 4;
+            ProductLine_vJobDone(ProDWork_Read_TpCoord);
+        }
+        else
+        {
+            u8StepTpCoord = 0;
+        }
+    }
 
-            au8CoordX[7]  = 0x30 + events.x / 1000;
-            au8CoordX[8]  = 0x30 + (events.x % 1000) / 100;
-            au8CoordX[9]  = 0x30 + (events.x % 100) / 10;
-            au8CoordX[10] = 0x30 + events.x % 10;
+    if (0 == u8StepTpCoord)
+    {
+        u8StepTpCoord = 4;
+        ProductLine_vJobDone(ProDWork_Read_TpCoord);
 
-            au8CoordY[7] = 0x30 + events.y / 100;
-            au8CoordY[8] = 0x30 + (events.y % 100) / 10;
-            au8CoordY[9] = 0x30 + events.y % 10;
+        u8Num         = Touch_u8Parse(Touch_au8Frame[1] & 0x0Fu);
+        Touch_u8RdPts = (0u != u8Num) ? u8Num : 1u;
+    }
+}
 
-            Uart_Transmit(au8CoordX, sizeof(au8CoordX));
-            Uart_Transmit(au8CoordY, sizeof(au8CoordY));
-        }
-        else
-        {}
+bool Touch_boPopEvent(Touch_stEvent *pstEvt)
+{
+    if (Touch_u8EvtHead == Touch_u8EvtTail)
+    {
+        return false;
     }
     else
     {}
+
+    *pstEvt         = Touch_astEvt[Touch_u8EvtTail];
+    Touch_u8EvtTail = (Touch_u8EvtTail + 1u) & TOUCH_EVT_MASK;
+
+    return true;
 }
 
 void Touch_vReadTpCount(void) // 读触摸次数
 {
-    static uint8_t u8StepTpCt          = 3;
-    uint8_t        u8Addr              = 0x7C;
+    static uint8_t u8StepTpCt          = 2;
     uint8_t        au8Uart0TxTpCount[] = {0x74, 0x39, 0x2E, 0x74, 0x78, 0x74, 0x3D, 0x22, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x22, 0xff, 0xff, 0xff};
 
-    if (3 == u8StepTpCt)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x54);
-        I2C_Enable(I2C0_ID);
-        u8StepTpCt = 2;
-    }
-    else if (2 == u8StepTpCt)
+    if (2 == u8StepTpCt)
     {
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&u8Addr));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_TpCount] = true;
-
-        u8StepTpCt = 1;
+        if (ProductLine_boI2cRead(ProD_I2c_Read_TpCount, DEV_EEP, 0x7C))
+        {
+            u8StepTpCt = 1;
+        }
+        else
+        {}
     }
     else if (1 == u8StepTpCt)
     {
         if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_TpCount])
         {
-            ProductLine_enCurWorkSts = ProDWork_Idle;
-            u8StepTpCt               = 3;
+            ProductLine_vJobDone(ProDWork_Read_TpCount);
+            u8StepTpCt = 2;
 
-            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[0] << 24u);
-            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[1] << 16u);
-            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[2] << 8u);
-            Touch_u32TpCount = (uint8_t)ProductLine_stI2cRWMsgs.Read_t.au8Data[3];
+            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_TpCount][0] << 24u);
+            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_TpCount][1] << 16u);
+            Touch_u32TpCount = (uint8_t)(ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_TpCount][2] << 8u);
+            Touch_u32TpCount = (uint8_t)ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_TpCount][3];
 
             au8Uart0TxTpCount[8]  = 0x30 + (Touch_u32TpCount / 100000);
             au8Uart0TxTpCount[9]  = 0x30 + (Touch_u32TpCount % 100000) / 10000;
@@ -242,28 +297,25 @@ void Touch_vReadTpCount(void) // 读触摸次数
 
 void Touch_vWriteTpCount(void) // 写入触摸次数
 {
-    static uint8_t u8StepWTpCt = 2;
+    static uint8_t u8StepWTpCt = 1;
 
     uint8_t au8WriteTpCt[5] = {0x7C, 0x01, 0x01, 0x01, 0x01}; // 写入地址：0x7C~0x7F
 
-    if (2 == u8StepWTpCt)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x54);
-        I2C_Enable(I2C0_ID);
-        u8StepWTpCt = 1;
-    }
-    else if (1 == u8StepWTpCt)
+    if (1 == u8StepWTpCt)
     {
         au8WriteTpCt[4] = (uint8_t)Touch_u32TpCount;
         au8WriteTpCt[3] = (uint8_t)(Touch_u32TpCount >> 8u);
         au8WriteTpCt[2] = (uint8_t)(Touch_u32TpCount >> 16u);
         au8WriteTpCt[1] = (uint8_t)(Touch_u32TpCount >> 24u);
 
-        Ex_MstWriteEEP(I2C0_ID, (uint8_t *)(&au8WriteTpCt[0]), 4);
-        ProductLine_enCurWorkSts = ProDWork_Idle;
+        if (ProductLine_boI2cWrite(DEV_EEP, au8WriteTpCt, sizeof(au8WriteTpCt)))
+        {
+            ProductLine_vJobDone(ProDWork_Write_TpCount);
 
-        u8StepWTpCt = 2;
+            u8StepWTpCt = 1;
+        }
+        else
+        {}
     }
     else
     {}
@@ -300,6 +352,130 @@ void Touch_vMisTpTest(void)
         u16TouchCnt = 0;
     }
 }
+
+static bool Touch_boRdSubmit(uint8_t u8Ofs, uint8_t u8Len) // 从帧内偏移u8Ofs处读u8Len字节，寄存器地址与帧偏移一一对应
+{
+    if (I2cXfer_boBusy(&Touch_stRdDesc))
+    {
+        return false;
+    }
+    else
+    {}
+
+    Touch_u8RdReg = TOUCH_REG_FRAME + u8Ofs;
+
+    Touch_stRdDesc.u8DevAddr = DEV_TP;
+    Touch_stRdDesc.pu8Tx     = &Touch_u8RdReg;
+    Touch_stRdDesc.u8TxLen   = 1;
+    Touch_stRdDesc.pu8Rx     = &Touch_au8Frame[u8Ofs];
+    Touch_stRdDesc.u8RxLen   = u8Len;
+    Touch_stRdDesc.pfDone    = Touch_vRdDone;
+    Touch_stRdDesc.pu16Cmd   = NULL;
+
+    return I2cXfer_boSubmit(&Touch_stRdDesc);
+}
+
+static void Touch_vRdDone(I2cXfer_stDesc *pstDesc) // i2c中断中调用，主循环立即推进读取任务
+{
+    (void)pstDesc;
+
+    Sch_PostEvent(SCH_EVENT_I2C_DONE);
+}
+
+static uint8_t Touch_u8Parse(uint8_t u8Num) // 解析本帧各点存入事件缓存，返回有效点数
+{
+    Touch_stEvent  stEvt;
+    const uint8_t *pu8Pt;
+    uint8_t        u8Idx;
+
+    for (u8Idx = 0; u8Idx < Touch_u8FrmPts; u8Idx++)
+    {
+        pu8Pt = &Touch_au8Frame[TOUCH_PT_OFS(u8Idx)];
+
+        stEvt.u8Id  = pu8Pt[2] >> 4u;
+        stEvt.u8Typ = (pu8Pt[0] >> 6u) & 0x03u;
+
+        if (stEvt.u8Id >= TOUCH_POINT_MAX)
+        {
+            break; // 之后没有点
+        }
+        else if ((Touch_Up != stEvt.u8Typ) && (0u == u8Num))
+        {
+            break; // 点数为0却有按下的点，固件数据异常
+        }
+        else
+        {}
+
+        stEvt.u16X   = (uint16_t)(((pu8Pt[0] & 0x0Fu) << 8u) | pu8Pt[1]);
+        stEvt.u16Y   = (uint16_t)(((pu8Pt[2] & 0x0Fu) << 8u) | pu8Pt[3]);
+        stEvt.u8Pres = pu8Pt[4];
+        stEvt.u8Area = pu8Pt[5];
+
+        if (stEvt.u8Typ <= Touch_Contact)
+        {
+            Touch_vPushEvent(&stEvt);
+        }
+        else
+        {}
+    }
+
+    return u8Idx;
+}
+
+static void Touch_vPushEvent(const Touch_stEvent *pstEvt) // 缓存满时丢弃最早的事件
+{
+    if (((Touch_u8EvtHead + 1u) & TOUCH_EVT_MASK) == Touch_u8EvtTail)
+    {
+        Touch_u8EvtTail = (Touch_u8EvtTail + 1u) & TOUCH_EVT_MASK;
+    }
+    else
+    {}
+
+    Touch_astEvt[Touch_u8EvtHead] = *pstEvt;
+    Touch_u8EvtHead               = (Touch_u8EvtHead + 1u) & TOUCH_EVT_MASK;
+}
+
+static void Touch_vReport(void) // 5ms，本周期的全部事件交给TouchProc处理，屏幕只在坐标变化时刷新
+{
+    static uint16_t u16ShowX = 0xFFFF;
+    static uint16_t u16ShowY = 0xFFFF;
+
+    Touch_stEvent stEvt;
+    uint16_t      u16X;
+    uint16_t      u16Y;
+
+    uint8_t au8CoordX[] = {0x6E, 0x30, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+    uint8_t au8CoordY[] = {0x6E, 0x31, 0x2E, 0x76, 0x61, 0x6C, 0x3D, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+
+    while (Touch_boPopEvent(&stEvt))
+    {
+        TouchProc_vPutEvent(&stEvt);
+    }
+
+    TouchProc_vHandle();
+
+    if (!TouchProc_boGetPrimary(&u16X, &u16Y) || ((u16X == u16ShowX) && (u16Y == u16ShowY)))
+    {
+        return;
+    }
+    else
+    {}
+
+    u16ShowX = u16X;
+    u16ShowY = u16Y;
+
+    au8CoordX[7]  = 0x30 + u16X / 1000;
+    au8CoordX[8]  = 0x30 + (u16X % 1000) / 100;
+    au8CoordX[9]  = 0x30 + (u16X % 100) / 10;
+    au8CoordX[10] = 0x30 + u16X % 10;
+
+    au8CoordY[7] = 0x30 + u16Y / 100;
+    au8CoordY[8] = 0x30 + (u16Y % 100) / 10;
+    au8CoordY[9] = 0x30 + u16Y % 10;
+
+    Uart_Transmit(au8CoordX, sizeof(au8CoordX));
+    Uart_Transmit(au8CoordY, sizeof(au8CoordY));
+}
 /*****************************************************************************
  * End file Touch.c
  *****************************************************************************/
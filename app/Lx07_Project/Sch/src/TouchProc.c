@@ -0,0 +1,328 @@
+/*****************************************************************************
+ * @file TouchProc.c
+ *
+ * @author
+ *
+ * @version 1.0
+ *
+ * @date 2026-10-19
+ *
+ * @copyright Wuhan Baohua Display Technology Co., Ltd.
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Include files
+ *****************************************************************************/
+#include "TouchProc.h"
+#include "Config.h"
+#include "ProductLine.h"
+#include "can.h"
+/*****************************************************************************
+ * Local macros
+ *****************************************************************************/
+#define TOUCHPROC_FRAC      (4u)       // 滤波状态保留4位小数
+#define TOUCHPROC_ALPHA_ONE (256u)     // 滤波系数满量程
+#define TOUCHPROC_2PI_MIL   (6283uL)   // 2π * 1000
+#define TOUCHPROC_CUT_DEN   (100000uL) // 截止频率0.01Hz与周期ms两个单位的换算
+
+#define TOUCHPROC_COORD_MAX (0x0FFF) // 触摸芯片坐标12位
+
+#define TOUCHPROC_REC_NUM  (16u) // 待上报记录个数，2的幂
+#define TOUCHPROC_REC_MASK (TOUCHPROC_REC_NUM - 1u)
+#define TOUCHPROC_TX_NUM   (2u) // 每5ms最多发送的CAN帧数，不超过发送邮箱个数
+
+#define TOUCHPROC_ABS(a) (((a) < 0) ? -(a) : (a))
+/*****************************************************************************
+ * Local data types
+ *****************************************************************************/
+typedef struct
+{
+    bool     boDown;
+    bool     boMoved; // 已离开按下位置，不再判定点击/长按
+    bool     boLong;  // 本次按住已上报长按
+    bool     boNew;   // 有新坐标未上报
+    int32_t  s32X;    // 滤波后坐标，像素 << TOUCHPROC_FRAC
+    int32_t  s32Y;
+    int32_t  s32Dx; // 滤波后速度，像素/帧 << TOUCHPROC_FRAC
+    int32_t  s32Dy;
+    uint16_t u16DownX; // 按下位置，手势判定用原始坐标
+    uint16_t u16DownY;
+    uint16_t u16OutX; // 最近一次输出的坐标
+    uint16_t u16OutY;
+    uint32_t u32DownMs;
+} TouchProc_stFinger;
+
+typedef struct
+{
+    uint8_t  u8Typ; // TouchProc_enRec
+    uint8_t  u8Id;
+    uint16_t u16X;
+    uint16_t u16Y;
+    uint8_t  u8Ext; // 滑动为方向，抬起/点击为按住时间(10ms)
+} TouchProc_stRec;
+/*****************************************************************************
+ * Variant declarations
+ *****************************************************************************/
+static TouchProc_stFinger TouchProc_astFinger[TOUCH_POINT_MAX];
+static uint16_t           TouchProc_u16DAlpha; // 速度估计的滤波系数，截止频率固定
+
+static TouchProc_stRec TouchProc_astRec[TOUCHPROC_REC_NUM];
+static uint8_t         TouchProc_u8RecHead = 0;
+static uint8_t         TouchProc_u8RecTail = 0;
+/*****************************************************************************
+ * Local function prototypes
+ *****************************************************************************/
+static uint16_t TouchProc_u16Alpha(uint32_t u32CutChz);
+static void     TouchProc_vFilter(TouchProc_stFinger *pstFgr, uint16_t u16X, uint16_t u16Y);
+static void     TouchProc_vOutput(TouchProc_stFinger *pstFgr);
+static void     TouchProc_vRelease(TouchProc_stFinger *pstFgr, const Touch_stEvent *pstEvt);
+static bool     TouchProc_boPushRec(uint8_t u8Typ, uint8_t u8Id, uint16_t u16X, uint16_t u16Y, uint8_t u8Ext);
+static void     TouchProc_vSendRec(void);
+/*****************************************************************************
+ * function definitions
+ *****************************************************************************/
+void TouchProc_vInit(void)
+{
+    memset(TouchProc_astFinger, 0, sizeof(TouchProc_astFinger));
+
+    TouchProc_u16DAlpha = TouchProc_u16Alpha(TOUCHPROC_DCUT_CHZ);
+    TouchProc_u8RecHead = 0;
+    TouchProc_u8RecTail = 0;
+}
+
+void TouchProc_vPutEvent(const Touch_stEvent *pstEvt)
+{
+    TouchProc_stFinger *pstFgr;
+
+    if (pstEvt->u8Id >= TOUCH_POINT_MAX)
+    {
+        return;
+    }
+    else
+    {}
+
+    pstFgr = &TouchProc_astFinger[pstEvt->u8Id];
+
+    if (Touch_Up == pstEvt->u8Typ)
+    {
+        if (pstFgr->boDown)
+        {
+            TouchProc_vRelease(pstFgr, pstEvt);
+        }
+        else
+        {}
+    }
+    else if ((Touch_Down == pstEvt->u8Typ) || !pstFgr->boDown) // 丢失按下事件时按新按下处理
+    {
+        memset(pstFgr, 0, sizeof(TouchProc_stFinger));
+
+        pstFgr->boDown    = true;
+        pstFgr->s32X      = (int32_t)pstEvt->u16X * (1 << TOUCHPROC_FRAC);
+        pstFgr->s32Y      = (int32_t)pstEvt->u16Y * (1 << TOUCHPROC_FRAC);
+        pstFgr->u16DownX  = pstEvt->u16X;
+        pstFgr->u16DownY  = pstEvt->u16Y;
+        pstFgr->u16OutX   = pstEvt->u16X;
+        pstFgr->u16OutY   = pstEvt->u16Y;
+        pstFgr->u32DownMs = ProductLine_u32NowMs();
+
+        (void)TouchProc_boPushRec(TouchProc_Rec_Down, pstEvt->u8Id, pstEvt->u16X, pstEvt->u16Y, 0);
+    }
+    else
+    {
+        TouchProc_vFilter(pstFgr, pstEvt->u16X, pstEvt->u16Y);
+
+        if ((TOUCHPROC_ABS((int32_t)pstEvt->u16X - pstFgr->u16DownX) + TOUCHPROC_ABS((int32_t)pstEvt->u16Y - pstFgr->u16DownY)) > (int32_t)TOUCHPROC_SLOP_PX)
+        {
+            pstFgr->boMoved = true;
+        }
+        else
+        {}
+    }
+}
+
+void TouchProc_vHandle(void) // 5ms：长按判定，同一手指本周期的多帧移动只上报最后位置
+{
+    TouchProc_stFinger *pstFgr;
+    uint8_t             u8Id;
+
+    for (u8Id = 0; u8Id < TOUCH_POINT_MAX; u8Id++)
+    {
+        pstFgr = &TouchProc_astFinger[u8Id];
+
+        if (!pstFgr->boDown)
+        {}
+        else if (!pstFgr->boMoved)
+        {
+            if (!pstFgr->boLong && ((ProductLine_u32NowMs() - pstFgr->u32DownMs) >= TOUCHPROC_LONG_MS))
+            {
+                pstFgr->boLong = TouchProc_boPushRec(TouchProc_Rec_Long, u8Id, pstFgr->u16DownX, pstFgr->u16DownY, 0);
+            }
+            else
+            {}
+        }
+        else if (pstFgr->boNew) // 未离开按下位置时的抖动不上报
+        {
+            pstFgr->boNew = !TouchProc_boPushRec(TouchProc_Rec_Move, u8Id, pstFgr->u16OutX, pstFgr->u16OutY, 0);
+        }
+        else
+        {}
+    }
+
+    TouchProc_vSendRec();
+}
+
+bool TouchProc_boGetPrimary(uint16_t *pu16X, uint16_t *pu16Y)
+{
+    uint8_t u8Id;
+
+    for (u8Id = 0; u8Id < TOUCH_POINT_MAX; u8Id++)
+    {
+        if (TouchProc_astFinger[u8Id].boDown)
+        {
+            *pu16X = TouchProc_astFinger[u8Id].u16OutX;
+            *pu16Y = TouchProc_astFinger[u8Id].u16OutY;
+            return true;
+        }
+        else
+        {}
+    }
+
+    return false;
+}
+
+static uint16_t TouchProc_u16Alpha(uint32_t u32CutChz) // 一阶低通系数 a = 1 / (1 + 1 / (2π * fc * Te))
+{
+    uint32_t u32C = u32CutChz * TOUCHPROC_FRAME_MS * TOUCHPROC_2PI_MIL / 1000u; // 2π * fc * Te * TOUCHPROC_CUT_DEN
+
+    return (uint16_t)((u32C * TOUCHPROC_ALPHA_ONE) / (u32C + TOUCHPROC_CUT_DEN));
+}
+
+static void TouchProc_vFilter(TouchProc_stFinger *pstFgr, uint16_t u16X, uint16_t u16Y) // 先滤波速度，再按速度决定坐标的截止频率
+{
+    int32_t  s32InX = (int32_t)u16X * (1 << TOUCHPROC_FRAC);
+    int32_t  s32InY = (int32_t)u16Y * (1 << TOUCHPROC_FRAC);
+    uint32_t u32Speed;
+    uint32_t u32Cut;
+    uint16_t u16Alpha;
+
+    pstFgr->s32Dx += ((s32InX - pstFgr->s32X) - pstFgr->s32Dx) * TouchProc_u16DAlpha / (int32_t)TOUCHPROC_ALPHA_ONE;
+    pstFgr->s32Dy += ((s32InY - pstFgr->s32Y) - pstFgr->s32Dy) * TouchProc_u16DAlpha / (int32_t)TOUCHPROC_ALPHA_ONE;
+
+    u32Speed = (uint32_t)(TOUCHPROC_ABS(pstFgr->s32Dx) + TOUCHPROC_ABS(pstFgr->s32Dy)) * 1000u / (TOUCHPROC_FRAME_MS << TOUCHPROC_FRAC); // 像素/s
+    u32Cut   = TOUCHPROC_MINCUT_CHZ + u32Speed * TOUCHPROC_BETA / 100u;
+    u32Cut   = (u32Cut > TOUCHPROC_MAXCUT_CHZ) ? TOUCHPROC_MAXCUT_CHZ : u32Cut;
+    u16Alpha = TouchProc_u16Alpha(u32Cut);
+
+    pstFgr->s32X += (s32InX - pstFgr->s32X) * u16Alpha / (int32_t)TOUCHPROC_ALPHA_ONE;
+    pstFgr->s32Y += (s32InY - pstFgr->s32Y) * u16Alpha / (int32_t)TOUCHPROC_ALPHA_ONE;
+
+    TouchProc_vOutput(pstFgr);
+}
+
+static void TouchProc_vOutput(TouchProc_stFinger *pstFgr)
+{
+    int32_t s32X = pstFgr->s32X;
+    int32_t s32Y = pstFgr->s32Y;
+
+#ifdef TOUCHPROC_PREDICT
+    s32X += pstFgr->s32Dx;
+    s32Y += pstFgr->s32Dy;
+#endif
+
+    s32X = (s32X + (1 << (TOUCHPROC_FRAC - 1u))) / (1 << TOUCHPROC_FRAC);
+    s32Y = (s32Y + (1 << (TOUCHPROC_FRAC - 1u))) / (1 << TOUCHPROC_FRAC);
+    s32X = (s32X < 0) ? 0 : ((s32X > TOUCHPROC_COORD_MAX) ? TOUCHPROC_COORD_MAX : s32X);
+    s32Y = (s32Y < 0) ? 0 : ((s32Y > TOUCHPROC_COORD_MAX) ? TOUCHPROC_COORD_MAX : s32Y);
+
+    if ((s32X != pstFgr->u16OutX) || (s32Y != pstFgr->u16OutY))
+    {
+        pstFgr->u16OutX = (uint16_t)s32X;
+        pstFgr->u16OutY = (uint16_t)s32Y;
+        pstFgr->boNew   = true;
+    }
+    else
+    {}
+}
+
+static void TouchProc_vRelease(TouchProc_stFinger *pstFgr, const Touch_stEvent *pstEvt) // 抬起时按原始坐标判定点击/滑动
+{
+    uint32_t u32HoldMs = ProductLine_u32NowMs() - pstFgr->u32DownMs;
+    int32_t  s32Dx     = (int32_t)pstEvt->u16X - pstFgr->u16DownX;
+    int32_t  s32Dy     = (int32_t)pstEvt->u16Y - pstFgr->u16DownY;
+    uint8_t  u8Hold    = (u32HoldMs / 10u > 0xFFu) ? 0xFFu : (uint8_t)(u32HoldMs / 10u);
+    uint8_t  u8Dir;
+
+    pstFgr->boDown = false;
+
+    if (!pstFgr->boMoved && !pstFgr->boLong && (u32HoldMs <= TOUCHPROC_TAP_MS))
+    {
+        (void)TouchProc_boPushRec(TouchProc_Rec_Tap, pstEvt->u8Id, pstFgr->u16DownX, pstFgr->u16DownY, u8Hold);
+    }
+    else if ((u32HoldMs <= TOUCHPROC_SWIPE_MS) && ((TOUCHPROC_ABS(s32Dx) >= TOUCHPROC_SWIPE_PX) || (TOUCHPROC_ABS(s32Dy) >= TOUCHPROC_SWIPE_PX)))
+    {
+        if (TOUCHPROC_ABS(s32Dx) >= TOUCHPROC_ABS(s32Dy))
+        {
+            u8Dir = (s32Dx < 0) ? TouchProc_Dir_Left : TouchProc_Dir_Right;
+        }
+        else
+        {
+            u8Dir = (s32Dy < 0) ? TouchProc_Dir_Up : TouchProc_Dir_Down;
+        }
+
+        (void)TouchProc_boPushRec(TouchProc_Rec_Swipe, pstEvt->u8Id, pstFgr->u16DownX, pstFgr->u16DownY, u8Dir);
+    }
+    else
+    {}
+
+    (void)TouchProc_boPushRec(TouchProc_Rec_Up, pstEvt->u8Id, pstEvt->u16X, pstEvt->u16Y, u8Hold);
+}
+
+static bool TouchProc_boPushRec(uint8_t u8Typ, uint8_t u8Id, uint16_t u16X, uint16_t u16Y, uint8_t u8Ext) // 缓存过半后不再接收移动记录，给手势记录留出位置
+{
+    uint8_t u8Used = (TouchProc_u8RecHead - TouchProc_u8RecTail) & TOUCHPROC_REC_MASK;
+
+    if ((u8Used >= (TOUCHPROC_REC_NUM - 1u)) || ((TouchProc_Rec_Move == u8Typ) && (u8Used >= (TOUCHPROC_REC_NUM / 2u))))
+    {
+        return false;
+    }
+    else
+    {}
+
+    TouchProc_astRec[TouchProc_u8RecHead].u8Typ = u8Typ;
+    TouchProc_astRec[TouchProc_u8RecHead].u8Id  = u8Id;
+    TouchProc_astRec[TouchProc_u8RecHead].u16X  = u16X;
+    TouchProc_astRec[TouchProc_u8RecHead].u16Y  = u16Y;
+    TouchProc_astRec[TouchProc_u8RecHead].u8Ext = u8Ext;
+
+    TouchProc_u8RecHead = (TouchProc_u8RecHead + 1u) & TOUCHPROC_REC_MASK;
+
+    return true;
+}
+
+static void TouchProc_vSendRec(void)
+{
+    const TouchProc_stRec *pstRec;
+    uint8_t                au8CanTx[8];
+    uint8_t                u8Num;
+
+    for (u8Num = 0; (u8Num < TOUCHPROC_TX_NUM) && (TouchProc_u8RecHead != TouchProc_u8RecTail); u8Num++)
+    {
+        pstRec = &TouchProc_astRec[TouchProc_u8RecTail];
+
+        /*Tx 0x505*/
+        au8CanTx[0] = DEVICE_ID;
+        au8CanTx[1] = pstRec->u8Typ;
+        au8CanTx[2] = pstRec->u8Id;
+        au8CanTx[3] = (uint8_t)(pstRec->u16X >> 8u);
+        au8CanTx[4] = (uint8_t)pstRec->u16X;
+        au8CanTx[5] = (uint8_t)(pstRec->u16Y >> 8u);
+        au8CanTx[6] = (uint8_t)pstRec->u16Y;
+        au8CanTx[7] = pstRec->u8Ext;
+        CAN_Send_Msg(LX07_CAN_ID_TOUCH, au8CanTx);
+
+        TouchProc_u8RecTail = (TouchProc_u8RecTail + 1u) & TOUCHPROC_REC_MASK;
+    }
+}
+/*****************************************************************************
+ * End file TouchProc.c
+ *****************************************************************************/
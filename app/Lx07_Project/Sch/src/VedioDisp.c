@@ -24,6 +24,8 @@
  * Local macros
  *****************************************************************************/
 #define VEDIODISP_VPG_PICTURE_NUM (4)
+#define VEDIODISP_VPG_REG_NUM     (11u) // VPG颜色寄存器 0x01E5..0x01EF
+#define VEDIODISP_EEP_WR_MS       (15u) // Eep页写周期，写入后等待再复位或重配
 /*****************************************************************************
  * Local data types
  *****************************************************************************/
@@ -36,7 +38,7 @@ static uint8_t u8ColorTyp = 1;
 uint8_t     VedioDisp_u8FpsHz        = CAN_Write_Fps60HZ;
 static bool VedioDisp_boreadFpsHzFlg = false;
 
-static I2cSendData au8SerRGB[] =
+static I2cSendData au8SerRGB[VEDIODISP_VPG_REG_NUM] =
     {
         {DEV_SER, 0x01E5, 0x01},
         {DEV_SER, 0x01E6, 0x04},
@@ -66,7 +68,7 @@ bool VedioDisp_boReadFpsEnd(void)
     {
         boInitFlg = false;
 
-        ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Fps] = true;
+        ProductLine_boPost(ProDWork_Read_Fps, NULL);
     }
     else
     {}
@@ -83,8 +85,7 @@ void VedioDisp_vHandle(void) // 5ms
     {
 #ifdef ENABLE_HDMI
 #else
-        if (!ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_VPGColor])
-            ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_VPGColor] = true;
+        ProductLine_boPost(ProDWork_Write_VPGColor, NULL);
 
         if (u8ColorTyp < VEDIODISP_VPG_PICTURE_NUM)
         {
@@ -176,30 +177,36 @@ static void VedioDisp_vVpgColor(void)
 
 void VedioDisp_vWriteVpgColor(void) // 配置VPG模式下颜色
 {
-    static uint8_t u8StepWColorCt = 2;
+    static uint8_t u8StepWColorCt = 1;
 
-    if (2 == u8StepWColorCt)
+    if (1 == u8StepWColorCt)
     {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, DEV_SER);
-        I2C_Enable(I2C0_ID);
+        uint8_t au8Wr[2u + VEDIODISP_VPG_REG_NUM]; // 0x01E5..0x01EF地址连续，一次自增写完成
+        uint8_t u8Index;
 
-        u8StepWColorCt = 1;
-    }
-    else if (1 == u8StepWColorCt)
-    {
-        for (uint8_t u8Index = 0u; u8Index < 11u; u8Index++)
-            Ex_MstWriteBuffer(I2C0_ID, (uint8_t *)&au8SerRGB[u8Index].u16DstRegAddr, (uint8_t *)&au8SerRGB[u8Index].u8RegData);
+        au8Wr[0] = (uint8_t)(au8SerRGB[0].u16DstRegAddr >> 8u);
+        au8Wr[1] = (uint8_t)au8SerRGB[0].u16DstRegAddr;
 
-        u8StepWColorCt = 0;
+        for (u8Index = 0u; u8Index < VEDIODISP_VPG_REG_NUM; u8Index++)
+        {
+            au8Wr[2u + u8Index] = au8SerRGB[u8Index].u8RegData;
+        }
+
+        if (ProductLine_boI2cWrite(DEV_SER, au8Wr, sizeof(au8Wr)))
+        {
+            u8StepWColorCt = 0;
+        }
+        else
+        {}
 
         // UART_PRINTF("u8ColorTyp = %d\r\n", u8ColorTyp);
     }
-    else if (0 == u8StepWColorCt)
+
+    if (0 == u8StepWColorCt) // 写事务已排入总线队列，任务随即结束
     {
-        ProductLine_enCurWorkSts = ProDWork_Idle;
+        ProductLine_vJobDone(ProDWork_Write_VPGColor);
 
-        u8StepWColorCt = 2;
+        u8StepWColorCt = 1;
     }
     else
     {}
@@ -207,37 +214,31 @@ void VedioDisp_vWriteVpgColor(void) // 配置VPG模式下颜色
 
 void VedioDisp_vReadFps(void) // 从Eep读Fps
 {
-    static uint8_t u8StepRdFpsCt = 3;
-    uint8_t        u8Addr        = 0x7B;
+    static uint8_t u8StepRdFpsCt = 2;
 
-    if (3 == u8StepRdFpsCt)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x54);
-        I2C_Enable(I2C0_ID);
-        u8StepRdFpsCt = 2;
-    }
-    else if (2 == u8StepRdFpsCt)
+    if (2 == u8StepRdFpsCt)
     {
-        Ex_MstReadArray(I2C0_ID, (uint8_t *)(&u8Addr));
-        ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Fps] = true;
-
-        u8StepRdFpsCt = 1;
+        if (ProductLine_boI2cRead(ProD_I2c_Read_Fps, DEV_EEP, 0x7B))
+        {
+            u8StepRdFpsCt = 1;
+        }
+        else
+        {}
     }
     else if (1 == u8StepRdFpsCt)
     {
         if (!ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[ProD_I2c_Read_Fps])
         {
-            ProductLine_enCurWorkSts = ProDWork_Idle;
-            u8StepRdFpsCt            = 3;
+            ProductLine_vJobDone(ProDWork_Read_Fps);
+            u8StepRdFpsCt = 2;
 
-            if ((CAN_Write_Fps60HZ != ProductLine_stI2cRWMsgs.Read_t.au8Data[0]) && (CAN_Write_Fps45HZ != ProductLine_stI2cRWMsgs.Read_t.au8Data[0]))
+            if ((CAN_Write_Fps60HZ != ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_Fps][0]) && (CAN_Write_Fps45HZ != ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_Fps][0]))
             {
                 VedioDisp_u8FpsHz = CAN_Write_Fps60HZ; // Eep还未写入Fps
             }
             else
             {
-                VedioDisp_u8FpsHz = ProductLine_stI2cRWMsgs.Read_t.au8Data[0]; // read data
+                VedioDisp_u8FpsHz = ProductLine_stI2cRWMsgs.Read_t.au8Data[ProD_I2c_Read_Fps][0]; // read data
             }
 
             VedioDisp_boreadFpsHzFlg = true;
@@ -251,24 +252,24 @@ void VedioDisp_vReadFps(void) // 从Eep读Fps
 
 void VedioDisp_vWriteFps(void)
 {
-    static uint8_t u8StepWrFpsCt = 5;
+    static uint8_t  u8StepWrFpsCt = 2;
+    static uint32_t u32WrMs       = 0;
 
     uint8_t au8WriteFps[2] = {0x7B, 0x00}; // 写入地址：0x7B
 
-    if (5 == u8StepWrFpsCt)
-    {
-        I2C_Disable(I2C0_ID);
-        I2C_SetTargetAddr(I2C0_ID, 0x54);
-        I2C_Enable(I2C0_ID);
-        u8StepWrFpsCt = 4;
-    }
-    else if (4 == u8StepWrFpsCt)
+    if (2 == u8StepWrFpsCt)
     {
         au8WriteFps[1] = VedioDisp_u8FpsHz;
 
-        Ex_MstWriteEEP(I2C0_ID, (uint8_t *)(&au8WriteFps[0]), 1);
+        if (!ProductLine_boI2cWrite(DEV_EEP, au8WriteFps, sizeof(au8WriteFps)))
+        {
+            return; // 下个周期重试
+        }
+        else
+        {}
 
-        u8StepWrFpsCt = 3;
+        u8StepWrFpsCt = 1;
+        u32WrMs       = ProductLine_u32NowMs();
 
         /*Tx 0x500*/
         memset(stCanRxBuf.data, 0, 8);
@@ -276,21 +277,25 @@ void VedioDisp_vWriteFps(void)
         stCanRxBuf.data[2] = 0x01;
         CAN_Send_Msg(0x500, stCanRxBuf.data);
     }
-    else if (3 == u8StepWrFpsCt)
-    {
-        u8StepWrFpsCt = 2;
-    }
-    else if (2 == u8StepWrFpsCt)
-    {
-        u8StepWrFpsCt = 1;
-    }
     else if (1 == u8StepWrFpsCt)
     {
-        ProductLine_enCurWorkSts = ProDWork_Idle;
+        if ((ProductLine_u32NowMs() - u32WrMs) < VEDIODISP_EEP_WR_MS) // 其他任务的读完成事件也会调用本函数，按时间而不是调用次数等待
+        {
+            return;
+        }
+        else
+        {}
+
+        ProductLine_vJobDone(ProDWork_Write_Fps);
 
-        u8StepWrFpsCt = 5;
+        u8StepWrFpsCt = 2;
 
-        NVIC_SystemReset();
+        if (!Lx07_boReqRetime(VedioDisp_u8FpsHz)) // 差异寄存器在线写入，不能在线切换时才复位
+        {
+            NVIC_SystemReset();
+        }
+        else
+        {}
     }
     else
     {}
@@ -63,16 +63,12 @@ extern void delay(volatile int cycles);
 
 int platform_i2c_write(uint8_t *txBuffer, uint16_t len)
 {
-    I2C_vSendBuffer(I2C0_ID,txBuffer,len);
-
-    return 0;
+    return I2C_boSendBuffer(I2C0_ID,txBuffer,len) ? 0 : -1;
 }
 
 int platform_i2c_read(uint8_t *txBuffer, uint16_t len)
 {
-    I2C_vReadBuffer(I2C0_ID,txBuffer,len);
-
-    return 0;
+    return I2C_boReadBuffer(I2C0_ID,txBuffer,len) ? 0 : -1;
 }
 
 /*delay, unit: millisecond */
@@ -22,6 +22,8 @@
 #include "Lx07.h"
 #include "Touch.h"
 #include "VedioDisp.h"
+#include "Scheduler.h"
+#include "Scheduler_Cfg.h"
 
 #define CAN_EEP_ReadAddr_OFFSET (0x20)
 
@@ -89,19 +91,31 @@ void RxFifo_Callback(void)
         switch (u8CanData0)
         {
             case CAN_READ_Bkl: // i2c read Bkl
-                ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Bkl] = true;
+                ProductLine_boPost(ProDWork_Read_Bkl, NULL);
                 break;
             case CAN_READ_LcdTemp: // i2c read lcd temp
-                ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_LcdTemp] = true;
-                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp]  = true;
+                ProductLine_boPost(ProDWork_Read_LcdTemp, NULL);
+                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_LcdTemp] = true;
                 break;
             case CAN_READ_PcbTemp: // i2c read Pcb temp
-                ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_PcbTemp] = true;
-                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp]  = true;
+                ProductLine_boPost(ProDWork_Read_PcbTemp, NULL);
+                ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_PcbTemp] = true;
+                break;
+            case CAN_READ_CpuLoad:
+                Lx07_vReqCpuLoad();
+                break;
+            case CAN_READ_I2cErr:
+                Lx07_vReqI2cErr();
+                break;
+            case CAN_READ_RegChk:
+                Lx07_vReqRegChk();
+                break;
+            case CAN_READ_JobStat:
+                Lx07_vReqJobStat();
                 break;
             // case CAN_READ_Batt:
-            //     ProductLine_stI2cRWMsgs.Read_t.aboStrtFlg[ProD_I2c_Read_Batt] = true;
-            //     ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt]  = true;
+            //     ProductLine_boPost(ProDWork_Read_Batt, NULL);
+            //     ProductLine_stI2cRWMsgs.Read_t.aboHaveTx[ProD_I2c_Read_Batt] = true;
             //     break;
             default:
                 break;
@@ -111,16 +125,15 @@ void RxFifo_Callback(void)
     {
         switch (u8CanData0)
         {
-            case CAN_Write_Bkl: // Write Bkl
-                ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Bkl] = true;
+            case CAN_Write_Bkl: // Write Bkl，渐变及写入由BackL_vHandle完成
                 BackL_vWriteLevFromCan(stCanRxBuf.data[1]);
                 break;
             case CAN_Write_Fps60HZ:
-                ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Fps] = true;
+                ProductLine_boPost(ProDWork_Write_Fps, NULL);
                 VedioDisp_vCfgFpsFromCan(u8CanData0);
                 break;
             case CAN_Write_Fps45HZ:
-                ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_Fps] = true;
+                ProductLine_boPost(ProDWork_Write_Fps, NULL);
                 VedioDisp_vCfgFpsFromCan(u8CanData0);
                 break;
             default:
@@ -128,7 +141,7 @@ void RxFifo_Callback(void)
 #else
                 if (((u8CanData0 >= CAN_Write_LastVpgPicture) && (u8CanData0 <= CAN_Write_NextVpgPicture)) || ((u8CanData0 >= CAN_Write_VpgRed) && (u8CanData0 <= CAN_Write_VpgWhite)))
                 {
-                    ProductLine_stI2cRWMsgs.Write_t.aboWFlg[ProD_I2c_Write_VPGColor] = true;
+                    ProductLine_boPost(ProDWork_Write_VPGColor, NULL);
                     VedioDisp_vCfgVpgColorFromCan(u8CanData0);
                 }
                 else
@@ -139,6 +152,8 @@ void RxFifo_Callback(void)
     }
     else
     {}
+
+    Sch_PostEvent(SCH_EVENT_CAN_RX);
 }
 
 void CAN_Send_Msg(uint32_t msgId, const uint8_t *msgData)
@@ -15,12 +15,24 @@
 #include "Z20K11xM_gpio.h"
 #include "Lx07.h"
 #include "Eeprom.h"
-#include "ProductLine.h"
+#include "I2cXfer.h"
 
 // #define DISABLE_I2C0_ALL_INT
 
 #define DES_REG_ADDR_BYTE 2
 
+#define I2C_WAIT_LOOP_MAX    (5000u) // 阻塞接口等待FIFO的循环上限
+#define I2C_RECOVER_CLK_NUM  (9u)    // 总线恢复时最多补发的SCL时钟数
+#define I2C_RECOVER_HALF_DLY (40)    // SCL半周期，约5us@64MHz
+
+extern void delay(volatile int cycles);
+
+/* callback */
+static void I2C_MasterRecvCallBack(void);
+static void I2C_MasterStopGeneratedCallBack(void);
+static void I2C_MasterTxEmptyCallBack(void);
+static void I2C_MasterAbortCallBack(void);
+
 bool boI2c0IsIdle = true;
 
 I2C_Config_t slaveConfig =
@@ -68,163 +80,290 @@ const I2C_FifoConfig_t masterFifoConfig =
 
 };
 
-void MstRecvByType(I2C_Id_t i2cNo, uint16_t len, I2C_RestartStop_t restartStopType)
+static bool I2c_boWaitTx(I2C_Id_t i2cNo) // 等待TX FIFO有空位，超时返回false
 {
-    int delay_cnt = 0u;
-    /* When TX FIFO is not full, the master sends a command to read */
+    uint16_t u16Cnt = 0u;
+
     while (RESET == I2C_GetStatus(i2cNo, I2C_STATUS_TFNF))
     {
-        if (delay_cnt > 5000) // test time
+        u16Cnt++;
+        if (u16Cnt > I2C_WAIT_LOOP_MAX)
         {
-            I2c_Init();
-            delay_cnt = 0u;
-            return;
+            return false;
         }
+        else
+        {}
+    }
+
+    return true;
+}
+
+static bool I2c_boWaitRx(I2C_Id_t i2cNo) // 等待RX FIFO有数据，超时返回false
+{
+    uint16_t u16Cnt = 0u;
+
+    while (RESET == I2C_GetStatus(i2cNo, I2C_STATUS_RFNE))
+    {
+        u16Cnt++;
+        if (u16Cnt > I2C_WAIT_LOOP_MAX)
+        {
+            return false;
+        }
+        else
+        {}
+    }
+
+    return true;
+}
+
+/* 阻塞接口超时后只恢复总线并返回false，不再在事务中途重新初始化整个I2C */
+bool MstRecvByType(I2C_Id_t i2cNo, uint16_t len, I2C_RestartStop_t restartStopType)
+{
+    /* When TX FIFO is not full, the master sends a command to read */
+    if (!I2c_boWaitTx(i2cNo))
+    {
+        (void)I2c_boBusRecover(i2cNo);
+        return false;
     }
+    else
+    {}
 
     I2C_MasterReadCmd(i2cNo, restartStopType);
+    return true;
 }
 
-void MstSendByType(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType)
+bool MstSendByType(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType)
 {
-    int delay_cnt = 0u;
     // for(int i = 0; i < len; i++)
     for (int i = (len - 1); i >= 0; i--)
     {
         /* When TX FIFO is not full, the master sends one byte */
-        while (RESET == I2C_GetStatus(i2cNo, I2C_STATUS_TFNF))
+        if (!I2c_boWaitTx(i2cNo))
         {
-            delay_cnt++;
-            if (delay_cnt > 5000) // test time
-            {
-                I2c_Init();
-                delay_cnt = 0u;
-                return;
-            }
+            (void)I2c_boBusRecover(i2cNo);
+            return false;
         }
+        else
+        {}
+
         I2C_MasterSendByte(i2cNo, restartStopType, *(gTxBuffer + i));
     }
+
+    return true;
 }
 
-static void MstSendByType1(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType)
+static bool MstSendByType1(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType)
 {
-    uint16_t delay_cnt = 0;
     for (int i = 0; i < len; i++)
     {
         /* When TX FIFO is not full, the master sends one byte */
-        while (RESET == I2C_GetStatus(i2cNo, I2C_STATUS_TFNF))
+        if (!I2c_boWaitTx(i2cNo))
         {
-            delay_cnt++;
-            if (delay_cnt > 5000) // test time
-            {
-                I2c_Init();
-                delay_cnt = 0u;
-                return;
-            }
+            (void)I2c_boBusRecover(i2cNo);
+            return false;
         }
+        else
+        {}
+
         I2C_MasterSendByte(i2cNo, restartStopType, *(gTxBuffer + i));
     }
+
+    return true;
 }
 
 /* Write one byte of data to the destination address of the deserializer */
-void Ex_MstWriteBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
+bool Ex_MstWriteBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
 {
-    MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
 }
 
 // lx07 往一个字节地址写入一个字节数据
-void Lx07_MstWriteByte(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
+bool Lx07_MstWriteByte(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
 {
-    MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
 }
 
-void Ex_MstWriteBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
+bool Ex_MstWriteBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data)
 {
-    MstSendByType(i2cNo, DestAddr, 1u, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType(i2cNo, Data, 2, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, 1u, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType(i2cNo, Data, 2, I2C_STOP_EN);
 }
 
-void Ex_MstWriteBLK(I2C_Id_t i2cNo, uint8_t *Data)
+bool Ex_MstWriteBLK(I2C_Id_t i2cNo, uint8_t *Data)
 {
-    MstSendByType1(i2cNo, Data, 2u, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType1(i2cNo, Data + 2, 1, I2C_STOP_EN);
+    return MstSendByType1(i2cNo, Data, 2u, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType1(i2cNo, Data + 2, 1, I2C_STOP_EN);
 }
 
-void Ex_MstWriteDoubleByte(I2C_Id_t i2cNo, uint8_t *Data)
+bool Ex_MstWriteDoubleByte(I2C_Id_t i2cNo, uint8_t *Data)
 {
-    MstSendByType1(i2cNo, Data, 2u, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType1(i2cNo, Data + 2, 1, I2C_STOP_EN);
+    return MstSendByType1(i2cNo, Data, 2u, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType1(i2cNo, Data + 2, 1, I2C_STOP_EN);
 }
 
 /* Write one byte of data to the destination address of the deserializer */
-void Ex_MstWriteData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data, uint8_t Len)
+bool Ex_MstWriteData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data, uint8_t Len)
 {
-    MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType1(i2cNo, Data, Len - 1u, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType1(i2cNo, Data, Len - 1u, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType(i2cNo, Data, 1, I2C_STOP_EN);
 }
 
-void Ex_MstWriteArray(I2C_Id_t i2cNo, uint8_t *Data)
+bool Ex_MstWriteArray(I2C_Id_t i2cNo, uint8_t *Data)
 {
-    MstSendByType1(i2cNo, Data, 7u, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType1(i2cNo, Data + 7, 1, I2C_STOP_EN);
+    return MstSendByType1(i2cNo, Data, 7u, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType1(i2cNo, Data + 7, 1, I2C_STOP_EN);
 }
 
-void Ex_MstReadArray(I2C_Id_t i2cNo, uint8_t *DestAddr)
+bool Ex_MstReadArray(I2C_Id_t i2cNo, uint8_t *DestAddr)
 {
-    MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE);
-    MstRecvByType(i2cNo, 1, I2C_RESTART_AND_STOP_DISABLE);
+    return MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE) && MstRecvByType(i2cNo, 1, I2C_RESTART_AND_STOP_DISABLE);
 }
 
 /* Read one byte of data from the destination address of the deserializer */
-void Ex_MstReadBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr)
+bool Ex_MstReadBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr)
 {
-    MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE);
-    MstRecvByType(i2cNo, 1, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, DES_REG_ADDR_BYTE, I2C_RESTART_AND_STOP_DISABLE) && MstRecvByType(i2cNo, 1, I2C_STOP_EN);
 }
 
-void Ex_MstReadBuffersss(I2C_Id_t i2cNo, uint8_t *DestAddr)
+bool Ex_MstReadBuffersss(I2C_Id_t i2cNo, uint8_t *DestAddr)
 {
-    MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE);
-    MstRecvByType(i2cNo, 1, I2C_STOP_EN);
+    return MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE) && MstRecvByType(i2cNo, 1, I2C_STOP_EN);
 }
 
-void Ex_MstReadBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr)
+bool Ex_MstReadBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr)
 {
-    MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE);
-    MstRecvByType(i2cNo, 1, I2C_RESTART_AND_STOP_DISABLE);
+    return MstSendByType(i2cNo, DestAddr, 1, I2C_RESTART_AND_STOP_DISABLE) && MstRecvByType(i2cNo, 1, I2C_RESTART_AND_STOP_DISABLE);
 }
 
-void Ex_MstWriteEEP(I2C_Id_t i2cNo, uint8_t *Data, uint8_t length)
+bool Ex_MstWriteEEP(I2C_Id_t i2cNo, uint8_t *Data, uint8_t length)
 {
-    MstSendByType1(i2cNo, Data, length, I2C_RESTART_AND_STOP_DISABLE);
-    MstSendByType1(i2cNo, Data + length, 1, I2C_STOP_EN);
+    return MstSendByType1(i2cNo, Data, length, I2C_RESTART_AND_STOP_DISABLE) && MstSendByType1(i2cNo, Data + length, 1, I2C_STOP_EN);
 }
 
 /*Lx07:Touch*/
-void I2C_vSendBuffer(I2C_Id_t i2cId, uint8_t *txBuffer, uint16_t len)
+bool I2C_boSendBuffer(I2C_Id_t i2cId, uint8_t *txBuffer, uint16_t len)
 {
     for (int i = 0; i < len; i++)
     {
         /* When TX FIFO is not full, the master sends one byte */
-        while (RESET == I2C_GetStatus(i2cId, I2C_STATUS_TFNF));
+        if (!I2c_boWaitTx(i2cId))
+        {
+            (void)I2c_boBusRecover(i2cId);
+            return false;
+        }
+        else
+        {}
+
         I2C_MasterSendByte(i2cId, I2C_RESTART_AND_STOP_DISABLE, *(txBuffer + i));
     }
+
+    return true;
 }
 
-void I2C_vReadBuffer(I2C_Id_t i2cId, uint8_t *rxBuffer, uint16_t len)
+bool I2C_boReadBuffer(I2C_Id_t i2cId, uint8_t *rxBuffer, uint16_t len)
 {
     for (int i = 0; i < len; i++)
     {
         /* When TX FIFO is not full, the master sends a command to read */
-        while (RESET == I2C_GetStatus(i2cId, I2C_STATUS_TFNF));
+        if (!I2c_boWaitTx(i2cId))
+        {
+            (void)I2c_boBusRecover(i2cId);
+            return false;
+        }
+        else
+        {}
+
         I2C_MasterReadCmd(i2cId, I2C_RESTART_AND_STOP_DISABLE);
+
         /* When RX FIFO is not empty, the master receives one byte */
-        while (RESET == I2C_GetStatus(i2cId, I2C_STATUS_RFNE));
+        if (!I2c_boWaitRx(i2cId))
+        {
+            (void)I2c_boBusRecover(i2cId);
+            return false;
+        }
+        else
+        {}
+
         *(rxBuffer + i) = I2C_ReceiveByte(i2cId);
     }
+
+    return true;
+}
+
+void I2c_vSetScl(I2C_Id_t i2cNo, I2C_Speed_t speedMode, uint16_t u16HCnt, uint16_t u16LCnt) // SDK只提供固定的SCL计数，按功能时钟算好的计数在此写入
+{
+    i2c_reg_t *pstReg = (i2c_reg_t *)((I2C0_ID == i2cNo) ? I2C0_BASE_ADDR : I2C1_BASE_ADDR);
+
+    I2C_SclHighCount(i2cNo, speedMode); // 选择速率，计数在下面覆盖
+    I2C_LimitSpikeSuppression(i2cNo, speedMode);
+
+    if (I2C_SPEED_STANDARD == speedMode)
+    {
+        pstReg->I2C_STD_SCL_HCNT.STD_SCL_HCNT = u16HCnt;
+        pstReg->I2C_STD_SCL_LCNT.STD_SCL_LCNT = u16LCnt;
+    }
+    else
+    {
+        pstReg->I2C_FST_SCL_HCNT.FST_SCL_HCNT = u16HCnt;
+        pstReg->I2C_FST_SCL_LCNT.FST_SCL_LCNT = u16LCnt;
+    }
+}
+
+bool I2c_boBusRecover(I2C_Id_t i2cNo) // SDA被从机拉住时补发SCL时钟并产生STOP，返回总线是否已释放
+{
+    PORT_GPIONO_t enScl = (I2C0_ID == i2cNo) ? GPIO_3 : GPIO_0;
+    PORT_GPIONO_t enSda = (I2C0_ID == i2cNo) ? GPIO_2 : GPIO_1;
+    uint8_t       u8Clk;
+    bool          boFree;
+
+    I2C_Disable(i2cNo); // 同时清空FIFO，其余配置保留
+
+    /* 切换为开漏GPIO，先输出高电平再切复用，避免产生毛刺 */
+    GPIO_WritePinOutput(PORT_A, enScl, GPIO_HIGH);
+    GPIO_WritePinOutput(PORT_A, enSda, GPIO_HIGH);
+    GPIO_SetPinDir(PORT_A, enScl, GPIO_OUTPUT);
+    GPIO_SetPinDir(PORT_A, enSda, GPIO_OUTPUT);
+    PORT_OpenDrainConfig(PORT_A, enScl, ENABLE);
+    PORT_OpenDrainConfig(PORT_A, enSda, ENABLE);
+    PORT_PinmuxConfig(PORT_A, enScl, PTA3_GPIO); // PTA0~PTA3的GPIO复用功能相同
+    PORT_PinmuxConfig(PORT_A, enSda, PTA2_GPIO);
+    delay(I2C_RECOVER_HALF_DLY);
+
+    for (u8Clk = 0u; (u8Clk < I2C_RECOVER_CLK_NUM) && (GPIO_LOW == GPIO_ReadPinLevel(PORT_A, enSda)); u8Clk++)
+    {
+        GPIO_WritePinOutput(PORT_A, enScl, GPIO_LOW);
+        delay(I2C_RECOVER_HALF_DLY);
+        GPIO_WritePinOutput(PORT_A, enScl, GPIO_HIGH);
+        delay(I2C_RECOVER_HALF_DLY);
+    }
+
+    /* STOP：SCL为高时SDA由低变高，让从机状态机回到空闲 */
+    GPIO_WritePinOutput(PORT_A, enScl, GPIO_LOW);
+    delay(I2C_RECOVER_HALF_DLY);
+    GPIO_WritePinOutput(PORT_A, enSda, GPIO_LOW);
+    delay(I2C_RECOVER_HALF_DLY);
+    GPIO_WritePinOutput(PORT_A, enScl, GPIO_HIGH);
+    delay(I2C_RECOVER_HALF_DLY);
+    GPIO_WritePinOutput(PORT_A, enSda, GPIO_HIGH);
+    delay(I2C_RECOVER_HALF_DLY);
+
+    boFree = (GPIO_HIGH == GPIO_ReadPinLevel(PORT_A, enSda)) && (GPIO_HIGH == GPIO_ReadPinLevel(PORT_A, enScl));
+
+    PORT_OpenDrainConfig(PORT_A, enScl, DISABLE);
+    PORT_OpenDrainConfig(PORT_A, enSda, DISABLE);
+
+    if (I2C0_ID == i2cNo)
+    {
+        PORT_PinmuxConfig(PORT_A, GPIO_2, PTA2_I2C0_SDA);
+        PORT_PinmuxConfig(PORT_A, GPIO_3, PTA3_I2C0_SCL);
+    }
+    else
+    {
+        PORT_PinmuxConfig(PORT_A, GPIO_0, PTA0_I2C1_SCL);
+        PORT_PinmuxConfig(PORT_A, GPIO_1, PTA1_I2C1_SDA);
+    }
+
+    I2C_ClearErrorStatusAll(i2cNo);
+    I2C_ClearInt(i2cNo, I2C_INT_ERROR_ABORT);
+    I2C_ClearInt(i2cNo, I2C_INT_STOP_DET);
+    I2C_Enable(i2cNo);
+
+    return boFree;
 }
 
 static void I2C_MasterRecvCallBack(void)
@@ -232,16 +371,38 @@ static void I2C_MasterRecvCallBack(void)
     I2C_ClearInt(I2C0_ID, I2C_INT_RX_FULL);
     boI2c0IsIdle = false;
 
-    uint8_t u8tets = 0;
+    I2cXfer_vRxFullIsr(I2C0_ID);
+}
+
+static void I2C_MasterTxEmptyCallBack(void)
+{
+    I2cXfer_vTxEmptyIsr(I2C0_ID);
+}
 
-    ProductLine_vI2cRecvHandle();
+static void I2C_MasterAbortCallBack(void)
+{
+    I2C_ClearInt(I2C0_ID, I2C_INT_ERROR_ABORT);
 
-    u8tets = I2C_ReceiveByte(I2C0_ID);
+    I2cXfer_vAbortIsr(I2C0_ID);
 }
 
 static void I2C1_MasterRecvCallBack(void)
 {
     I2C_ClearInt(I2C1_ID, I2C_INT_RX_FULL);
+
+    I2cXfer_vRxFullIsr(I2C1_ID);
+}
+
+static void I2C1_MasterTxEmptyCallBack(void)
+{
+    I2cXfer_vTxEmptyIsr(I2C1_ID);
+}
+
+static void I2C1_MasterAbortCallBack(void)
+{
+    I2C_ClearInt(I2C1_ID, I2C_INT_ERROR_ABORT);
+
+    I2cXfer_vAbortIsr(I2C1_ID);
 }
 
 static void I2C_MasterStopGeneratedCallBack(void)
@@ -249,12 +410,14 @@ static void I2C_MasterStopGeneratedCallBack(void)
     I2C_ClearInt(I2C0_ID, I2C_INT_STOP_DET);
     boI2c0IsIdle = true;
 
-    ProductLine_vI2cStopHandle();
+    I2cXfer_vStopIsr(I2C0_ID);
 }
 
 static void I2C1_MasterStopGeneratedCallBack(void)
 {
     I2C_ClearInt(I2C1_ID, I2C_INT_STOP_DET);
+
+    I2cXfer_vStopIsr(I2C1_ID);
 }
 
 void I2c_Init(void)
@@ -275,6 +438,10 @@ void I2c_Init(void)
     I2C_IntCmd(I2C0_ID, I2C_INT_RX_FULL, ENABLE);
     I2C_InstallCallBackFunc(I2C0_ID, I2C_INT_STOP_DET, I2C_MasterStopGeneratedCallBack);
     I2C_IntCmd(I2C0_ID, I2C_INT_STOP_DET, ENABLE);
+    I2C_InstallCallBackFunc(I2C0_ID, I2C_INT_ERROR_ABORT, I2C_MasterAbortCallBack);
+    I2C_IntCmd(I2C0_ID, I2C_INT_ERROR_ABORT, ENABLE);
+    I2C_InstallCallBackFunc(I2C0_ID, I2C_INT_TX_EMPTY, I2C_MasterTxEmptyCallBack); // 由I2cXfer按需打开
+    I2C_IntCmd(I2C0_ID, I2C_INT_TX_EMPTY, DISABLE);
 #endif
 
     I2C_Disable(I2C0_ID);
@@ -299,6 +466,10 @@ void I2c_Init(void)
     I2C_IntCmd(I2C1_ID, I2C_INT_RX_FULL, ENABLE);
     I2C_InstallCallBackFunc(I2C1_ID, I2C_INT_STOP_DET, I2C1_MasterStopGeneratedCallBack);
     I2C_IntCmd(I2C1_ID, I2C_INT_STOP_DET, ENABLE);
+    I2C_InstallCallBackFunc(I2C1_ID, I2C_INT_ERROR_ABORT, I2C1_MasterAbortCallBack);
+    I2C_IntCmd(I2C1_ID, I2C_INT_ERROR_ABORT, ENABLE);
+    I2C_InstallCallBackFunc(I2C1_ID, I2C_INT_TX_EMPTY, I2C1_MasterTxEmptyCallBack); // 由I2cXfer按需打开
+    I2C_IntCmd(I2C1_ID, I2C_INT_TX_EMPTY, DISABLE);
 
     I2C_Disable(I2C1_ID);
     I2C_Init(I2C1_ID, &masterConfig1);
@@ -307,4 +478,6 @@ void I2c_Init(void)
     I2C_Enable(I2C1_ID);
     NVIC_SetPriority(I2C1_IRQn, 0u);
     NVIC_EnableIRQ(I2C1_IRQn);
+
+    I2cXfer_vInit(); // 会访问控制器寄存器，两个控制器时钟使能后再调用
 }
@@ -24,24 +24,23 @@ extern void I2c_Init(void);
 
 extern bool boI2c0IsIdle;
 
-/* master */
-extern void MstRecvByType(I2C_Id_t i2cNo, uint16_t len, I2C_RestartStop_t restartStopType);
-extern void MstSendByType(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType);
-extern void Ex_MstWriteBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
-void        Lx07_MstWriteByte(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
-extern void Ex_MstWriteArray(I2C_Id_t i2cNo, uint8_t *Data);
-extern void Ex_MstReadArray(I2C_Id_t i2cNo, uint8_t *DestAddr);
-extern void Ex_MstReadBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr);
-extern void Ex_MstWriteData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data, uint8_t Len);
-extern void Ex_MstWriteBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
-extern void Ex_MstReadBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr);
-extern void Ex_MstWriteBLK(I2C_Id_t i2cNo, uint8_t *Data);
-extern void Ex_MstWriteDoubleByte(I2C_Id_t i2cNo, uint8_t *Data);
-extern void Ex_MstReadBuffersss(I2C_Id_t i2cNo, uint8_t *Data);
-extern void Ex_MstWriteEEP(I2C_Id_t i2cNo, uint8_t *Data, uint8_t length);
+/* master，超时返回false，此时总线已恢复 */
+extern bool MstRecvByType(I2C_Id_t i2cNo, uint16_t len, I2C_RestartStop_t restartStopType);
+extern bool MstSendByType(I2C_Id_t i2cNo, uint8_t *gTxBuffer, uint16_t len, I2C_RestartStop_t restartStopType);
+extern bool Ex_MstWriteBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
+bool        Lx07_MstWriteByte(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
+extern bool Ex_MstWriteArray(I2C_Id_t i2cNo, uint8_t *Data);
+extern bool Ex_MstReadArray(I2C_Id_t i2cNo, uint8_t *DestAddr);
+extern bool Ex_MstReadBuffer(I2C_Id_t i2cNo, uint8_t *DestAddr);
+extern bool Ex_MstWriteData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data, uint8_t Len);
+extern bool Ex_MstWriteBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr, uint8_t *Data);
+extern bool Ex_MstReadBLKData(I2C_Id_t i2cNo, uint8_t *DestAddr);
+extern bool Ex_MstWriteBLK(I2C_Id_t i2cNo, uint8_t *Data);
+extern bool Ex_MstWriteDoubleByte(I2C_Id_t i2cNo, uint8_t *Data);
+extern bool Ex_MstReadBuffersss(I2C_Id_t i2cNo, uint8_t *Data);
+extern bool Ex_MstWriteEEP(I2C_Id_t i2cNo, uint8_t *Data, uint8_t length);
 
-/* callback */
-static void I2C_MasterRecvCallBack(void);
-static void I2C_MasterStopGeneratedCallBack(void);
+extern bool I2c_boBusRecover(I2C_Id_t i2cNo); // 控制器禁止后用GPIO补发SCL时钟和STOP
+extern void I2c_vSetScl(I2C_Id_t i2cNo, I2C_Speed_t speedMode, uint16_t u16HCnt, uint16_t u16LCnt); // 控制器禁止时调用
 
 #endif /* I2C_H */
@@ -29,6 +29,7 @@
 #include "wdog.h"
 #include "SysTick.h"
 #include "Scheduler.h"
+#include "Scheduler_Cfg.h"
 #include "can.h"
 #include "Uart2.h"
 #include "Config.h"
@@ -136,6 +137,7 @@ void PortCInt(PORT_ID_t portId, PORT_GPIONO_t gpioNo)
         // Debounce_vInIRQ(&Debounce_StTpTrigger);
 #endif
         Touch_boMisTpIntFlg = true;
+        Sch_PostEvent(SCH_EVENT_TOUCH_INT);
 
         // fts_gpio_interrupt_handler();
     }
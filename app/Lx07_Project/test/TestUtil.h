@@ -0,0 +1,42 @@
+#ifndef _TESTUTIL_H_
+#define _TESTUTIL_H_
+
+/* Minimal check helpers shared by the host tests, one test program per file */
+#include <stdio.h>
+#include <stdint.h>
+
+static uint32_t Test_u32Checks = 0u;
+static uint32_t Test_u32Fails  = 0u;
+
+#define TEST_CHECK(Cond)                                                          \
+    do                                                                            \
+    {                                                                             \
+        Test_u32Checks += 1u;                                                     \
+        if (!(Cond))                                                              \
+        {                                                                         \
+            Test_u32Fails += 1u;                                                  \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #Cond);      \
+        }                                                                         \
+    } while (0)
+
+/* Same as TEST_CHECK, prints the two values on failure */
+#define TEST_CHECK_RANGE(Val, Min, Max)                                           \
+    do                                                                            \
+    {                                                                             \
+        long long llVal = (long long)(Val);                                       \
+        Test_u32Checks += 1u;                                                     \
+        if ((llVal < (long long)(Min)) || (llVal > (long long)(Max)))             \
+        {                                                                         \
+            Test_u32Fails += 1u;                                                  \
+            printf("%s:%d: %s = %lld, expected %lld..%lld\n", __FILE__, __LINE__, \
+                   #Val, llVal, (long long)(Min), (long long)(Max));              \
+        }                                                                         \
+    } while (0)
+
+static inline int Test_iResult(const char *pcName)
+{
+    printf("%s: %u checks, %u failed\n", pcName, (unsigned)Test_u32Checks, (unsigned)Test_u32Fails);
+    return (Test_u32Fails == 0u) ? 0 : 1;
+}
+
+#endif
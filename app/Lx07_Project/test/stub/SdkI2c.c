@@ -0,0 +1,22 @@
+#include "SdkI2c.h"
+
+typedef union
+{
+    struct i2c_reg stReg;
+    uint32_t       au32Raw[sizeof(struct i2c_reg) / sizeof(uint32_t)];
+} SdkI2c_Block_T;
+
+static SdkI2c_Block_T astSdkI2cReg[I2C_INSTANCE_NUM];
+
+/* The driver takes its register pointers from these two */
+#undef I2C0_BASE_ADDR
+#undef I2C1_BASE_ADDR
+#define I2C0_BASE_ADDR ((uintptr_t)&astSdkI2cReg[0])
+#define I2C1_BASE_ADDR ((uintptr_t)&astSdkI2cReg[1])
+
+#include "Z20K11xM_i2c.c"
+
+i2c_reg_t *SdkI2c_pstReg(I2C_Id_t enId)
+{
+    return &astSdkI2cReg[enId].stReg;
+}
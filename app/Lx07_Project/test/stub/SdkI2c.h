@@ -0,0 +1,11 @@
+#ifndef _SDKI2C_H_
+#define _SDKI2C_H_
+
+/* The SDK I2C driver (StdDriver/Src/Z20K11xM_i2c.c) built on the host with its
+ * register blocks in plain memory, to read back what it programs */
+#include "Z20K11xM_drv.h"
+#include "Z20K11xM_i2c.h"
+
+extern i2c_reg_t *SdkI2c_pstReg(I2C_Id_t enId);
+
+#endif
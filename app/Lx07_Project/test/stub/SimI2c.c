@@ -0,0 +1,681 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SimI2c.h"
+#include "Z20K11xM_sysctrl.h"
+#include "I2cXfer.h"
+
+#define SIMI2C_DEV_MAX  (8u)
+#define SIMI2C_DMA_NUM  (4u)
+#define SIMI2C_NEVER    (UINT64_MAX)
+#define SIMI2C_LOOP_MAX (1000u) /* interrupt/DMA rounds without bus progress before calling it a livelock */
+
+/* I2C_COMMAND_DATA bits, same as I2CXFER_CMD_x */
+#define SIMI2C_CMD_RD      (0x0100u)
+#define SIMI2C_CMD_STOP    (0x0200u)
+#define SIMI2C_CMD_RESTART (0x0400u)
+
+#define SIMI2C_ASSERT(Cond)                                                           \
+    do                                                                                \
+    {                                                                                 \
+        if (!(Cond))                                                                  \
+        {                                                                             \
+            printf("%s:%d: model violated: %s\n", __FILE__, __LINE__, #Cond);        \
+            exit(1);                                                                  \
+        }                                                                             \
+    } while (0)
+
+typedef struct
+{
+    bool     boUsed;
+    I2C_Id_t enBus;
+    uint8_t  u8Addr;
+    uint8_t  u8RegLen;
+    uint8_t  au8Mem[256];
+    uint8_t  u8Ptr;
+    uint8_t  u8WrIdx; /* bytes written since the last START */
+} SimDev_T;
+
+typedef struct
+{
+    bool        boEn;
+    uint32_t    u32Tar;
+    I2C_Speed_t enSpeed;
+    uint32_t    u32IntEn;
+
+    uint16_t au16Tx[SIMI2C_FIFO_DEPTH];
+    uint8_t  u8TxHead;
+    uint8_t  u8TxCnt;
+    uint8_t  au8Rx[SIMI2C_FIFO_DEPTH];
+    uint8_t  u8RxHead;
+    uint8_t  u8RxCnt;
+
+    bool      boActive; /* START sent, no STOP yet: SCL held low while the TX FIFO is empty */
+    bool      boRead;   /* direction of the current segment */
+    SimDev_T *pstDev;
+    bool      boShift;  /* a command is on the wires until u64End */
+    bool      boAddr;   /* it starts with (RE)START and the address byte */
+    uint16_t  u16Cmd;
+    uint64_t  u64End;
+
+    bool     boStopDet;
+    bool     boAbrt;
+    uint32_t u32Err;
+    bool     boFlush; /* TX FIFO held flushed after an abort until the error is cleared */
+
+    bool     boDmaTx;
+    bool     boDmaRx;
+    uint32_t u32TxLvl;
+    uint32_t u32RxLvl;
+
+    bool     boStall;
+    uint64_t u64BusyNs;
+} SimBus_T;
+
+typedef struct
+{
+    DMA_TransferConfig_t stCfg;
+    bool                 boReq;
+    bool                 boDone; /* done interrupt pending */
+    uint16_t             u16Left;
+    uintptr_t            uMem; /* memory side of the transfer */
+    isr_cb_t            *pfDone;
+} SimDma_T;
+
+static SimDev_T SimI2c_astDev[SIMI2C_DEV_MAX];
+static SimBus_T SimI2c_astBus[2];
+static SimDma_T SimI2c_astDma[SIMI2C_DMA_NUM];
+static uint64_t SimI2c_u64NowNs;
+static uint32_t SimI2c_u32Recover;
+static uint32_t SimI2c_u32Locked;
+static bool     SimI2c_boInit;
+
+/* i2c.c owns this flag on the target, its STOP/RX callbacks are modelled below */
+bool boI2c0IsIdle = true;
+
+static SimBus_T *SimI2c_pstBus(I2C_Id_t enId)
+{
+    SIMI2C_ASSERT((I2C0_ID == enId) || (I2C1_ID == enId));
+
+    if (!SimI2c_boInit)
+    {
+        /* Left by I2c_Init: enabled at standard speed, RX_FULL/STOP_DET/ERROR_ABORT on */
+        SimI2c_astBus[0].boEn     = true;
+        SimI2c_astBus[0].u32IntEn = (1uL << I2C_INT_RX_FULL) | (1uL << I2C_INT_STOP_DET) | (1uL << I2C_INT_ERROR_ABORT);
+        SimI2c_astBus[1]          = SimI2c_astBus[0];
+        SimI2c_boInit             = true;
+    }
+
+    return &SimI2c_astBus[enId];
+}
+
+static SimDev_T *SimI2c_pstFind(I2C_Id_t enBus, uint32_t u32Addr)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < SIMI2C_DEV_MAX; u8Idx++)
+    {
+        if (SimI2c_astDev[u8Idx].boUsed && (SimI2c_astDev[u8Idx].enBus == enBus) && (SimI2c_astDev[u8Idx].u8Addr == u32Addr))
+        {
+            return &SimI2c_astDev[u8Idx];
+        }
+    }
+    return NULL;
+}
+
+void SimI2c_vAddDev(I2C_Id_t enBus, uint8_t u8Addr, uint8_t u8RegLen)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < SIMI2C_DEV_MAX; u8Idx++)
+    {
+        if (!SimI2c_astDev[u8Idx].boUsed)
+        {
+            SimI2c_astDev[u8Idx].boUsed   = true;
+            SimI2c_astDev[u8Idx].enBus    = enBus;
+            SimI2c_astDev[u8Idx].u8Addr   = u8Addr;
+            SimI2c_astDev[u8Idx].u8RegLen = u8RegLen;
+            return;
+        }
+    }
+    SIMI2C_ASSERT(false);
+}
+
+uint8_t *SimI2c_pu8Mem(uint8_t u8Addr)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < SIMI2C_DEV_MAX; u8Idx++)
+    {
+        if (SimI2c_astDev[u8Idx].boUsed && (SimI2c_astDev[u8Idx].u8Addr == u8Addr))
+        {
+            return SimI2c_astDev[u8Idx].au8Mem;
+        }
+    }
+    return NULL;
+}
+
+uint64_t SimI2c_u64Now(void)
+{
+    return SimI2c_u64NowNs;
+}
+
+uint64_t SimI2c_u64BusyNs(I2C_Id_t enBus)
+{
+    return SimI2c_pstBus(enBus)->u64BusyNs;
+}
+
+void SimI2c_vStall(I2C_Id_t enBus, bool boStall)
+{
+    SimI2c_pstBus(enBus)->boStall = boStall;
+}
+
+uint32_t SimI2c_u32RecoverLocked(void)
+{
+    return SimI2c_u32Locked;
+}
+
+uint32_t SimI2c_u32RecoverCnt(void)
+{
+    return SimI2c_u32Recover;
+}
+
+/*****************************************************************************
+ * Bus
+ *****************************************************************************/
+static void SimI2c_vFlush(SimBus_T *pstBus)
+{
+    pstBus->u8TxCnt = 0u;
+    pstBus->u8RxCnt = 0u;
+}
+
+static void SimI2c_vPush(SimBus_T *pstBus, uint16_t u16Cmd)
+{
+    if (pstBus->boFlush)
+    {
+        return; /* dropped until the abort source is cleared */
+    }
+
+    SIMI2C_ASSERT(pstBus->u8TxCnt < SIMI2C_FIFO_DEPTH); /* TX_OVER */
+    pstBus->au16Tx[(pstBus->u8TxHead + pstBus->u8TxCnt) % SIMI2C_FIFO_DEPTH] = u16Cmd;
+    pstBus->u8TxCnt++;
+}
+
+static uint8_t SimI2c_u8Pop(SimBus_T *pstBus)
+{
+    uint8_t u8Data;
+
+    SIMI2C_ASSERT(pstBus->u8RxCnt > 0u); /* RX_UNDER */
+    u8Data           = pstBus->au8Rx[pstBus->u8RxHead];
+    pstBus->u8RxHead = (uint8_t)((pstBus->u8RxHead + 1u) % SIMI2C_FIFO_DEPTH);
+    pstBus->u8RxCnt--;
+
+    return u8Data;
+}
+
+/* Take the next command off the TX FIFO and put it on the wires */
+static bool SimI2c_boShift(SimBus_T *pstBus)
+{
+    uint16_t u16Cmd;
+    bool     boRd;
+    uint32_t u32Bits = 9u;
+
+    if (!pstBus->boEn || pstBus->boShift || (0u == pstBus->u8TxCnt))
+    {
+        return false;
+    }
+
+    u16Cmd = pstBus->au16Tx[pstBus->u8TxHead];
+    boRd   = (0u != (u16Cmd & SIMI2C_CMD_RD));
+
+    if (boRd && (pstBus->u8RxCnt >= SIMI2C_FIFO_DEPTH))
+    {
+        return false; /* RX FIFO full: the master holds SCL */
+    }
+
+    pstBus->u8TxHead = (uint8_t)((pstBus->u8TxHead + 1u) % SIMI2C_FIFO_DEPTH);
+    pstBus->u8TxCnt--;
+
+    pstBus->boAddr = !pstBus->boActive || (boRd != pstBus->boRead) || (0u != (u16Cmd & SIMI2C_CMD_RESTART));
+    if (pstBus->boAddr)
+    {
+        u32Bits += 10u; /* (RE)START and the address byte */
+    }
+    if (0u != (u16Cmd & SIMI2C_CMD_STOP))
+    {
+        u32Bits += 1u;
+    }
+
+    pstBus->u16Cmd  = u16Cmd;
+    pstBus->boShift = true;
+
+    if (pstBus->boStall)
+    {
+        pstBus->u64End = SIMI2C_NEVER;
+    }
+    else
+    {
+        pstBus->u64End = SimI2c_u64NowNs + ((uint64_t)u32Bits * I2cXfer_u32BitNs(pstBus->enSpeed));
+        pstBus->u64BusyNs += pstBus->u64End - SimI2c_u64NowNs;
+    }
+
+    return true;
+}
+
+/* The command on the wires has ended at u64End */
+static void SimI2c_vShiftEnd(SimBus_T *pstBus, I2C_Id_t enBus)
+{
+    uint16_t  u16Cmd = pstBus->u16Cmd;
+    bool      boRd   = (0u != (u16Cmd & SIMI2C_CMD_RD));
+    SimDev_T *pstDev;
+
+    pstBus->boShift = false;
+
+    if (pstBus->boAddr)
+    {
+        pstDev = SimI2c_pstFind(enBus, pstBus->u32Tar);
+
+        if (NULL == pstDev)
+        {
+            /* Address NACK: flush, STOP, ERROR_ABORT then STOP_DET */
+            pstBus->u32Err |= (1uL << ERR_7BIT_ADDR_NO_ACK);
+            pstBus->u8TxCnt  = 0u;
+            pstBus->boFlush  = true;
+            pstBus->boActive = false;
+            pstBus->boAbrt   = true;
+            pstBus->boStopDet = true;
+            return;
+        }
+
+        pstBus->pstDev   = pstDev;
+        pstBus->boActive = true;
+        pstBus->boRead   = boRd;
+        if (!boRd)
+        {
+            pstDev->u8WrIdx = 0u;
+        }
+    }
+
+    pstDev = pstBus->pstDev;
+
+    if (boRd)
+    {
+        pstBus->au8Rx[(pstBus->u8RxHead + pstBus->u8RxCnt) % SIMI2C_FIFO_DEPTH] = pstDev->au8Mem[pstDev->u8Ptr];
+        pstBus->u8RxCnt++;
+        pstDev->u8Ptr++;
+    }
+    else if (pstDev->u8WrIdx < pstDev->u8RegLen)
+    {
+        pstDev->u8Ptr = (uint8_t)u16Cmd; /* register address, the low byte selects the memory */
+        pstDev->u8WrIdx++;
+    }
+    else
+    {
+        pstDev->au8Mem[pstDev->u8Ptr] = (uint8_t)u16Cmd;
+        pstDev->u8Ptr++;
+    }
+
+    if (0u != (u16Cmd & SIMI2C_CMD_STOP))
+    {
+        pstBus->boActive  = false;
+        pstBus->boStopDet = true;
+    }
+}
+
+/*****************************************************************************
+ * DMA and interrupts
+ *****************************************************************************/
+static bool SimI2c_boDma(SimDma_T *pstDma)
+{
+    uint32_t  u32Req = (uint32_t)pstDma->stCfg.source - (uint32_t)DMA_REQ_I2C0_TX;
+    SimBus_T *pstBus;
+    bool      boRx;
+    bool      boMoved = false;
+
+    if (!pstDma->boReq || (0u == pstDma->u16Left))
+    {
+        return false;
+    }
+
+    SIMI2C_ASSERT(u32Req < 4u);
+    pstBus = SimI2c_pstBus((I2C_Id_t)(u32Req / 2u));
+    boRx   = (0u != (u32Req % 2u));
+
+    while (0u != pstDma->u16Left)
+    {
+        if (!boRx && pstBus->boDmaTx && (pstBus->u8TxCnt <= pstBus->u32TxLvl))
+        {
+            SimI2c_vPush(pstBus, *(const uint16_t *)pstDma->uMem);
+        }
+        else if (boRx && pstBus->boDmaRx && (pstBus->u8RxCnt > pstBus->u32RxLvl))
+        {
+            *(uint8_t *)pstDma->uMem = SimI2c_u8Pop(pstBus);
+        }
+        else
+        {
+            break;
+        }
+
+        pstDma->uMem = (uintptr_t)((intptr_t)pstDma->uMem + (boRx ? pstDma->stCfg.minorLoopDestOffset : pstDma->stCfg.minorLoopSrcOffset));
+        pstDma->u16Left--;
+        boMoved = true;
+    }
+
+    if (boMoved && (0u == pstDma->u16Left))
+    {
+        pstDma->boReq  = (ENABLE != pstDma->stCfg.disableRequestAfterDoneCmd);
+        pstDma->boDone = (UNMASK == pstDma->stCfg.doneIntMask);
+    }
+
+    return boMoved;
+}
+
+static bool SimI2c_boIntOn(const SimBus_T *pstBus, I2C_INT_t enInt)
+{
+    return (0u != (pstBus->u32IntEn & (1uL << enInt)));
+}
+
+/* One interrupt in priority order, as the NVIC would take it */
+static bool SimI2c_boIrq(void)
+{
+    uint8_t   u8Idx;
+    SimBus_T *pstBus;
+    I2C_Id_t  enBus;
+
+    SIMI2C_ASSERT(0u == Sim_u32PriMask); /* the model only runs from the main loop */
+
+    for (u8Idx = 0u; u8Idx < SIMI2C_DMA_NUM; u8Idx++)
+    {
+        if (SimI2c_astDma[u8Idx].boDone && (NULL != SimI2c_astDma[u8Idx].pfDone))
+        {
+            SimI2c_astDma[u8Idx].boDone = false;
+            SimI2c_astDma[u8Idx].pfDone();
+            return true;
+        }
+    }
+
+    for (enBus = I2C0_ID; enBus <= I2C1_ID; enBus++)
+    {
+        pstBus = SimI2c_pstBus(enBus);
+
+        if (pstBus->boAbrt && SimI2c_boIntOn(pstBus, I2C_INT_ERROR_ABORT))
+        {
+            pstBus->boAbrt = false;
+            I2cXfer_vAbortIsr(enBus);
+            return true;
+        }
+        else if (pstBus->boStopDet && SimI2c_boIntOn(pstBus, I2C_INT_STOP_DET))
+        {
+            pstBus->boStopDet = false;
+            if (I2C0_ID == enBus)
+            {
+                boI2c0IsIdle = true;
+            }
+            I2cXfer_vStopIsr(enBus);
+            return true;
+        }
+        else if ((pstBus->u8RxCnt > 0u) && SimI2c_boIntOn(pstBus, I2C_INT_RX_FULL))
+        {
+            if (I2C0_ID == enBus)
+            {
+                boI2c0IsIdle = false;
+            }
+            I2cXfer_vRxFullIsr(enBus);
+            return true;
+        }
+        else if ((0u == pstBus->u8TxCnt) && SimI2c_boIntOn(pstBus, I2C_INT_TX_EMPTY))
+        {
+            I2cXfer_vTxEmptyIsr(enBus);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void SimI2c_vService(void)
+{
+    uint32_t u32Loop;
+    uint8_t  u8Idx;
+    bool     boBusy;
+
+    for (u32Loop = 0u; u32Loop < SIMI2C_LOOP_MAX; u32Loop++)
+    {
+        boBusy = false;
+
+        for (u8Idx = 0u; u8Idx < SIMI2C_DMA_NUM; u8Idx++)
+        {
+            boBusy = SimI2c_boDma(&SimI2c_astDma[u8Idx]) || boBusy;
+        }
+        boBusy = SimI2c_boShift(SimI2c_pstBus(I2C0_ID)) || boBusy;
+        boBusy = SimI2c_boShift(SimI2c_pstBus(I2C1_ID)) || boBusy;
+        boBusy = SimI2c_boIrq() || boBusy;
+
+        if (!boBusy)
+        {
+            return;
+        }
+    }
+    SIMI2C_ASSERT(false);
+}
+
+void SimI2c_vRun(uint64_t u64Ns)
+{
+    SimBus_T *pstNext;
+    I2C_Id_t  enNext;
+    I2C_Id_t  enBus;
+
+    for (;;)
+    {
+        SimI2c_vService();
+
+        pstNext = NULL;
+        enNext  = I2C0_ID;
+        for (enBus = I2C0_ID; enBus <= I2C1_ID; enBus++)
+        {
+            SimBus_T *pstBus = SimI2c_pstBus(enBus);
+
+            if (pstBus->boShift && (pstBus->u64End <= u64Ns) && ((NULL == pstNext) || (pstBus->u64End < pstNext->u64End)))
+            {
+                pstNext = pstBus;
+                enNext  = enBus;
+            }
+        }
+
+        if (NULL == pstNext)
+        {
+            break;
+        }
+
+        SimI2c_u64NowNs = pstNext->u64End;
+        SimI2c_vShiftEnd(pstNext, enNext);
+    }
+
+    if (u64Ns > SimI2c_u64NowNs)
+    {
+        SimI2c_u64NowNs = u64Ns;
+    }
+}
+
+/*****************************************************************************
+ * SDK I2C driver
+ *****************************************************************************/
+void I2C_IntCmd(I2C_Id_t i2cId, I2C_INT_t intType, ControlState_t newState)
+{
+    SimBus_T *pstBus = SimI2c_pstBus(i2cId);
+    uint32_t  u32Mask = (I2C_INT_ALL == intType) ? 0xFFFFFFFFuL : (1uL << intType);
+
+    pstBus->u32IntEn = (ENABLE == newState) ? (pstBus->u32IntEn | u32Mask) : (pstBus->u32IntEn & ~u32Mask);
+}
+
+FlagStatus_t I2C_GetStatus(I2C_Id_t i2cId, I2C_Status_t statusType)
+{
+    const SimBus_T *pstBus = SimI2c_pstBus(i2cId);
+    bool            boSet  = false;
+
+    switch (statusType)
+    {
+        case I2C_MST_ACTIVITY: boSet = pstBus->boActive || pstBus->boShift; break;
+        case I2C_STATUS_TFNF:  boSet = (pstBus->u8TxCnt < SIMI2C_FIFO_DEPTH); break;
+        case I2C_STATUS_TFE:   boSet = (0u == pstBus->u8TxCnt); break;
+        case I2C_STATUS_RFNE:  boSet = (pstBus->u8RxCnt > 0u); break;
+        case I2C_STATUS_RFF:   boSet = (pstBus->u8RxCnt >= SIMI2C_FIFO_DEPTH); break;
+        default:               SIMI2C_ASSERT(false); break;
+    }
+
+    return boSet ? SET : RESET;
+}
+
+FlagStatus_t I2C_GetErrorStatus(I2C_Id_t i2cId, I2C_ErrorStatus_t errorType)
+{
+    return (0u != (SimI2c_pstBus(i2cId)->u32Err & (1uL << errorType))) ? SET : RESET;
+}
+
+void I2C_ClearErrorStatusAll(I2C_Id_t i2cId)
+{
+    SimBus_T *pstBus = SimI2c_pstBus(i2cId);
+
+    pstBus->u32Err  = 0u;
+    pstBus->boFlush = false;
+}
+
+static uint16_t SimI2c_u16Flag(I2C_RestartStop_t enRestartStop)
+{
+    if (I2C_STOP_EN == enRestartStop)
+    {
+        return SIMI2C_CMD_STOP;
+    }
+    else if (I2C_RESTART_EN == enRestartStop)
+    {
+        return SIMI2C_CMD_RESTART;
+    }
+    return 0u;
+}
+
+void I2C_MasterSendByte(I2C_Id_t i2cId, I2C_RestartStop_t restartStopType, uint8_t data)
+{
+    SimI2c_vPush(SimI2c_pstBus(i2cId), (uint16_t)(data | SimI2c_u16Flag(restartStopType)));
+}
+
+void I2C_MasterReadCmd(I2C_Id_t i2cId, I2C_RestartStop_t restartStopType)
+{
+    SimI2c_vPush(SimI2c_pstBus(i2cId), (uint16_t)(SIMI2C_CMD_RD | SimI2c_u16Flag(restartStopType)));
+}
+
+uint8_t I2C_ReceiveByte(I2C_Id_t i2cId)
+{
+    return SimI2c_u8Pop(SimI2c_pstBus(i2cId));
+}
+
+void I2C_Disable(I2C_Id_t i2cId)
+{
+    SimBus_T *pstBus = SimI2c_pstBus(i2cId);
+
+    SIMI2C_ASSERT(!pstBus->boActive && !pstBus->boShift); /* only retargeted between transfers */
+    pstBus->boEn = false;
+    SimI2c_vFlush(pstBus);
+}
+
+void I2C_Enable(I2C_Id_t i2cId)
+{
+    SimI2c_pstBus(i2cId)->boEn = true;
+}
+
+void I2C_SetTargetAddr(I2C_Id_t i2cId, uint32_t targetAddr)
+{
+    SIMI2C_ASSERT(!SimI2c_pstBus(i2cId)->boEn);
+    SimI2c_pstBus(i2cId)->u32Tar = targetAddr;
+}
+
+void I2C_DmaConfig(I2C_Id_t i2cId, const I2C_DmaConfig_t *i2cDmaConfig)
+{
+    SimI2c_pstBus(i2cId)->u32TxLvl = i2cDmaConfig->I2C_DMA_TransmitReqLevel;
+    SimI2c_pstBus(i2cId)->u32RxLvl = i2cDmaConfig->I2C_DMA_RecvReqLevel;
+}
+
+void I2C_DmaCmd(I2C_Id_t i2cId, ControlState_t transmitDmaCtrl, ControlState_t rcvDmaCtrl)
+{
+    SimI2c_pstBus(i2cId)->boDmaTx = (ENABLE == transmitDmaCtrl);
+    SimI2c_pstBus(i2cId)->boDmaRx = (ENABLE == rcvDmaCtrl);
+}
+
+/* i2c.c: the bus runs at I2cXfer_u32BitNs of the selected speed, which test_i2c_timing
+ * checks against the counts */
+void I2c_vSetScl(I2C_Id_t i2cNo, I2C_Speed_t speedMode, uint16_t u16HCnt, uint16_t u16LCnt)
+{
+    (void)u16HCnt;
+    (void)u16LCnt;
+    SIMI2C_ASSERT(!SimI2c_pstBus(i2cNo)->boEn);
+    SimI2c_pstBus(i2cNo)->enSpeed = speedMode;
+}
+
+/* i2c.c: SCL toggled by GPIO until the device lets SDA go, then STOP; a device that
+ * keeps holding SDA blocks the next transfer again */
+bool I2c_boBusRecover(I2C_Id_t i2cNo)
+{
+    SimBus_T *pstBus = SimI2c_pstBus(i2cNo);
+
+    SimI2c_u32Recover++;
+    if (0u != Sim_u32PriMask)
+    {
+        SimI2c_u32Locked++;
+    }
+
+    pstBus->boShift  = false;
+    pstBus->boActive = false;
+    SimI2c_vFlush(pstBus);
+
+    return !pstBus->boStall;
+}
+
+/*****************************************************************************
+ * SDK DMA driver
+ *****************************************************************************/
+void DMA_Init(const DMA_Config_t *ptDMAInitConfig)
+{
+    (void)ptDMAInitConfig;
+}
+
+void DMA_InstallCallBackFunc(DMA_Channel_t channel, DMA_INT_t intType, isr_cb_t *cbFun)
+{
+    SIMI2C_ASSERT((channel < SIMI2C_DMA_NUM) && (DMA_INT_DONE == intType));
+    SimI2c_astDma[channel].pfDone = cbFun;
+}
+
+ResultStatus_t DMA_ConfigTransfer(const DMA_TransferConfig_t *config)
+{
+    SimDma_T *pstDma;
+    uint32_t  u32Req = (uint32_t)config->source - (uint32_t)DMA_REQ_I2C0_TX;
+
+    SIMI2C_ASSERT((config->channel < SIMI2C_DMA_NUM) && (u32Req < 4u));
+    pstDma = &SimI2c_astDma[config->channel];
+    SIMI2C_ASSERT(!pstDma->boReq);
+
+    pstDma->stCfg   = *config;
+    pstDma->u16Left = config->minorLoopNum;
+    pstDma->boDone  = false;
+    /* I2cXfer hands over 32-bit addresses, the test links with -no-pie so they are the real ones */
+    pstDma->uMem = (uintptr_t)((0u != (u32Req % 2u)) ? config->destAddr : config->srcAddr);
+
+    return SUCC;
+}
+
+void DMA_ChannelRequestEnable(DMA_Channel_t channel)
+{
+    SimI2c_astDma[channel].boReq = true;
+}
+
+void DMA_ChannelRequestDisable(DMA_Channel_t channel)
+{
+    SimI2c_astDma[channel].boReq = false;
+}
+
+void DMA_ClearDoneStatus(DMA_Channel_t channel)
+{
+    SimI2c_astDma[channel].boDone = false;
+}
+
+void SYSCTRL_EnableModule(SYSCTRL_Module_t mod)
+{
+    (void)mod;
+}
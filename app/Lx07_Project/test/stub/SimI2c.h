@@ -0,0 +1,31 @@
+#ifndef _SIMI2C_H_
+#define _SIMI2C_H_
+
+/* Host model of the two I2C masters, their DMA channels and the devices on the
+ * wires. It implements the SDK I2C_x/DMA_x calls I2cXfer.c makes and the i2c.c
+ * interrupt callbacks, so I2cXfer runs unchanged against virtual time:
+ * every bus byte takes 9 SCL of the programmed speed, START/RESTART/STOP one each */
+#include <stdbool.h>
+#include "Z20K11xM_drv.h"
+#include "Z20K11xM_i2c.h"
+#include "Z20K11xM_dma.h"
+
+#define SIMI2C_FIFO_DEPTH (4u)
+
+/* Put a device with u8RegLen register address bytes on a bus, 256 bytes of memory */
+extern void     SimI2c_vAddDev(I2C_Id_t enBus, uint8_t u8Addr, uint8_t u8RegLen);
+extern uint8_t *SimI2c_pu8Mem(uint8_t u8Addr);
+
+/* Run both buses and raise their interrupts until u64Ns of virtual time */
+extern void     SimI2c_vRun(uint64_t u64Ns);
+extern uint64_t SimI2c_u64Now(void);
+/* SCL time the bus really spent on transfers */
+extern uint64_t SimI2c_u64BusyNs(I2C_Id_t enBus);
+
+/* A device holds SDA low: the current byte never ends until the bus is recovered */
+extern void     SimI2c_vStall(I2C_Id_t enBus, bool boStall);
+/* I2c_boBusRecover calls made with interrupts disabled */
+extern uint32_t SimI2c_u32RecoverLocked(void);
+extern uint32_t SimI2c_u32RecoverCnt(void);
+
+#endif
@@ -0,0 +1,3 @@
+#include "SimIrq.h"
+
+uint32_t Sim_u32PriMask = 0u;
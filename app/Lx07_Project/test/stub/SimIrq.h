@@ -0,0 +1,18 @@
+#ifndef _SIMIRQ_H_
+#define _SIMIRQ_H_
+
+/* Host stand-in for the PRIMASK lock of IrqLock.h, force-included by the Makefile
+ * so it is defined before IrqLock.h is read */
+#include "stdint.h"
+
+extern uint32_t Sim_u32PriMask; /* 1: interrupts disabled */
+
+#define IRQLOCK_SAVE(Mask)               \
+    do                                   \
+    {                                    \
+        (Mask)         = Sim_u32PriMask; \
+        Sim_u32PriMask = 1u;             \
+    } while (0)
+#define IRQLOCK_RESTORE(Mask) (Sim_u32PriMask = (Mask))
+
+#endif
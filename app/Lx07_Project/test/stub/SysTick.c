@@ -0,0 +1,53 @@
+#include "SysTick.h"
+
+#define SIM_SYSTICK_MASK 0x00FFFFFFu
+
+static uint32_t u32SimVal  = SIM_SYSTICK_MASK;
+static uint8_t  u8SimOverF = 0u;
+static uint64_t u64SimNow  = 0u;
+
+void SysTickInit(void)
+{
+    /* VAL is cleared and reloads LOAD on the next clock */
+    u32SimVal  = SIM_SYSTICK_MASK;
+    u8SimOverF = 0u;
+    u64SimNow  = 0u;
+}
+
+void SysTick_GetCurCount(uint32_t *u32Value)
+{
+    *u32Value = u32SimVal;
+}
+
+void SysTick_SetCount(uint32_t u32Value)
+{
+    /* Writing VAL clears the counter on the target */
+    (void)u32Value;
+    u32SimVal = 0u;
+}
+
+void SysTick_GetOverF(uint8_t *u8Value)
+{
+    *u8Value   = u8SimOverF;
+    u8SimOverF = 0u;
+}
+
+void Sim_vAdvance(uint32_t u32Ticks)
+{
+    /* Counts down and reloads 0x00FFFFFF after 0 */
+    if (u32Ticks > u32SimVal)
+    {
+        u8SimOverF = 1u;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+    u32SimVal = (u32SimVal - u32Ticks) & SIM_SYSTICK_MASK;
+    u64SimNow += u32Ticks;
+}
+
+uint64_t Sim_u64Now(void)
+{
+    return u64SimNow;
+}
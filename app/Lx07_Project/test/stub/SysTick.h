@@ -0,0 +1,18 @@
+#ifndef _SYSTICK_H_
+#define _SYSTICK_H_
+
+/* Host stand-in for SysTick/inc/SysTick.h: a simulated 24-bit down-counter,
+ * so the scheduler can run against virtual time */
+#include "stdint.h"
+
+extern void SysTick_GetCurCount(uint32_t *u32Value);
+extern void SysTick_SetCount(uint32_t u32Value);
+extern void SysTick_GetOverF(uint8_t *u8Value);
+extern void SysTickInit(void);
+
+/* Let u32Ticks of virtual time pass */
+extern void     Sim_vAdvance(uint32_t u32Ticks);
+/* Virtual ticks since SysTickInit, never wraps */
+extern uint64_t Sim_u64Now(void);
+
+#endif
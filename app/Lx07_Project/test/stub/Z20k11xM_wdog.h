@@ -0,0 +1 @@
+#include "Z20K11xM_wdog.h" /* src/wdog.h spells the SDK header with a lower case k */
@@ -0,0 +1,16 @@
+#ifndef _CMSIS_NVIC_VIRTUAL_H_
+#define _CMSIS_NVIC_VIRTUAL_H_
+
+/* Picked up by core_cm0plus.h when built with -DCMSIS_NVIC_VIRTUAL: there is no NVIC
+ * on the host, the simulated controllers call the module ISRs directly */
+#define NVIC_EnableIRQ(IRQn)            ((void)(IRQn))
+#define NVIC_GetEnableIRQ(IRQn)         ((void)(IRQn), 1u)
+#define NVIC_DisableIRQ(IRQn)           ((void)(IRQn))
+#define NVIC_GetPendingIRQ(IRQn)        ((void)(IRQn), 0u)
+#define NVIC_SetPendingIRQ(IRQn)        ((void)(IRQn))
+#define NVIC_ClearPendingIRQ(IRQn)      ((void)(IRQn))
+#define NVIC_SetPriority(IRQn, Prio)    ((void)(IRQn), (void)(Prio))
+#define NVIC_GetPriority(IRQn)          ((void)(IRQn), 0u)
+#define NVIC_SystemReset()              ((void)0)
+
+#endif
@@ -0,0 +1,357 @@
+/* Adc.c thermistor conversion against the float conversion it replaced, over every
+ * ADC code of both sensors, plus a host timing of the two. Adc.c is included so its
+ * static conversion functions can be timed on their own. Built once for the external
+ * I2C ADC and once with ADC_ONCHIP, where the codes come from AdcScan as millivolts */
+#include <time.h>
+#include "../Sch/src/Adc.c"
+#include "TestUtil.h"
+
+#ifdef ADC_ONCHIP
+#define CODE_NUM (ADC_CODE_FULL + 1u) /* the millivolt reading is clamped to full scale */
+#else
+#define CODE_NUM (4096u)
+#endif
+#define TIME_ROUNDS  (200u)
+#define ERR_MAX_LCD  (0.35) /* C, temperature table interpolation on the steep ends */
+#define ERR_MAX_PCB  (0.20)
+#define ERR_MAX_CODE (0.06) /* C, direct conversion: 0.05 rounding plus float error of the reference */
+
+/*****************************************************************************
+ * Reference: the float conversion of Adc_vReadLcdTemp/Adc_vReadPcbTemp before
+ * the integer rewrite, table in kOhm exactly as it was
+ *****************************************************************************/
+typedef enum
+{
+    ADC_PCB_TEMP,
+    ADC_LCD_TEMP,
+} Adc_enTempTyp;
+
+typedef struct
+{
+    int   temp;
+    float res;
+} Ref_stResTempRef;
+
+static const Ref_stResTempRef Ref_astLcd[] = {
+    {-55, 470.1223}, {-50, 348.6184}, {-45, 260.2623}, {-40, 195.6520}, {-35, 148.1710}, {-30, 113.3471},
+    {-25, 87.5588},  {-20, 68.2367},  {-15, 53.6496},  {-10, 42.5062},  {-5, 33.8922},   {0, 27.2186},
+    {5, 22.0211},    {10, 17.9255},   {15, 14.6735},   {20, 12.0805},   {25, 10.0000},   {30, 8.3145},
+    {35, 6.9479},    {40, 5.8336},    {45, 4.9169},    {50, 4.1609},    {55, 3.5350},    {60, 3.0143},
+    {65, 2.5861},    {70, 2.2275},    {75, 1.9245},    {80, 1.6685},    {85, 1.4521},    {90, 1.2680},
+    {95, 1.0965},    {100, 0.9738},   {105, 0.8798},   {110, 0.8049},   {115, 0.7305},   {120, 0.6591},
+    {125, 0.5821},   {130, 0.4742},   {135, 0.4335},   {140, 0.3897},   {145, 0.3647},   {150, 0.3095},
+};
+
+static void Ref_vFindResSegment(float res, int *left, int *right, const Ref_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp)
+{
+    uint8_t u8ArrSize = (ADC_PCB_TEMP == enTempTyp) ? 34 : 42;
+    int     low       = 0;
+    int     high      = u8ArrSize - 1;
+    int     mid;
+
+    if (res > astResTempRef[0].res)
+    {
+        res = astResTempRef[0].res;
+    }
+    else if (res < astResTempRef[u8ArrSize - 1].res)
+    {
+        res = astResTempRef[u8ArrSize - 1].res;
+    }
+
+    while (low + 1 < high)
+    {
+        mid = (low + high) / 2;
+        if (res > astResTempRef[mid].res)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid;
+        }
+    }
+
+    *left  = low;
+    *right = high;
+}
+
+static float Ref_flCalcTemperature(float res, const Ref_stResTempRef astResTempRef[], Adc_enTempTyp enTempTyp)
+{
+    int left_idx, right_idx;
+
+    Ref_vFindResSegment(res, &left_idx, &right_idx, astResTempRef, enTempTyp);
+
+    const Ref_stResTempRef *left  = &astResTempRef[left_idx];
+    const Ref_stResTempRef *right = &astResTempRef[right_idx];
+
+    return left->temp + (res - left->res) * (right->temp - left->temp) / (right->res - left->res);
+}
+
+static float Ref_flTemp(uint16_t u16ReadAd, Adc_enTempTyp enTyp)
+{
+    double dbAdVol = (u16ReadAd * 4.096) / 0x7FF;
+    double dbRes;
+    float  flTemp = 0.0;
+
+    if (dbAdVol >= 3.3)
+    {
+        // 理论上采集的电压不可能大于3.3v
+    }
+    else
+    {
+        dbRes  = ((ADC_LCD_TEMP == enTyp) ? 10 : 1) * dbAdVol / (3.3 - dbAdVol);
+        flTemp = Ref_flCalcTemperature((float)dbRes, Ref_astLcd, enTyp);
+    }
+
+    return flTemp;
+}
+
+/* Whole degrees as Adc_vReadLcdTemp sends them on CAN and UART, before and after */
+static int Ref_iDegree(float flTemp)
+{
+    return (flTemp >= 0) ? (int)(uint8_t)(flTemp + 0.5) : -(int)(uint8_t)((flTemp - 0.5) * (-1));
+}
+
+static int Test_iDegree(int16_t s16Temp)
+{
+    return (s16Temp >= 0) ? (int)(uint8_t)((s16Temp + 5) / 10) : -(int)(uint8_t)((5 - s16Temp) / 10);
+}
+
+/*****************************************************************************
+ * Modules Adc.c calls: one conversion of u16SimCode per Adc_boConvert sequence
+ *****************************************************************************/
+ProductLine_stI2cRW ProductLine_stI2cRWMsgs;
+CAN_MsgBuf_t        stCanRxBuf;
+
+static uint16_t u16SimCode;
+static uint8_t  u8SimCfg;
+static bool     boSimFail;
+static bool     boSample;
+static int16_t  s16Sample;
+static bool     boSampleValid;
+
+bool ProductLine_boI2cWrite(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len)
+{
+    (void)u8Dev;
+    (void)u8Len;
+    u8SimCfg = pu8Data[1];
+    return true;
+}
+
+bool ProductLine_boI2cRead(ProductLine_enI2cReadTyp enTyp, uint8_t u8Dev, uint8_t u8Reg)
+{
+    uint8_t *pu8Data = ProductLine_stI2cRWMsgs.Read_t.au8Data[enTyp];
+
+    (void)u8Dev;
+    if (ADC_REG_CFG == u8Reg)
+    {
+        pu8Data[0] = u8SimCfg | ADC_CFG_OS; // 转换已结束
+    }
+    else
+    {
+        pu8Data[0] = (uint8_t)(u16SimCode >> 4u);
+        pu8Data[1] = (uint8_t)(u16SimCode << 4u);
+    }
+    ProductLine_stI2cRWMsgs.Read_t.au8Count[enTyp]  = boSimFail ? 0u : ADC_READ_LEN; // 失败的读取没有数据
+    ProductLine_stI2cRWMsgs.Read_t.aboEndFlg[enTyp] = false;
+
+    return true;
+}
+
+bool ProductLine_boPost(ProductLine_enWorkSts enJob, ProductLine_pfJobDone pfDone)
+{
+    (void)enJob;
+    (void)pfDone;
+    return true;
+}
+
+void ProductLine_vJobDone(ProductLine_enWorkSts enJob)
+{
+    (void)enJob;
+}
+
+void Thermal_vPutSample(Thermal_enSensor enSensor, int16_t s16Temp, bool boValid)
+{
+    (void)enSensor;
+    boSample      = true;
+    s16Sample     = s16Temp;
+    boSampleValid = boValid;
+}
+
+void Uart_Transmit(uint8_t *logBuf, uint32_t logLen)
+{
+    (void)logBuf;
+    (void)logLen;
+}
+
+void CAN_Send_Msg(uint32_t msgId, const uint8_t *msgData)
+{
+    (void)msgId;
+    (void)msgData;
+}
+
+bool Board_boReady(void)
+{
+    return true;
+}
+
+void Board_vIdentify(uint16_t u16StrapMv)
+{
+    (void)u16StrapMv;
+}
+
+const Board_stDesc *Board_pstGet(void)
+{
+    return NULL;
+}
+
+#ifdef ADC_ONCHIP
+void AdcScan_vInit(void)
+{}
+
+bool AdcScan_boGetMv(AdcScan_enCh enCh, uint16_t *pu16Mv)
+{
+    (void)enCh;
+    *pu16Mv = (uint16_t)(((uint32_t)u16SimCode * ADC_VREF_MV + ADC_CODE_FULL / 2u) / ADC_CODE_FULL);
+    return !boSimFail; // 失败时相当于环形缓存中一直没有采样
+}
+#endif
+
+/*****************************************************************************
+ * Tests
+ *****************************************************************************/
+static double Test_dbAbs(double dbVal)
+{
+    return (dbVal < 0.0) ? -dbVal : dbVal;
+}
+
+/* Every code: the temperature Adc_vReadxxxTemp hands to Thermal, against the float path */
+static void Test_vSweep(const Adc_stNtc *pstNtc, Adc_enTempTyp enTyp, void (*pfRead)(void), double dbErrMax)
+{
+    uint32_t u32Code;
+    uint8_t  u8Call;
+    float    flRef;
+    double   dbErr;
+    double   dbMax     = 0.0;
+    double   dbMaxCode = 0.0;
+    uint32_t u32AtCode = 0u;
+    uint32_t u32Deg    = 0u;
+    uint32_t u32Num    = 0u;
+    int16_t  s16Code;
+
+    for (u32Code = 0u; u32Code < CODE_NUM; u32Code++)
+    {
+        u16SimCode = (uint16_t)u32Code;
+        boSample   = false;
+        for (u8Call = 0u; (u8Call < 4u) && !boSample; u8Call++)
+        {
+            pfRead();
+        }
+        TEST_CHECK(boSample);
+        TEST_CHECK(s16Sample == Adc_s16NtcTemp(pstNtc, (uint16_t)u32Code));
+        TEST_CHECK(boSampleValid == ((u32Code > 0u) && (u32Code <= ADC_CODE_VDIV)));
+
+        flRef   = Ref_flTemp((uint16_t)u32Code, enTyp);
+        s16Code = Adc_s16CodeToTemp(pstNtc, (uint16_t)u32Code);
+
+        if (flRef < (ADC_TEMP_MIN / 10.0))
+        {
+            TEST_CHECK(s16Sample == ADC_TEMP_MIN); // 开路，原浮点结果超出uint8_t换算范围
+        }
+        else if (flRef > (ADC_TEMP_MAX / 10.0))
+        {
+            TEST_CHECK(s16Sample == ADC_TEMP_MAX);
+        }
+        else
+        {
+            u32Num++;
+            dbErr = Test_dbAbs((s16Sample / 10.0) - flRef);
+            if (dbErr > dbMax)
+            {
+                dbMax     = dbErr;
+                u32AtCode = u32Code;
+            }
+            dbErr     = Test_dbAbs((s16Code / 10.0) - flRef);
+            dbMaxCode = (dbErr > dbMaxCode) ? dbErr : dbMaxCode;
+
+            if (Ref_iDegree(flRef) != Test_iDegree(s16Sample))
+            {
+                u32Deg++;
+                TEST_CHECK_RANGE(Ref_iDegree(flRef) - Test_iDegree(s16Sample), -1, 1);
+            }
+        }
+    }
+
+    printf("%s: %u codes, max error %.3f C at code %u (direct conversion %.3f C), whole degree differs on %u codes\n",
+           (ADC_LCD_TEMP == enTyp) ? "LCD" : "PCB", (unsigned)u32Num, dbMax, (unsigned)u32AtCode, dbMaxCode, (unsigned)u32Deg);
+    TEST_CHECK(dbMax <= dbErrMax);
+    TEST_CHECK(dbMaxCode <= ERR_MAX_CODE);
+}
+
+/* A read that did not complete ends the conversion with an invalid sample */
+static void Test_vFail(void (*pfRead)(void))
+{
+    uint8_t u8Call;
+
+    u16SimCode = ADC_CODE_VDIV / 2u;
+    boSimFail  = true;
+    boSample   = false;
+    for (u8Call = 0u; (u8Call < 4u) && !boSample; u8Call++)
+    {
+        pfRead();
+    }
+    boSimFail = false;
+
+    TEST_CHECK(boSample && !boSampleValid);
+}
+
+/* Host only, no check: the target has no FPU, where the float path costs far more */
+static void Test_vTime(void)
+{
+    volatile float   flAcc = 0.0f;
+    volatile int32_t s32Acc = 0;
+    uint32_t         u32Round;
+    uint16_t         u16Code;
+    clock_t          t0;
+    clock_t          t1;
+    clock_t          t2;
+    double           dbConv = (double)TIME_ROUNDS * ADC_CODE_FULL;
+
+    t0 = clock();
+    for (u32Round = 0u; u32Round < TIME_ROUNDS; u32Round++)
+    {
+        for (u16Code = 0u; u16Code < ADC_CODE_FULL; u16Code++)
+        {
+            flAcc += Ref_flTemp(u16Code, ADC_LCD_TEMP);
+        }
+    }
+    t1 = clock();
+    for (u32Round = 0u; u32Round < TIME_ROUNDS; u32Round++)
+    {
+        for (u16Code = 0u; u16Code < ADC_CODE_FULL; u16Code++)
+        {
+            s32Acc += Adc_s16NtcTemp(&Adc_stLcdNtc, u16Code);
+        }
+    }
+    t2 = clock();
+
+    printf("host: float %.1f ns/conversion, integer %.1f ns/conversion\n", (double)(t1 - t0) * 1e9 / CLOCKS_PER_SEC / dbConv,
+           (double)(t2 - t1) * 1e9 / CLOCKS_PER_SEC / dbConv);
+}
+
+int main(void)
+{
+    Adc_vInit();
+
+    Test_vSweep(&Adc_stLcdNtc, ADC_LCD_TEMP, Adc_vReadLcdTemp, ERR_MAX_LCD);
+    Test_vSweep(&Adc_stPcbNtc, ADC_PCB_TEMP, Adc_vReadPcbTemp, ERR_MAX_PCB);
+    Test_vFail(Adc_vReadLcdTemp);
+    Test_vFail(Adc_vReadPcbTemp);
+    Test_vTime();
+
+#ifdef ADC_ONCHIP
+    return Test_iResult("test_adc_temp (ADC_ONCHIP)");
+#else
+    return Test_iResult("test_adc_temp");
+#endif
+}
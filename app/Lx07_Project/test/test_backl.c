@@ -0,0 +1,274 @@
+/* BackL.c integer scaling against the float and division formulas it replaced: every
+ * 0..100% request from CAN through ramp, duty write, HMI text and readback, every
+ * permille level and derate cap, and the ramp against the per-tick division.
+ * BackL.c is included so its static conversions can be checked on their own */
+#include <string.h>
+#include "../Sch/src/BackL.c"
+#include "TestUtil.h"
+
+#define RAMP_TICKS ((int32_t)MAIN_TIME_MS(BACKL_RAMP_MS))
+
+/*****************************************************************************
+ * Reference: the formulas BackL.c used before the reciprocal constants
+ *****************************************************************************/
+static uint8_t Ref_u8PmToPct(uint16_t u16Pm)
+{
+    return (uint8_t)((u16Pm + 5u) / 10u);
+}
+
+static uint8_t Ref_u8FloatPct(uint16_t u16Pm) // 原读取路径：比例加0.005后乘100截断
+{
+    float flPercent = u16Pm * 1.0 / BACKL_PM_MAX;
+
+    return (uint8_t)((flPercent + 0.005) * 100);
+}
+
+static uint16_t Ref_u16Gamma(uint16_t u16Pm)
+{
+    uint32_t u32X    = (uint32_t)u16Pm * (1u << (BACKL_GAMMA_SHIFT * 2u)) / BACKL_PM_MAX;
+    uint32_t u32Idx  = u32X >> BACKL_GAMMA_SHIFT;
+    uint32_t u32Frac = u32X & ((1u << BACKL_GAMMA_SHIFT) - 1u);
+    uint32_t u32Num  = sizeof(BackL_au16Gamma) / sizeof(BackL_au16Gamma[0]);
+    uint32_t u32Val;
+    uint16_t u16Reg;
+
+    if (u32Idx >= (u32Num - 1u))
+    {
+        u32Val = BackL_au16Gamma[u32Num - 1u];
+    }
+    else
+    {
+        u32Val = BackL_au16Gamma[u32Idx] + (((BackL_au16Gamma[u32Idx + 1u] - BackL_au16Gamma[u32Idx]) * u32Frac) >> BACKL_GAMMA_SHIFT);
+    }
+
+    u16Reg = (uint16_t)((u32Val * BACKL_REG_MAX + (1u << (BACKL_GAMMA_ONE - 1u))) >> BACKL_GAMMA_ONE);
+
+    return ((0u != u16Pm) && (0u == u16Reg)) ? 1u : u16Reg;
+}
+
+static uint16_t Ref_u16Cap(uint16_t u16Derate)
+{
+    return (uint16_t)((uint32_t)BACKL_REG_MAX * u16Derate / THERMAL_PERMILLE);
+}
+
+static void Ref_vText(uint8_t u8Pct, char *pcText) // 原n2.val=xxx的三位数字
+{
+    if (u8Pct == 100)
+    {
+        pcText[0] = 0x30 + u8Pct / 100;
+        pcText[1] = 0x30 + (u8Pct % 100) / 10;
+        pcText[2] = 0x30 + u8Pct % 10;
+    }
+    else
+    {
+        pcText[0] = 0x30;
+        pcText[1] = 0x30 + u8Pct / 10;
+        pcText[2] = 0x30 + u8Pct % 10;
+    }
+    pcText[3] = '\0';
+}
+
+/*****************************************************************************
+ * Modules BackL.c calls: a posted write job runs after BackL_vHandle like in
+ * ProductLine, the chip register and the last HMI text are kept
+ *****************************************************************************/
+Debounce_StInfo Debounce_StSw1;
+Debounce_StInfo Debounce_StSw2;
+
+static uint16_t u16ChipReg = BACKL_REG_MAX;
+static bool     boWrJob;
+static bool     boWrFail;
+static char     acUart[4];
+static uint32_t u32UartCnt;
+
+void Debounce_vInit(Debounce_StInfo *pstDeb, uint16_t u16StableTicks)
+{
+    (void)pstDeb;
+    (void)u16StableTicks;
+}
+
+void Debounce_vCheck(Debounce_StInfo *pstDeb)
+{
+    (void)pstDeb;
+}
+
+bool Debounce_boGetValidStu(Debounce_StInfo *pstDeb)
+{
+    (void)pstDeb;
+    return false;
+}
+
+bool ProductLine_boPost(ProductLine_enWorkSts enJob, ProductLine_pfJobDone pfDone)
+{
+    (void)pfDone;
+    boWrJob = boWrJob || (ProDWork_Write_Bkl == enJob);
+    return true;
+}
+
+bool ProductLine_boI2cWriteCb(uint8_t u8Dev, const uint8_t *pu8Data, uint8_t u8Len, ProductLine_pfWrDone pfDone)
+{
+    TEST_CHECK((DEV_BKL == u8Dev) && (3u == u8Len) && (0x05u == pu8Data[0]) && (NULL != pfDone));
+    if (!boWrFail)
+    {
+        u16ChipReg = (uint16_t)((pu8Data[1] << 8u) | pu8Data[2]);
+    }
+    pfDone(!boWrFail); // 总线比主循环快，回调在返回前执行
+    return true;
+}
+
+void ProductLine_vJobDone(ProductLine_enWorkSts enJob)
+{
+    (void)enJob;
+}
+
+void Uart_Transmit(uint8_t *logBuf, uint32_t logLen)
+{
+    static const uint8_t au8Head[] = {0x6E, 0x32, 0x2E, 0x76, 0x61, 0x6C, 0x3D}; // n2.val=
+
+    TEST_CHECK((13u == logLen) && (0 == memcmp(logBuf, au8Head, sizeof(au8Head))));
+    memcpy(acUart, &logBuf[7], 3u);
+    acUart[3] = '\0';
+    u32UartCnt++;
+}
+
+/*****************************************************************************
+ * Tests
+ *****************************************************************************/
+static void Test_vTick(void)
+{
+    BackL_vHandle();
+    if (boWrJob)
+    {
+        boWrJob = false;
+        BackL_vWriteLevel();
+    }
+}
+
+/* Every permille level and derate cap, every percent of the HMI text */
+static void Test_vScale(void)
+{
+    uint16_t u16Pm;
+    uint8_t  u8Pct;
+    char     acRef[4];
+
+    for (u16Pm = 0u; u16Pm <= BACKL_PM_MAX; u16Pm++)
+    {
+        TEST_CHECK(BackL_u8PmToPct(u16Pm) == Ref_u8PmToPct(u16Pm));
+        TEST_CHECK(BackL_u16Gamma(u16Pm) == Ref_u16Gamma(u16Pm));
+
+        BackL_vSetDerate(u16Pm);
+        BackL_u16CurPm = BACKL_PM_MAX;
+        TEST_CHECK(BackL_u16OutLevel() == Ref_u16Cap(u16Pm));
+    }
+    BackL_vSetDerate(THERMAL_PERMILLE);
+
+    for (u8Pct = 0u; u8Pct <= 100u; u8Pct++)
+    {
+        BackL_vSendPct(u8Pct);
+        Ref_vText(u8Pct, acRef);
+        TEST_CHECK(0 == strcmp(acUart, acRef));
+    }
+}
+
+/* Every CAN percent: the ramp ends on the level, the duty and both HMI reports match the old formulas */
+static void Test_vCanAll(void)
+{
+    uint8_t  u8Pct;
+    uint16_t u16Tick;
+    char     acRef[4];
+
+    for (u8Pct = 0u; u8Pct <= 100u; u8Pct++)
+    {
+        TEST_CHECK(Ref_u8FloatPct((uint16_t)(u8Pct * 10u)) == u8Pct);
+
+        BackL_vWriteLevFromCan(u8Pct);
+        u32UartCnt = 0u;
+        for (u16Tick = 0u; (int32_t)u16Tick <= RAMP_TICKS; u16Tick++)
+        {
+            Test_vTick();
+        }
+
+        Ref_vText(u8Pct, acRef);
+        TEST_CHECK(u16ChipReg == Ref_u16Gamma((uint16_t)(u8Pct * 10u)));
+        TEST_CHECK_RANGE(u32UartCnt, 1u, 1u); // 渐变中间的写入不刷新显示
+        TEST_CHECK(0 == strcmp(acUart, acRef));
+
+        BackL_vReadLevel();
+        TEST_CHECK(0 == strcmp(acUart, acRef));
+    }
+
+    BackL_vWriteLevFromCan(101u);
+    Test_vTick();
+    TEST_CHECK(1000u == BackL_u16TargetPm);
+}
+
+/* Writes the chip did not take are made again, the HMI shows the level once the chip has it */
+static void Test_vWrFail(void)
+{
+    uint16_t u16Tick;
+
+    boWrFail = true;
+    BackL_vWriteLevFromCan(50u);
+    u32UartCnt = 0u;
+    for (u16Tick = 0u; (int32_t)u16Tick <= RAMP_TICKS; u16Tick++)
+    {
+        Test_vTick();
+    }
+    TEST_CHECK((u16ChipReg != Ref_u16Gamma(500u)) && (0u == u32UartCnt));
+
+    boWrFail = false;
+    Test_vTick();
+    Test_vTick();
+    TEST_CHECK(u16ChipReg == Ref_u16Gamma(500u));
+    TEST_CHECK((1u == u32UartCnt) && (0 == strcmp(acUart, "050")));
+}
+
+/* The accumulated step against the per-tick division it replaced, both directions */
+static void Test_vRamp(uint16_t u16From, uint16_t u16To)
+{
+    int32_t  s32Span = (int32_t)u16From - u16To;
+    uint16_t u16Tick;
+    uint16_t u16Prev;
+    int32_t  s32Ref;
+
+    BackL_u16TargetPm = u16From;
+    BackL_u16CurPm    = u16From;
+    BackL_u16RampTick = 0u;
+    BackL_vSetTarget(u16To);
+
+    u16Prev = u16From;
+    for (u16Tick = 1u; (int32_t)u16Tick <= RAMP_TICKS; u16Tick++)
+    {
+        BackL_vRamp();
+        s32Ref = u16To + s32Span * (RAMP_TICKS - u16Tick) / RAMP_TICKS;
+
+        TEST_CHECK_RANGE(BackL_u16CurPm - s32Ref, -1, 1);
+        TEST_CHECK((u16To >= u16From) ? (BackL_u16CurPm >= u16Prev) : (BackL_u16CurPm <= u16Prev));
+        u16Prev = BackL_u16CurPm;
+    }
+    TEST_CHECK((BackL_u16CurPm == u16To) && (0u == BackL_u16RampTick));
+}
+
+int main(void)
+{
+    uint16_t u16From;
+    uint16_t u16To;
+
+    BackL_vInit();
+
+    Test_vScale();
+    Test_vCanAll();
+    Test_vWrFail();
+
+    for (u16From = 0u; u16From <= BACKL_PM_MAX; u16From += 10u)
+    {
+        for (u16To = 0u; u16To <= BACKL_PM_MAX; u16To += 10u)
+        {
+            Test_vRamp(u16From, u16To);
+        }
+    }
+    Test_vRamp(0u, 1u);
+    Test_vRamp(1000u, 999u);
+
+    return Test_iResult("test_backl");
+}
@@ -0,0 +1,429 @@
+/* I2cXfer.c driving both controllers of the simulated bus (stub/SimI2c.c) with the
+ * product traffic: DES register streams by DMA back to back on I2C0, a touch frame
+ * every 10ms and an ADC sample every 5ms. Built twice, TP/ADC sharing I2C0 and with
+ * I2CXFER_I2C1_TP_ADC, so both runs print throughput and latency for comparison.
+ * Also stall/recovery, NACK and a board revision moving the DES address */
+#include "SimI2c.h"
+#include "Config.h"
+#include "I2cXfer.h"
+#include "TestUtil.h"
+
+#define MS_NS       (1000000uLL)
+#define RUN_MS      (2100u) /* two full bus load windows */
+#define TOUCH_MS    (10u)
+#define ADC_MS      (5u)
+#define TOUCH_LEN   (32u)
+#define ADC_LEN     (2u)
+#define STREAM_SEG  (8u) /* register writes per DES stream, like a RegSeq burst */
+#define STREAM_DATA (6u)
+#define STREAM_CMD  (STREAM_SEG * (2u + STREAM_DATA))
+#define SLACK_NS    (20000u) /* interrupt and FIFO turnaround the time model does not count */
+#define DES_ALT     (0x4Cu)  /* deserializer address a board revision may use */
+
+#ifdef I2CXFER_I2C1_TP_ADC
+#define TEST_NAME "test_i2c_bus (TP/ADC on I2C1)"
+#else
+#define TEST_NAME "test_i2c_bus (TP/ADC on I2C0)"
+#endif
+
+typedef struct
+{
+    I2cXfer_stDesc stDesc;
+    uint64_t       u64Submit;
+    uint64_t       u64MaxNs;
+    uint64_t       u64SumNs;
+    uint32_t       u32Done;
+    uint32_t       u32Error;
+    uint32_t       u32Skip; /* previous read still busy when the next one was due */
+    uint32_t       u32Bad;  /* data not equal to the device memory */
+} Read_T;
+
+/* DMA addresses are handed over as 32 bit, everything the DMA touches is static */
+static uint16_t au16Stream[STREAM_CMD];
+static uint8_t  au8TouchReg[1] = {0x00u};
+static uint8_t  au8AdcReg[1]   = {0x10u};
+static uint8_t  au8TouchRx[TOUCH_LEN];
+static uint8_t  au8AdcRx[ADC_LEN];
+
+static I2cXfer_stDesc stStream;
+static Read_T         stTouch;
+static Read_T         stAdc;
+static bool           boStreamOn;
+static uint32_t       u32StreamDone;
+static uint32_t       u32StreamError;
+static uint32_t       u32CbPriMask; /* callbacks that ran with interrupts disabled */
+static uint8_t        u8DesAddr = DEV_DES;
+
+/* Modules I2cXfer.c calls besides the SDK */
+uint8_t Board_u8BusAddr(uint8_t u8Dev)
+{
+    return (DEV_DES == u8Dev) ? u8DesAddr : u8Dev;
+}
+
+void RegCache_vDone(uint8_t u8Dev, bool boOk)
+{
+    (void)u8Dev;
+    (void)boOk;
+}
+
+static uint8_t Test_u8Pattern(uint32_t u32Round, uint8_t u8Seg, uint8_t u8Idx)
+{
+    return (uint8_t)(u32Round * 31u + u8Seg * STREAM_DATA + u8Idx);
+}
+
+/* DES register 0x01x0 + 8 * segment, six data bytes each */
+static void Test_vEncode(uint32_t u32Round)
+{
+    uint8_t  au8Seg[2u + STREAM_DATA];
+    uint8_t  u8Seg;
+    uint8_t  u8Idx;
+    uint16_t u16Len = 0u;
+
+    for (u8Seg = 0u; u8Seg < STREAM_SEG; u8Seg++)
+    {
+        au8Seg[0] = 0x01u;
+        au8Seg[1] = (uint8_t)(u8Seg * 8u);
+        for (u8Idx = 0u; u8Idx < STREAM_DATA; u8Idx++)
+        {
+            au8Seg[2u + u8Idx] = Test_u8Pattern(u32Round, u8Seg, u8Idx);
+        }
+        u16Len += I2cXfer_u16EncodeWrite(&au16Stream[u16Len], au8Seg, sizeof(au8Seg));
+    }
+}
+
+static void Test_vStreamDone(I2cXfer_stDesc *pstDesc)
+{
+    u32CbPriMask += Sim_u32PriMask;
+
+    if (I2cXfer_Done == pstDesc->enSts)
+    {
+        u32StreamDone++;
+    }
+    else
+    {
+        u32StreamError++;
+    }
+
+    if (boStreamOn)
+    {
+        Test_vEncode(u32StreamDone);
+        TEST_CHECK(I2cXfer_boSubmit(pstDesc));
+    }
+}
+
+static void Test_vReadDone(I2cXfer_stDesc *pstDesc)
+{
+    Read_T  *pstRead = (pstDesc == &stTouch.stDesc) ? &stTouch : &stAdc;
+    uint64_t u64Ns   = SimI2c_u64Now() - pstRead->u64Submit;
+    uint8_t *pu8Mem  = SimI2c_pu8Mem(pstDesc->u8DevAddr);
+    uint8_t  u8Idx;
+
+    u32CbPriMask += Sim_u32PriMask;
+
+    if (I2cXfer_Done != pstDesc->enSts)
+    {
+        pstRead->u32Error++;
+        return;
+    }
+
+    pstRead->u32Done++;
+    pstRead->u64SumNs += u64Ns;
+    if (u64Ns > pstRead->u64MaxNs)
+    {
+        pstRead->u64MaxNs = u64Ns;
+    }
+
+    for (u8Idx = 0u; u8Idx < pstDesc->u8RxLen; u8Idx++)
+    {
+        if ((NULL == pu8Mem) || (pstDesc->pu8Rx[u8Idx] != pu8Mem[pstDesc->pu8Tx[0] + u8Idx]))
+        {
+            pstRead->u32Bad++;
+            break;
+        }
+    }
+}
+
+static void Test_vRead(Read_T *pstRead)
+{
+    if (I2cXfer_boBusy(&pstRead->stDesc))
+    {
+        pstRead->u32Skip++;
+        return;
+    }
+
+    pstRead->u64Submit = SimI2c_u64Now();
+    TEST_CHECK(I2cXfer_boSubmit(&pstRead->stDesc));
+}
+
+static void Test_vSetup(void)
+{
+    uint16_t u16Idx;
+
+    SimI2c_vAddDev(I2cXfer_enDevBus(DEV_DES), DEV_DES, 2u);
+    SimI2c_vAddDev(I2cXfer_enDevBus(DEV_TP), DEV_TP, 1u);
+    SimI2c_vAddDev(I2cXfer_enDevBus(DEV_ADC), DEV_ADC, 1u);
+
+    for (u16Idx = 0u; u16Idx < 256u; u16Idx++)
+    {
+        SimI2c_pu8Mem(DEV_TP)[u16Idx]  = (uint8_t)(u16Idx * 7u + 3u);
+        SimI2c_pu8Mem(DEV_ADC)[u16Idx] = (uint8_t)(u16Idx ^ 0xA5u);
+    }
+
+    stStream.u8DevAddr = DEV_DES;
+    stStream.pu16Cmd   = au16Stream;
+    stStream.u16CmdLen = STREAM_CMD;
+    stStream.pfDone    = Test_vStreamDone;
+
+    stTouch.stDesc.u8DevAddr = DEV_TP;
+    stTouch.stDesc.pu8Tx     = au8TouchReg;
+    stTouch.stDesc.u8TxLen   = sizeof(au8TouchReg);
+    stTouch.stDesc.pu8Rx     = au8TouchRx;
+    stTouch.stDesc.u8RxLen   = TOUCH_LEN;
+    stTouch.stDesc.pfDone    = Test_vReadDone;
+
+    stAdc.stDesc.u8DevAddr = DEV_ADC;
+    stAdc.stDesc.pu8Tx     = au8AdcReg;
+    stAdc.stDesc.u8TxLen   = sizeof(au8AdcReg);
+    stAdc.stDesc.pu8Rx     = au8AdcRx;
+    stAdc.stDesc.u8RxLen   = ADC_LEN;
+    stAdc.stDesc.pfDone    = Test_vReadDone;
+}
+
+/* One main loop millisecond: application requests, the 5ms tick, then the buses */
+static void Test_vMs(uint32_t u32Ms, bool boReads)
+{
+    if (boReads && (0u == (u32Ms % TOUCH_MS)))
+    {
+        Test_vRead(&stTouch);
+    }
+    if (0u == (u32Ms % MAIN_TASK_MS))
+    {
+        if (boReads)
+        {
+            Test_vRead(&stAdc);
+        }
+        I2cXfer_vTick();
+    }
+    SimI2c_vRun((uint64_t)(u32Ms + 1u) * MS_NS);
+}
+
+static uint32_t Test_u32ReadNs(uint8_t u8Dev, uint8_t u8TxLen, uint8_t u8RxLen)
+{
+    return I2cXfer_u32BusNs(I2cXfer_enDevSpeed(u8Dev), (uint16_t)(2u + u8TxLen + u8RxLen));
+}
+
+static uint32_t Test_u32StreamNs(void)
+{
+    return STREAM_SEG * I2cXfer_u32BusNs(I2cXfer_enDevSpeed(DEV_DES), 3u + STREAM_DATA);
+}
+
+/* Product traffic for RUN_MS: every read completes with the right data, the touch
+ * frame waits at most for what the bus already had in flight */
+static void Test_vBenchmark(void)
+{
+    uint32_t u32Ms;
+    uint32_t u32TouchNs = Test_u32ReadNs(DEV_TP, 1u, TOUCH_LEN);
+    uint32_t u32AdcNs   = Test_u32ReadNs(DEV_ADC, 1u, ADC_LEN);
+    uint32_t u32Share   = 0u; /* bus time TP/ADC take from the DES streams, per mille */
+    uint64_t au64Busy[I2CXFER_BUS_NUM] = {0u};
+    uint32_t u32Rate;
+    uint32_t u32Expect;
+    uint32_t u32Load;
+    I2C_Id_t enBus;
+    uint8_t  u8Seg;
+    uint8_t  u8Idx;
+    uint8_t *pu8Des = SimI2c_pu8Mem(DEV_DES);
+    bool     boMatch = true;
+
+    boStreamOn = true;
+    Test_vEncode(0u);
+    TEST_CHECK(I2cXfer_boSubmit(&stStream));
+
+    for (u32Ms = 0u; u32Ms < RUN_MS; u32Ms++)
+    {
+        /* Wire time in the second load window of I2cXfer_vTick, [1s, 2s) */
+        if ((1000u == u32Ms) || (2000u == u32Ms))
+        {
+            for (enBus = I2C0_ID; enBus <= I2C1_ID; enBus++)
+            {
+                au64Busy[enBus] = SimI2c_u64BusyNs(enBus) - au64Busy[enBus];
+            }
+        }
+        Test_vMs(u32Ms, true);
+    }
+
+    boStreamOn = false;
+    for (u32Ms = RUN_MS; u32Ms < RUN_MS + 10u; u32Ms++)
+    {
+        Test_vMs(u32Ms, false);
+    }
+
+    /* The DES holds the data of the last stream */
+    for (u8Seg = 0u; u8Seg < STREAM_SEG; u8Seg++)
+    {
+        for (u8Idx = 0u; u8Idx < STREAM_DATA; u8Idx++)
+        {
+            boMatch = boMatch && (pu8Des[u8Seg * 8u + u8Idx] == Test_u8Pattern(u32StreamDone - 1u, u8Seg, u8Idx));
+        }
+    }
+    TEST_CHECK(boMatch);
+    TEST_CHECK(u32StreamError == 0u);
+
+    TEST_CHECK(stTouch.u32Done == RUN_MS / TOUCH_MS);
+    TEST_CHECK(stAdc.u32Done == RUN_MS / ADC_MS);
+    TEST_CHECK((stTouch.u32Error + stTouch.u32Skip + stTouch.u32Bad) == 0u);
+    TEST_CHECK((stAdc.u32Error + stAdc.u32Skip + stAdc.u32Bad) == 0u);
+    TEST_CHECK(u32CbPriMask == 0u);
+
+    /* Worst case wait: an ADC read queued first, on a shared bus also the DES stream on the wires */
+    if (I2C0_ID == I2cXfer_enDevBus(DEV_TP))
+    {
+        TEST_CHECK_RANGE(stTouch.u64MaxNs, u32TouchNs, u32TouchNs + u32AdcNs + Test_u32StreamNs() + SLACK_NS);
+        u32Share = ((u32TouchNs / 1000u) * (1000u / TOUCH_MS) + (u32AdcNs / 1000u) * (1000u / ADC_MS)) / 1000u;
+    }
+    else
+    {
+        TEST_CHECK_RANGE(stTouch.u64MaxNs, u32TouchNs, u32TouchNs + u32AdcNs + SLACK_NS);
+    }
+
+    /* DES data rate within 5% of what the time model leaves the streams */
+    u32Rate   = (uint32_t)(((uint64_t)u32StreamDone * STREAM_SEG * STREAM_DATA * MS_NS) / ((uint64_t)RUN_MS * MS_NS / 1000u));
+    u32Expect = (uint32_t)(((uint64_t)STREAM_SEG * STREAM_DATA * 1000000000uLL / Test_u32StreamNs()) * (1000u - u32Share) / 1000u);
+    TEST_CHECK_RANGE(u32Rate, (u32Expect * 95u) / 100u, (u32Expect * 105u) / 100u);
+
+    /* I2cXfer_u8BusLoad against the time the simulated wires were busy */
+    for (enBus = I2C0_ID; enBus <= I2C1_ID; enBus++)
+    {
+        u32Load = (uint32_t)(au64Busy[enBus] / (10u * MS_NS));
+        printf("I2C%u load: I2cXfer %3u%%, bus %3u%%\n", (unsigned)enBus, I2cXfer_u8BusLoad(enBus), (unsigned)u32Load);
+        TEST_CHECK_RANGE(I2cXfer_u8BusLoad(enBus), (u32Load > 3u) ? (u32Load - 3u) : 0u, u32Load + 3u);
+    }
+
+    printf("DES stream %u B/s (model %u B/s), %u streams\n", (unsigned)u32Rate, (unsigned)u32Expect, (unsigned)u32StreamDone);
+    printf("touch %u frames, latency mean %u us max %u us (bus time %u us)\n", (unsigned)stTouch.u32Done,
+           (unsigned)(stTouch.u64SumNs / stTouch.u32Done / 1000u), (unsigned)(stTouch.u64MaxNs / 1000u), (unsigned)(u32TouchNs / 1000u));
+    printf("ADC %u samples, latency mean %u us max %u us (bus time %u us)\n", (unsigned)stAdc.u32Done,
+           (unsigned)(stAdc.u64SumNs / stAdc.u32Done / 1000u), (unsigned)(stAdc.u64MaxNs / 1000u), (unsigned)(u32AdcNs / 1000u));
+}
+
+static bool Test_boErrCnt(uint8_t u8Dev, I2cXfer_stErrCnt *pstCnt)
+{
+    uint8_t u8Idx;
+    uint8_t u8Addr;
+
+    for (u8Idx = 0u; I2cXfer_boGetErrCnt(u8Idx, &u8Addr, pstCnt); u8Idx++)
+    {
+        if (u8Addr == u8Dev)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* A touch controller holding SDA: every try times out and is recovered outside the
+ * interrupt lock, the read then ends in error; once released the next read passes */
+static void Test_vStall(uint32_t *pu32Ms)
+{
+    I2C_Id_t         enBus = I2cXfer_enDevBus(DEV_TP);
+    I2cXfer_stErrCnt stCnt;
+    uint32_t         u32End;
+
+    SimI2c_vStall(enBus, true);
+    stTouch.u32Done  = 0u;
+    stTouch.u32Error = 0u;
+    Test_vRead(&stTouch);
+
+    for (u32End = *pu32Ms + 300u; *pu32Ms < u32End; (*pu32Ms)++)
+    {
+        Test_vMs(*pu32Ms, false);
+    }
+    TEST_CHECK(stTouch.u32Error == 1u);
+    TEST_CHECK(I2cXfer_u16RecoverCnt() == (I2CXFER_RETRY_MAX + 1u));
+    TEST_CHECK(SimI2c_u32RecoverCnt() == (I2CXFER_RETRY_MAX + 1u));
+    TEST_CHECK(SimI2c_u32RecoverLocked() == 0u);
+    TEST_CHECK(u32CbPriMask == 0u);
+    TEST_CHECK(Test_boErrCnt(DEV_TP, &stCnt) && (stCnt.u16Timeout == (I2CXFER_RETRY_MAX + 1u)) && (stCnt.u16Fail == 1u));
+
+    SimI2c_vStall(enBus, false);
+    Test_vRead(&stTouch);
+    for (u32End = *pu32Ms + 10u; *pu32Ms < u32End; (*pu32Ms)++)
+    {
+        Test_vMs(*pu32Ms, false);
+    }
+    TEST_CHECK((stTouch.u32Done == 1u) && (stTouch.u32Bad == 0u));
+}
+
+/* No device answers at the EEPROM address: NACK on every try, then an error */
+static void Test_vNack(uint32_t *pu32Ms)
+{
+    static uint8_t   au8Reg[1] = {0u};
+    static uint8_t   au8Rx[4];
+    I2cXfer_stDesc   stDesc    = {.u8DevAddr = DEV_EEP, .pu8Tx = au8Reg, .u8TxLen = 1u, .pu8Rx = au8Rx, .u8RxLen = 4u};
+    I2cXfer_stErrCnt stCnt;
+    uint32_t         u32End;
+
+    TEST_CHECK(I2cXfer_boSubmit(&stDesc));
+    for (u32End = *pu32Ms + 10u; *pu32Ms < u32End; (*pu32Ms)++)
+    {
+        Test_vMs(*pu32Ms, false);
+    }
+    TEST_CHECK(I2cXfer_Error == stDesc.enSts);
+    TEST_CHECK(0u != (stDesc.u32ErrSrc & (1uL << ERR_7BIT_ADDR_NO_ACK)));
+    TEST_CHECK(Test_boErrCnt(DEV_EEP, &stCnt) && (stCnt.u16Nack == (I2CXFER_RETRY_MAX + 1u)) && (stCnt.u16Fail == 1u));
+}
+
+/* One DES register read, returns the device address that answered */
+static uint8_t Test_u8DesRead(uint32_t *pu32Ms)
+{
+    static uint8_t au8Reg[2] = {0x00u, 0x40u};
+    static uint8_t au8Rx[1];
+    I2cXfer_stDesc stDesc    = {.u8DevAddr = DEV_DES, .pu8Tx = au8Reg, .u8TxLen = 2u, .pu8Rx = au8Rx, .u8RxLen = 1u};
+    uint32_t       u32End;
+
+    SimI2c_pu8Mem(DEV_DES)[au8Reg[1]] = 0x11u;
+    SimI2c_pu8Mem(DES_ALT)[au8Reg[1]] = 0x22u;
+
+    TEST_CHECK(I2cXfer_boSubmit(&stDesc));
+    for (u32End = *pu32Ms + 5u; *pu32Ms < u32End; (*pu32Ms)++)
+    {
+        Test_vMs(*pu32Ms, false);
+    }
+    TEST_CHECK(I2cXfer_Done == stDesc.enSts);
+
+    return (0x22u == au8Rx[0]) ? DES_ALT : DEV_DES;
+}
+
+/* Board identified after the controller was already pointed at the default address:
+ * the cached target keeps it there until I2cXfer_vForgetTarget */
+static void Test_vRemap(uint32_t *pu32Ms)
+{
+    SimI2c_vAddDev(I2cXfer_enDevBus(DEV_DES), DES_ALT, 2u);
+
+    TEST_CHECK(DEV_DES == Test_u8DesRead(pu32Ms));
+    u8DesAddr = DES_ALT;
+    TEST_CHECK(DEV_DES == Test_u8DesRead(pu32Ms));
+    I2cXfer_vForgetTarget();
+    TEST_CHECK(DES_ALT == Test_u8DesRead(pu32Ms));
+    u8DesAddr = DEV_DES;
+    I2cXfer_vForgetTarget();
+}
+
+int main(void)
+{
+    uint32_t u32Ms = RUN_MS + 10u;
+
+    /* The DMA gets 32-bit addresses, -no-pie keeps the statics below 4GB */
+    TEST_CHECK((uintptr_t)&au16Stream[STREAM_CMD] <= UINT32_MAX);
+
+    printf("%s\n", TEST_NAME);
+    I2cXfer_vInit();
+    Test_vSetup();
+
+    Test_vBenchmark();
+    Test_vStall(&u32Ms);
+    Test_vNack(&u32Ms);
+    Test_vRemap(&u32Ms);
+
+    return Test_iResult(TEST_NAME);
+}
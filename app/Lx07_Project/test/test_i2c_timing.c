@@ -0,0 +1,217 @@
+/* I2cXfer bus time model (I2cXfer_u32BitNs/u32BusNs) against the SCL counts I2cXfer
+ * programs, through the SDK driver, for the speed of every device in I2cXfer_astDevCfg */
+#include "SdkI2c.h"
+#include "Z20K11xM_dma.h"
+#include "Z20K11xM_sysctrl.h"
+#include "Config.h"
+#include "I2cXfer.h"
+#include "TestUtil.h"
+
+typedef struct
+{
+    I2C_Speed_t enSpeed;
+    const char *pcName;
+    uint32_t    u32MinBitNs;  /* SCL period at the highest rate the mode allows */
+    uint32_t    u32MinLowNs;  /* tLOW and tHIGH minimum from the I2C specification */
+    uint32_t    u32MinHighNs;
+} Mode_T;
+
+static const Mode_T astMode[] = {
+    {I2C_SPEED_STANDARD,  "standard", 10000u, 4700u, 4000u},
+    {I2C_SPEED_FAST,      "fast",     2500u,  1300u, 600u },
+    {I2C_SPEED_FAST_PLUS, "fast+",    1000u,  500u,  260u },
+};
+
+/* I2C0 as I2c_Init leaves it before I2cXfer selects a speed */
+static const I2C_Config_t stInitCfg = {
+    .masterSlaveMode = I2C_MASTER,
+    .speedMode       = I2C_SPEED_STANDARD,
+    .addrBitMode     = I2C_ADDR_BITS_7,
+    .ownSlaveAddr    = 0x40u,
+    .restart         = ENABLE,
+};
+
+static const uint8_t au8Dev[] = {DEV_SER, DEV_DES, DEV_BKL, DEV_TP, DEV_ADC, DEV_EEP};
+
+/* Used by I2cXfer.c outside the timing model */
+bool boI2c0IsIdle = true;
+
+void DMA_Init(const DMA_Config_t *ptDMAInitConfig)
+{
+    (void)ptDMAInitConfig;
+}
+
+void DMA_ChannelRequestEnable(DMA_Channel_t channel)
+{
+    (void)channel;
+}
+
+void DMA_ChannelRequestDisable(DMA_Channel_t channel)
+{
+    (void)channel;
+}
+
+void DMA_ClearDoneStatus(DMA_Channel_t channel)
+{
+    (void)channel;
+}
+
+void DMA_InstallCallBackFunc(DMA_Channel_t channel, DMA_INT_t intType, isr_cb_t *cbFun)
+{
+    (void)channel;
+    (void)intType;
+    (void)cbFun;
+}
+
+ResultStatus_t DMA_ConfigTransfer(const DMA_TransferConfig_t *config)
+{
+    (void)config;
+    return SUCC;
+}
+
+void SYSCTRL_EnableModule(SYSCTRL_Module_t mod)
+{
+    (void)mod;
+}
+
+uint8_t Board_u8BusAddr(uint8_t u8Dev)
+{
+    return u8Dev;
+}
+
+/* i2c.c: the SDK selects the speed, the counts are written over its fixed ones */
+void I2c_vSetScl(I2C_Id_t i2cNo, I2C_Speed_t speedMode, uint16_t u16HCnt, uint16_t u16LCnt)
+{
+    i2c_reg_t *pstReg = SdkI2c_pstReg(i2cNo);
+
+    I2C_SclHighCount(i2cNo, speedMode);
+    I2C_LimitSpikeSuppression(i2cNo, speedMode);
+
+    if (I2C_SPEED_STANDARD == speedMode)
+    {
+        pstReg->I2C_STD_SCL_HCNT.STD_SCL_HCNT = u16HCnt;
+        pstReg->I2C_STD_SCL_LCNT.STD_SCL_LCNT = u16LCnt;
+    }
+    else
+    {
+        pstReg->I2C_FST_SCL_HCNT.FST_SCL_HCNT = u16HCnt;
+        pstReg->I2C_FST_SCL_LCNT.FST_SCL_LCNT = u16LCnt;
+    }
+}
+
+bool I2c_boBusRecover(I2C_Id_t i2cNo)
+{
+    (void)i2cNo;
+    return true;
+}
+
+void RegCache_vDone(uint8_t u8Dev, bool boOk)
+{
+    (void)u8Dev;
+    (void)boOk;
+}
+
+static const Mode_T *Test_pstMode(I2C_Speed_t enSpeed)
+{
+    uint8_t u8Idx;
+
+    for (u8Idx = 0u; u8Idx < (sizeof(astMode) / sizeof(astMode[0])); u8Idx++)
+    {
+        if (astMode[u8Idx].enSpeed == enSpeed)
+        {
+            return &astMode[u8Idx];
+        }
+    }
+    return NULL;
+}
+
+/* Start a transfer to the device so I2cXfer_vRetarget sets its speed, and check the model
+ * against the registers it programmed */
+static void Test_vMode(const Mode_T *pstMode, uint8_t u8Dev)
+{
+    static const uint8_t au8Tx[] = {0x00u};
+
+    I2cXfer_stDesc stDesc = {.u8DevAddr = u8Dev, .pu8Tx = au8Tx, .u8TxLen = sizeof(au8Tx)};
+    I2C_Id_t       enBus  = I2cXfer_enDevBus(u8Dev);
+    i2c_reg_t     *pstReg = SdkI2c_pstReg(enBus);
+    uint32_t       u32HCnt;
+    uint32_t       u32LCnt;
+    uint32_t       u32SpkLen;
+    uint32_t       u32HighNs;
+    uint32_t       u32LowNs;
+    uint32_t       u32BitNs;
+    uint16_t       u16Byte;
+
+    TEST_CHECK(I2cXfer_enDevSpeed(u8Dev) == pstMode->enSpeed);
+
+    I2C_Init(enBus, &stInitCfg);
+    ((i2c_reg_w_t *)pstReg)->I2C_STATUS1 = 1u << I2C_STATUS_TFE; // 控制器空闲
+    I2cXfer_vInit();
+    TEST_CHECK(I2cXfer_boSubmit(&stDesc) && (I2cXfer_Active == stDesc.enSts));
+    I2cXfer_vInit(); // 没有中断，直接结束这次传输，SCL计数保留
+
+    if (I2C_SPEED_STANDARD == pstMode->enSpeed)
+    {
+        u32HCnt = pstReg->I2C_STD_SCL_HCNT.STD_SCL_HCNT;
+        u32LCnt = pstReg->I2C_STD_SCL_LCNT.STD_SCL_LCNT;
+    }
+    else
+    {
+        u32HCnt = pstReg->I2C_FST_SCL_HCNT.FST_SCL_HCNT;
+        u32LCnt = pstReg->I2C_FST_SCL_LCNT.FST_SCL_LCNT;
+    }
+    u32SpkLen = pstReg->I2C_FSTD_SPKCNT.FSTD_SPKLEN;
+
+    /* DesignWare master: high = HCNT + SPKLEN + 7, low = LCNT + 1 ic_clk, rise time not counted */
+    u32HighNs = ((u32HCnt + u32SpkLen + 7u) * 1000000u) / I2CXFER_CLK_KHZ;
+    u32LowNs  = ((u32LCnt + 1u) * 1000000u) / I2CXFER_CLK_KHZ;
+    u32BitNs  = I2cXfer_u32BitNs(pstMode->enSpeed);
+
+    printf("%-8s HCNT %3u LCNT %3u SPKLEN %u: high %5u ns low %5u ns, model %5u ns/bit = %u kHz\n", pstMode->pcName,
+           (unsigned)u32HCnt, (unsigned)u32LCnt, (unsigned)u32SpkLen, (unsigned)u32HighNs, (unsigned)u32LowNs,
+           (unsigned)u32BitNs, (unsigned)(1000000u / u32BitNs));
+
+    /* The model is the programmed SCL period, and the bus never runs faster than the mode allows */
+    TEST_CHECK_RANGE(u32BitNs, (u32HighNs + u32LowNs) - 1u, u32HighNs + u32LowNs + 1u);
+    TEST_CHECK(u32BitNs >= pstMode->u32MinBitNs);
+    TEST_CHECK(u32LowNs >= pstMode->u32MinLowNs);
+    TEST_CHECK(u32HighNs >= pstMode->u32MinHighNs);
+    if (I2C_SPEED_FAST == pstMode->enSpeed)
+    {
+        TEST_CHECK(u32BitNs <= pstMode->u32MinBitNs); // FS的器件按满速400kHz访问
+    }
+
+    /* 9 SCL per byte (8 data + ACK) plus START and STOP, no overflow for any transfer I2cXfer builds */
+    for (u16Byte = 0u; u16Byte <= 1024u; u16Byte++)
+    {
+        TEST_CHECK(I2cXfer_u32BusNs(pstMode->enSpeed, u16Byte) == (((uint32_t)u16Byte * 9u) + 2u) * u32BitNs);
+    }
+}
+
+int main(void)
+{
+    uint8_t       u8Idx;
+    I2C_Speed_t   enSpeed;
+    const Mode_T *pstMode;
+
+    Test_vMode(&astMode[0], 0x7Fu); /* unlisted devices run standard */
+    Test_vMode(&astMode[1], DEV_DES);
+    Test_vMode(&astMode[2], DEV_SER);
+
+    /* Every listed device runs FAST or FM+, unlisted ones standard */
+    for (u8Idx = 0u; u8Idx < sizeof(au8Dev); u8Idx++)
+    {
+        enSpeed = I2cXfer_enDevSpeed(au8Dev[u8Idx]);
+        pstMode = Test_pstMode(enSpeed);
+        TEST_CHECK((I2C_SPEED_FAST == enSpeed) || (I2C_SPEED_FAST_PLUS == enSpeed));
+        TEST_CHECK(NULL != pstMode);
+        if (NULL != pstMode)
+        {
+            printf("device 0x%02X: %s\n", au8Dev[u8Idx], pstMode->pcName);
+            Test_vMode(pstMode, au8Dev[u8Idx]);
+        }
+    }
+    TEST_CHECK(I2C_SPEED_STANDARD == I2cXfer_enDevSpeed(0x7Fu));
+
+    return Test_iResult("test_i2c_timing");
+}
@@ -0,0 +1,424 @@
+/* Scheduler.c against a simulated SysTick and a test task table:
+ * event dispatch, period/phase/drift over long virtual time, CPU load accounting */
+#include "SysTick.h"
+#include "Scheduler.h"
+#include "Scheduler_Cfg.h"
+#include "TestUtil.h"
+
+#define TICK_MS      SCH_TIMEDURATION(1u)
+#define GAP_MAX      400u                         /* idle time between two passes, ticks */
+#define RUN_SECONDS  120u                         /* long run: about 450 SysTick wraps */
+#define GROUP_NUM    4u                           /* poll, 1ms, 10ms, 40ms */
+
+typedef enum
+{
+    TASK_POLL,
+    TASK_1MS,
+    TASK_10MS_A,
+    TASK_10MS_B,
+    TASK_10MS_C,
+    TASK_40MS,
+    TASK_NUM
+} TaskId_T;
+
+typedef struct
+{
+    uint32_t u32Period; /* group period from Sch_RunTaskTable, ticks */
+    uint32_t u32Due;    /* slot in the group, the last task closes the group */
+    uint32_t u32Cost;   /* virtual run time of one call, ticks */
+    uint64_t u64Calls;
+    uint64_t u64Last;   /* pass start of the last call */
+    uint64_t u64MinPeriod;
+    uint64_t u64MaxPeriod;
+} TaskStat_T;
+
+static TaskStat_T astTask[TASK_NUM] = {
+    {0u,                    0u,                    150u,   0u, 0u, 0u, 0u},
+    {SCH_TIMEDURATION(1u),  SCH_TIMEDURATION(1u),  12800u, 0u, 0u, 0u, 0u},
+    {SCH_TIMEDURATION(10u), SCH_TIMEDURATION(3u),  6400u,  0u, 0u, 0u, 0u},
+    {SCH_TIMEDURATION(10u), SCH_TIMEDURATION(7u),  6400u,  0u, 0u, 0u, 0u},
+    {SCH_TIMEDURATION(10u), SCH_TIMEDURATION(10u), 6400u,  0u, 0u, 0u, 0u},
+    {SCH_TIMEDURATION(40u), SCH_TIMEDURATION(40u), 64000u, 0u, 0u, 0u, 0u},
+};
+
+static uint64_t u64PassStart;
+static uint8_t  u8PassBusy;    /* a task of a nonzero period group or an event ran */
+static uint64_t u64BusyTicks;  /* reference busy time, see Sim_vPass */
+static uint32_t u32Seed = 1u;
+static uint32_t u32LockLeak;   /* passes that returned with interrupts disabled */
+
+/* Group start of the 10ms group: pass start of the last TASK_10MS_C call */
+static uint64_t u64GroupStart10;
+static uint64_t u64MinPhase[3];
+static uint64_t u64MaxPhase[3];
+
+static uint32_t u32EvtA;
+static uint32_t u32EvtB;
+static uint32_t u32EvtAAtB;    /* u32EvtA when EvtB last ran */
+static uint32_t u32EvtPriMask;
+static uint8_t  u8EvtRepost;
+static uint32_t u32EvtCost;
+
+static void Sim_vTask(TaskId_T Id)
+{
+    TaskStat_T *pTask = &astTask[Id];
+    uint64_t    u64Period;
+
+    if (pTask->u64Calls != 0u)
+    {
+        u64Period = u64PassStart - pTask->u64Last;
+        if ((pTask->u64MinPeriod == 0u) || (u64Period < pTask->u64MinPeriod))
+        {
+            pTask->u64MinPeriod = u64Period;
+        }
+        if (u64Period > pTask->u64MaxPeriod)
+        {
+            pTask->u64MaxPeriod = u64Period;
+        }
+    }
+    pTask->u64Calls += 1u;
+    pTask->u64Last = u64PassStart;
+    if (Id != TASK_POLL)
+    {
+        u8PassBusy = 1u;
+    }
+    Sim_vAdvance(pTask->u32Cost);
+}
+
+static void Sim_vPhase(uint8_t u8Idx)
+{
+    uint64_t u64Phase = u64PassStart - u64GroupStart10;
+
+    if ((u64MinPhase[u8Idx] == 0u) || (u64Phase < u64MinPhase[u8Idx]))
+    {
+        u64MinPhase[u8Idx] = u64Phase;
+    }
+    if (u64Phase > u64MaxPhase[u8Idx])
+    {
+        u64MaxPhase[u8Idx] = u64Phase;
+    }
+}
+
+static void TaskPoll(void)
+{
+    Sim_vTask(TASK_POLL);
+}
+
+static void Task1ms(void)
+{
+    Sim_vTask(TASK_1MS);
+}
+
+static void Task10msA(void)
+{
+    if (astTask[TASK_10MS_C].u64Calls != 0u)
+    {
+        Sim_vPhase(0u);
+    }
+    Sim_vTask(TASK_10MS_A);
+}
+
+static void Task10msB(void)
+{
+    if (astTask[TASK_10MS_C].u64Calls != 0u)
+    {
+        Sim_vPhase(1u);
+    }
+    Sim_vTask(TASK_10MS_B);
+}
+
+static void Task10msC(void)
+{
+    if (astTask[TASK_10MS_C].u64Calls != 0u)
+    {
+        Sim_vPhase(2u);
+    }
+    u64GroupStart10 = u64PassStart;
+    Sim_vTask(TASK_10MS_C);
+}
+
+static void Task40ms(void)
+{
+    Sim_vTask(TASK_40MS);
+}
+
+static void EvtA(void)
+{
+    u32EvtA += 1u;
+    u32EvtPriMask = Sim_u32PriMask;
+    u8PassBusy    = 1u;
+    if (u8EvtRepost != 0u)
+    {
+        u8EvtRepost = 0u;
+        Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    }
+    Sim_vAdvance(u32EvtCost);
+}
+
+static void EvtB(void)
+{
+    u32EvtAAtB = u32EvtA;
+    u32EvtB += 1u;
+    u8PassBusy = 1u;
+}
+
+const Sch_Task_Info_T Sch_RunTaskTable[] =
+    {
+        {&TaskPoll,      SCH_MS(0u),  SCH_TIMEDURATION(0u) },
+        {SCH_EndOfList,  SCH_MS(1u),  SCH_TIMEDURATION(0u) },
+        {&Task1ms,       SCH_MS(0u),  SCH_TIMEDURATION(1u) },
+        {SCH_EndOfList,  SCH_MS(1u),  SCH_TIMEDURATION(1u) },
+        {&Task10msA,     SCH_MS(0u),  SCH_TIMEDURATION(3u) },
+        {&Task10msB,     SCH_MS(3u),  SCH_TIMEDURATION(7u) },
+        {&Task10msC,     SCH_MS(7u),  SCH_TIMEDURATION(10u)},
+        {SCH_EndOfList,  SCH_MS(10u), SCH_TIMEDURATION(10u)},
+        {&Task40ms,      SCH_MS(0u),  SCH_TIMEDURATION(40u)},
+        {SCH_EndOfList,  SCH_MS(40u), SCH_TIMEDURATION(40u)},
+        {SCH_EndOfList,  SCH_MS(0u),  SCH_TIMEDURATION(0u) }
+};
+
+const Sch_Task_T Sch_EventTable[SCH_EVENT_MAX_NUM] =
+    {
+        &EvtA,         /* SCH_EVENT_TOUCH_INT */
+        &EvtB,         /* SCH_EVENT_CAN_RX */
+        SCH_EndOfList, /* SCH_EVENT_I2C_DONE: unbound */
+};
+
+/* One pass followed by a pseudo random idle gap, 0 included (equal time stamps) */
+static void Sim_vPass(void)
+{
+    u64PassStart = Sim_u64Now();
+    u8PassBusy   = 0u;
+    Sch_RunOnce();
+    if (u8PassBusy != 0u)
+    {
+        u64BusyTicks += Sim_u64Now() - u64PassStart;
+    }
+    if (Sim_u32PriMask != 0u)
+    {
+        u32LockLeak += 1u;
+    }
+    u32Seed = (u32Seed * 1103515245u) + 12345u;
+    Sim_vAdvance((u32Seed >> 16) % (GAP_MAX + 1u));
+}
+
+static void Sim_vRunFor(uint64_t u64Ticks)
+{
+    uint64_t u64End = Sim_u64Now() + u64Ticks;
+
+    while (Sim_u64Now() < u64End)
+    {
+        Sim_vPass();
+    }
+}
+
+static void Test_vEvents(void)
+{
+    uint32_t u32Mask;
+
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    TEST_CHECK(u32EvtA == 0u);
+    TEST_CHECK(Sim_u32PriMask == 0u);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 1u);
+    TEST_CHECK(u32EvtPriMask == 0u); /* handlers run with interrupts enabled */
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 1u);
+
+    /* Posts before the next pass coalesce */
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 2u);
+
+    /* Several events in one pass, in SCH_EVENT_xxx order */
+    Sch_PostEvent(SCH_EVENT_CAN_RX);
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 3u);
+    TEST_CHECK(u32EvtB == 1u);
+    TEST_CHECK(u32EvtAAtB == 3u);
+
+    /* Unbound and out of range events are dropped */
+    Sch_PostEvent(SCH_EVENT_I2C_DONE);
+    Sch_PostEvent(SCH_EVENT_MAX_NUM);
+    Sch_PostEvent(31u);
+    Sim_vPass();
+    TEST_CHECK((u32EvtA == 3u) && (u32EvtB == 1u));
+
+    /* Posting from an ISR with interrupts already disabled keeps them disabled */
+    IRQLOCK_SAVE(u32Mask);
+    Sch_PostEvent(SCH_EVENT_CAN_RX);
+    TEST_CHECK(Sim_u32PriMask == 1u);
+    IRQLOCK_RESTORE(u32Mask);
+    Sim_vPass();
+    TEST_CHECK(u32EvtB == 2u);
+
+    /* A post from inside a handler runs on the following pass */
+    u8EvtRepost = 1u;
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 4u);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 5u);
+    Sim_vPass();
+    TEST_CHECK(u32EvtA == 5u);
+}
+
+static void Test_vTiming(void)
+{
+    uint64_t          u64Start = Sim_u64Now();
+    uint64_t          u64Span;
+    uint32_t          u32PassMax;
+    uint8_t           u8Idx;
+    uint8_t           u8Group;
+    Sch_Timing_Info_T stInfo;
+    static const TaskId_T aenLast[GROUP_NUM] = {TASK_POLL, TASK_1MS, TASK_10MS_C, TASK_40MS};
+
+    for (u8Idx = 0u; u8Idx < TASK_NUM; u8Idx++)
+    {
+        astTask[u8Idx].u64Calls     = 0u;
+        astTask[u8Idx].u64MinPeriod = 0u;
+        astTask[u8Idx].u64MaxPeriod = 0u;
+    }
+    Sim_vRunFor((uint64_t)RUN_SECONDS * 1000u * TICK_MS);
+    u64Span = Sim_u64Now() - u64Start;
+
+    /* A due task runs on the first pass at or after its slot, so every period
+     * is the nominal one plus at most one pass: gap plus all task costs */
+    u32PassMax = GAP_MAX;
+    for (u8Idx = 0u; u8Idx < TASK_NUM; u8Idx++)
+    {
+        u32PassMax += astTask[u8Idx].u32Cost;
+    }
+
+    for (u8Idx = TASK_1MS; u8Idx < TASK_NUM; u8Idx++)
+    {
+        uint32_t u32Nominal = astTask[u8Idx].u32Period;
+        uint64_t u64MeanLate;
+
+        if (astTask[u8Idx].u32Due == u32Nominal)
+        {
+            /* The task closing the group: nominal period plus this pass' lateness */
+            TEST_CHECK_RANGE(astTask[u8Idx].u64MinPeriod, u32Nominal, u32Nominal + u32PassMax);
+            TEST_CHECK_RANGE(astTask[u8Idx].u64MaxPeriod, u32Nominal, u32Nominal + u32PassMax);
+        }
+        else
+        {
+            /* Earlier slots also carry the lateness of their own slot in both periods */
+            TEST_CHECK_RANGE(astTask[u8Idx].u64MinPeriod, u32Nominal - u32PassMax, u32Nominal + (2u * u32PassMax));
+            TEST_CHECK_RANGE(astTask[u8Idx].u64MaxPeriod, u32Nominal - u32PassMax, u32Nominal + (2u * u32PassMax));
+        }
+        /* Drift: the group restarts from the pass that closed it, lateness is not carried
+         * over, so the mean period stays within one pass of the nominal one */
+        u64MeanLate = (u64Span / astTask[u8Idx].u64Calls) - u32Nominal;
+        TEST_CHECK(u64Span / astTask[u8Idx].u64Calls >= u32Nominal);
+        TEST_CHECK(u64MeanLate <= u32PassMax);
+    }
+
+    /* Phase of the 10ms group tasks against their slot */
+    for (u8Idx = 0u; u8Idx < 3u; u8Idx++)
+    {
+        TEST_CHECK_RANGE(u64MinPhase[u8Idx], astTask[TASK_10MS_A + u8Idx].u32Due,
+                         astTask[TASK_10MS_A + u8Idx].u32Due + u32PassMax);
+        TEST_CHECK_RANGE(u64MaxPhase[u8Idx], astTask[TASK_10MS_A + u8Idx].u32Due,
+                         astTask[TASK_10MS_A + u8Idx].u32Due + u32PassMax);
+    }
+
+    /* SCH_TIMING_MONITOR must agree with the measurement of the last task of each group */
+    for (u8Group = 1u; u8Group < GROUP_NUM; u8Group++)
+    {
+        TaskStat_T *pTask = &astTask[aenLast[u8Group]];
+
+        Sch_GetTimingInfo(u8Group, &stInfo);
+        TEST_CHECK(stInfo.u32Nominal == pTask->u32Period);
+        TEST_CHECK(stInfo.u32MinPeriod == pTask->u64MinPeriod);
+        TEST_CHECK(stInfo.u32MaxPeriod == pTask->u64MaxPeriod);
+        TEST_CHECK(stInfo.u32MaxLate <= u32PassMax);
+        TEST_CHECK(stInfo.s32Drift >= 0);
+    }
+    Sch_GetTimingInfo(2u, &stInfo);
+    printf("10ms group: %u cycles, period %u..%u ticks, drift %d ticks over %u s\n", (unsigned)stInfo.u32Cycles,
+           (unsigned)stInfo.u32MinPeriod, (unsigned)stInfo.u32MaxPeriod, (int)stInfo.s32Drift, RUN_SECONDS);
+}
+
+static void Test_vLoad(void)
+{
+    Sch_Load_Info_T stLoad;
+    uint64_t        u64Start;
+    uint64_t        u64Busy;
+    uint32_t        u32Expect;
+    uint8_t         u8Idx;
+
+    /* Busy passes are the ones running a nonzero period task or an event, the poll task alone is idle */
+    Sim_vRunFor(1200u * TICK_MS);
+    u64Start = Sim_u64Now();
+    u64Busy  = u64BusyTicks;
+    Sim_vRunFor(5000u * TICK_MS);
+    u32Expect = (uint32_t)(((u64BusyTicks - u64Busy) * 100u) / (Sim_u64Now() - u64Start));
+    Sch_GetCpuLoad(&stLoad);
+    printf("load %u%%, expected %u%%\n", stLoad.u8CurLoad, (unsigned)u32Expect);
+    TEST_CHECK_RANGE(stLoad.u8CurLoad, u32Expect - 1u, u32Expect + 1u);
+    TEST_CHECK(stLoad.u8Alarm == 0u);
+
+    /* Only the always-run poll task costs time (about 40% of the loop): load reads 0 */
+    for (u8Idx = TASK_1MS; u8Idx < TASK_NUM; u8Idx++)
+    {
+        astTask[u8Idx].u32Cost = 0u;
+    }
+    Sim_vRunFor(2100u * TICK_MS);
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK(stLoad.u8CurLoad <= 1u);
+
+    /* Events are load, two windows in a row above SCH_LOAD_ALARM_PCT do not raise the alarm */
+    u32EvtCost = 32000u;
+    u64Start   = Sim_u64Now();
+    while (Sim_u64Now() < (u64Start + (2100u * TICK_MS)))
+    {
+        Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+        Sim_vPass();
+    }
+    u32EvtCost = 0u;
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK(stLoad.u8CurLoad >= 90u);
+    TEST_CHECK(stLoad.u8Alarm == 0u);
+
+    /* High load alarm: SCH_LOAD_ALARM_WINDOWS windows in a row */
+    Sch_ClearCpuLoadPeak();
+    Sim_vRunFor(2100u * TICK_MS);
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK(stLoad.u8CurLoad <= 1u);
+    TEST_CHECK(stLoad.u8PeakLoad >= 90u);
+    astTask[TASK_1MS].u32Cost = 57600u;
+    u64Start                  = Sim_u64Now();
+    do
+    {
+        Sim_vPass();
+        Sch_GetCpuLoad(&stLoad);
+    } while (stLoad.u8Alarm == 0u);
+    TEST_CHECK_RANGE(Sim_u64Now() - u64Start, (SCH_LOAD_ALARM_WINDOWS - 1u) * SCH_LOAD_WINDOW,
+                     ((SCH_LOAD_ALARM_WINDOWS + 1u) * SCH_LOAD_WINDOW) + (10u * TICK_MS));
+    TEST_CHECK(stLoad.u8CurLoad >= SCH_LOAD_ALARM_PCT);
+
+    /* Cleared once a window drops below SCH_LOAD_ALARM_PCT - SCH_LOAD_ALARM_HYST */
+    astTask[TASK_1MS].u32Cost = 0u;
+    Sim_vRunFor(2100u * TICK_MS);
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK(stLoad.u8Alarm == 0u);
+    Sch_ClearCpuLoadPeak();
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK(stLoad.u8PeakLoad == stLoad.u8CurLoad);
+}
+
+int main(void)
+{
+    SysTickInit();
+    Sch_TableInit(Sch_RunTaskTable);
+
+    Test_vEvents();
+    Test_vTiming();
+    Test_vLoad();
+    TEST_CHECK(u32LockLeak == 0u);
+
+    return Test_iResult("test_sched");
+}
@@ -0,0 +1,118 @@
+/* Scheduler.c with the product Sch_RunTaskTable/Sch_EventTable of Scheduler_Cfg.c:
+ * every group keeps its period over long virtual time and an idle loop reads no load */
+#include "SysTick.h"
+#include "Scheduler.h"
+#include "Scheduler_Cfg.h"
+#include "TestUtil.h"
+
+#define TICK_MS     SCH_TIMEDURATION(1u)
+#define GAP_MAX     400u   /* idle time between two passes, ticks */
+#define RUN_SECONDS 300u
+#define TASK5_COST  3200u  /* Lx07_vTask5ms: 50us every 5ms, 1% */
+
+static uint64_t u64PassStart;
+static uint32_t u32Seed = 7u;
+
+static uint64_t u64Task5Calls;
+static uint64_t u64Task5Last;
+static uint64_t u64Task5Min;
+static uint64_t u64Task5Max;
+static uint32_t u32TouchEvt;
+static uint32_t u32Kick;
+
+/* Modules bound in Scheduler_Cfg.c */
+void Lx07_vTask5ms(void)
+{
+    uint64_t u64Period = u64PassStart - u64Task5Last;
+
+    if (u64Task5Calls != 0u)
+    {
+        if ((u64Task5Min == 0u) || (u64Period < u64Task5Min))
+        {
+            u64Task5Min = u64Period;
+        }
+        if (u64Period > u64Task5Max)
+        {
+            u64Task5Max = u64Period;
+        }
+    }
+    u64Task5Calls += 1u;
+    u64Task5Last = u64PassStart;
+    Sim_vAdvance(TASK5_COST);
+}
+
+void Touch_vTpIntEvent(void)
+{
+    u32TouchEvt += 1u;
+}
+
+void ProductLine_vKick(void)
+{
+    u32Kick += 1u;
+}
+
+static void Sim_vPass(void)
+{
+    u64PassStart = Sim_u64Now();
+    Sch_RunOnce();
+    u32Seed = (u32Seed * 1103515245u) + 12345u;
+    Sim_vAdvance((u32Seed >> 16) % (GAP_MAX + 1u));
+}
+
+int main(void)
+{
+    uint64_t          u64End;
+    uint64_t          u64Span;
+    uint8_t           u8Group;
+    uint32_t          u32Nominal;
+    Sch_Timing_Info_T stInfo;
+    Sch_Load_Info_T   stLoad;
+    /* Group order of Sch_RunTaskTable: always-run, 1ms, 5ms, 10ms, 40ms */
+    static const uint32_t au32Period[] = {SCH_TIMEDURATION(0u), SCH_TIMEDURATION(1u), SCH_TIMEDURATION(5u),
+                                          SCH_TIMEDURATION(10u), SCH_TIMEDURATION(40u)};
+
+    SysTickInit();
+    Sch_TableInit(Sch_RunTaskTable);
+
+    Sch_PostEvent(SCH_EVENT_TOUCH_INT);
+    Sch_PostEvent(SCH_EVENT_CAN_RX);
+    Sch_PostEvent(SCH_EVENT_I2C_DONE);
+    Sim_vPass();
+    TEST_CHECK(u32TouchEvt == 1u);
+    TEST_CHECK(u32Kick == 2u);
+
+    u64End = (uint64_t)RUN_SECONDS * 1000u * TICK_MS;
+    while (Sim_u64Now() < u64End)
+    {
+        Sim_vPass();
+    }
+    u64Span = Sim_u64Now();
+
+    /* Periodic groups: every period within one pass of Sch_RunTaskTable */
+    for (u8Group = 1u; u8Group < (sizeof(au32Period) / sizeof(au32Period[0])); u8Group++)
+    {
+        u32Nominal = au32Period[u8Group];
+        Sch_GetTimingInfo(u8Group, &stInfo);
+        TEST_CHECK(stInfo.u32Nominal == u32Nominal);
+        TEST_CHECK_RANGE(stInfo.u32MinPeriod, u32Nominal, u32Nominal + GAP_MAX + TASK5_COST);
+        TEST_CHECK_RANGE(stInfo.u32MaxPeriod, u32Nominal, u32Nominal + GAP_MAX + TASK5_COST);
+        TEST_CHECK_RANGE(stInfo.u32MaxLate, 0u, GAP_MAX + TASK5_COST);
+        TEST_CHECK_RANGE(stInfo.u32Cycles, u64Span / (u32Nominal + GAP_MAX + TASK5_COST), u64Span / u32Nominal);
+        /* Mean drift per period below one pass */
+        TEST_CHECK_RANGE(stInfo.s32Drift / (int32_t)stInfo.u32Cycles, 0, GAP_MAX + TASK5_COST);
+    }
+    TEST_CHECK_RANGE(u64Task5Min, SCH_TIMEDURATION(5u), SCH_TIMEDURATION(5u) + GAP_MAX + TASK5_COST);
+    TEST_CHECK_RANGE(u64Task5Max, SCH_TIMEDURATION(5u), SCH_TIMEDURATION(5u) + GAP_MAX + TASK5_COST);
+
+    /* The always-run group does not count as load, Lx07_vTask5ms is the only cost */
+    Sch_GetCpuLoad(&stLoad);
+    TEST_CHECK_RANGE(stLoad.u8CurLoad, 0u, 2u);
+    TEST_CHECK_RANGE(stLoad.u8PeakLoad, 0u, 2u);
+    TEST_CHECK(stLoad.u8Alarm == 0u);
+
+    Sch_GetTimingInfo(2u, &stInfo);
+    printf("5ms group: %u cycles in %u s, period %u..%u ticks, load %u%%\n", (unsigned)stInfo.u32Cycles, RUN_SECONDS,
+           (unsigned)stInfo.u32MinPeriod, (unsigned)stInfo.u32MaxPeriod, stLoad.u8CurLoad);
+
+    return Test_iResult("test_sched_cfg");
+}